@@ -0,0 +1,20 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Buffer.h"
+
+#include <vector>
+
+namespace carla {
+
+  /// A sequence of buffers sent as a single message, the receiver gets them
+  /// concatenated in a single Buffer. Allows serializers to send each part of
+  /// their data from its own buffer instead of copying everything together.
+  using BufferList = std::vector<Buffer>;
+
+} // namespace carla
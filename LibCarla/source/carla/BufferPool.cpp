@@ -0,0 +1,155 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/BufferPool.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace carla {
+
+  constexpr size_t BufferPool::min_class_bits;
+  constexpr size_t BufferPool::number_of_classes;
+
+  static size_t FloorLog2(size_t value) {
+    size_t result = 0u;
+    while (value >>= 1u) {
+      ++result;
+    }
+    return result;
+  }
+
+  Buffer BufferPool::Pop(const size_t size_hint) {
+    const auto now = Now();
+    TrimIfNeeded(now);
+    const size_t index = size_hint > 0u ? GetClassOfSize(size_hint) : _last_class.load();
+    Buffer item;
+    // A buffer of the next class is at most four times bigger than needed.
+    if (TryPop(index, item) || ((index + 1u < number_of_classes) && TryPop(index + 1u, item))) {
+      ++_hits;
+    } else {
+      ++_allocations;
+    }
+#if __cplusplus >= 201703L // C++17
+    item._parent_pool = weak_from_this();
+#else
+    item._parent_pool = shared_from_this();
+#endif
+    return item;
+  }
+
+  void BufferPool::SetSettings(const Settings &settings) {
+    _max_bytes_held = settings.max_bytes_held;
+    _idle_timeout = Nanoseconds(settings.idle_timeout);
+  }
+
+  BufferPool::Settings BufferPool::GetSettings() const {
+    Settings settings;
+    settings.max_bytes_held = _max_bytes_held;
+    settings.idle_timeout = std::chrono::milliseconds(_idle_timeout / 1000000);
+    return settings;
+  }
+
+  BufferPool::Stats BufferPool::GetStats() const {
+    Stats stats;
+    stats.bytes_held = _bytes_held;
+    stats.buffers_held = _buffers_held;
+    stats.hits = _hits;
+    stats.allocations = _allocations;
+    stats.buffers_released = _buffers_released;
+    stats.bytes_released = _bytes_released;
+    return stats;
+  }
+
+  void BufferPool::Clear() {
+    for (size_t i = 0u; i < number_of_classes; ++i) {
+      Buffer buffer;
+      while (TryPop(i, buffer)) {
+        Release(buffer.capacity());
+        buffer.clear();
+      }
+    }
+  }
+
+  size_t BufferPool::GetClassOfCapacity(const size_t capacity) {
+    const size_t bits = FloorLog2(capacity);
+    return bits <= min_class_bits ? 0u : std::min(bits - min_class_bits, number_of_classes - 1u);
+  }
+
+  size_t BufferPool::GetClassOfSize(const size_t size) {
+    // Smallest class whose buffers are all big enough.
+    const size_t bits = FloorLog2(size) + ((size & (size - 1u)) != 0u ? 1u : 0u);
+    return bits <= min_class_bits ? 0u : std::min(bits - min_class_bits, number_of_classes - 1u);
+  }
+
+  void BufferPool::Push(Buffer &&buffer) {
+    const size_t capacity = buffer.capacity();
+    const auto now = Now();
+    const uint64_t max_bytes = _max_bytes_held;
+    const uint64_t held = _bytes_held.fetch_add(capacity) + capacity;
+    if ((max_bytes > 0u) && (held > max_bytes)) {
+      // Over the high-water mark, let the memory go.
+      _bytes_held -= capacity;
+      ++_buffers_released;
+      _bytes_released += capacity;
+      buffer.clear();
+    } else {
+      const size_t index = GetClassOfCapacity(capacity);
+      auto &size_class = _classes[index];
+      size_class.last_used = now;
+      ++_buffers_held;
+      buffer._parent_pool.reset();
+      size_class.queue.enqueue(std::move(buffer));
+      _last_class = index;
+    }
+    TrimIfNeeded(now);
+  }
+
+  bool BufferPool::TryPop(const size_t index, Buffer &buffer) {
+    DEBUG_ASSERT(index < number_of_classes);
+    auto &size_class = _classes[index];
+    if (!size_class.queue.try_dequeue(buffer)) {
+      return false;
+    }
+    size_class.last_used = Now();
+    --_buffers_held;
+    _bytes_held -= buffer.capacity();
+    return true;
+  }
+
+  void BufferPool::Release(const size_t capacity) {
+    ++_buffers_released;
+    _bytes_released += capacity;
+  }
+
+  void BufferPool::TrimIfNeeded(const int64_t now) {
+    const int64_t idle_timeout = _idle_timeout;
+    int64_t last_trim = _last_trim;
+    if ((idle_timeout <= 0) ||
+        (now - last_trim < idle_timeout) ||
+        !_last_trim.compare_exchange_strong(last_trim, now)) {
+      return;
+    }
+    for (size_t i = 0u; i < number_of_classes; ++i) {
+      auto &size_class = _classes[i];
+      if ((now - size_class.last_used.load() < idle_timeout) ||
+          (size_class.queue.size_approx() == 0u)) {
+        continue;
+      }
+      Buffer buffer;
+      while (TryPop(i, buffer)) {
+        Release(buffer.capacity());
+        buffer.clear();
+      }
+    }
+  }
+
+  int64_t BufferPool::Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+} // namespace carla
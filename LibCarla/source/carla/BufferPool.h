@@ -7,6 +7,7 @@
 #pragma once
 
 #include "carla/Buffer.h"
+#include "carla/Time.h"
 
 #if defined(__clang__)
 #  pragma clang diagnostic push
@@ -17,6 +18,9 @@
 #  pragma clang diagnostic pop
 #endif
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 
 namespace carla {
@@ -24,37 +28,137 @@ namespace carla {
   /// A pool of Buffer. Buffers popped from this pool automatically return to
   /// the pool on destruction so the allocated memory can be reused.
   ///
-  /// @warning Buffers adjust their size only by growing, they never shrink
-  /// unless explicitly cleared. The allocated memory is only deleted when this
-  /// pool is destroyed.
+  /// Buffers are kept in size classes by capacity (powers of two), so a
+  /// request is served with a buffer of similar size. The memory held by the
+  /// pool is bounded by Settings::max_bytes_held, buffers returned beyond that
+  /// limit are deleted, and size classes not used for Settings::idle_timeout
+  /// are trimmed.
   class BufferPool : public std::enable_shared_from_this<BufferPool> {
   public:
 
+    struct Settings {
+      /// Maximum capacity in bytes of the buffers kept in the pool, zero for
+      /// no limit.
+      uint64_t max_bytes_held = 512u << 20;
+
+      /// Buffers of a size class unused for this long are deleted, zero to
+      /// never trim.
+      time_duration idle_timeout = time_duration::seconds(30u);
+    };
+
+    struct Stats {
+      /// Capacity in bytes of the buffers waiting in the pool.
+      uint64_t bytes_held = 0u;
+
+      uint64_t buffers_held = 0u;
+
+      /// Pops served with a buffer from the pool.
+      uint64_t hits = 0u;
+
+      /// Pops that had to return a new buffer, which allocates its memory
+      /// when first used.
+      uint64_t allocations = 0u;
+
+      /// Buffers deleted because of the high-water limit or idle trimming.
+      uint64_t buffers_released = 0u;
+
+      uint64_t bytes_released = 0u;
+
+      double GetHitRate() const {
+        const auto total = hits + allocations;
+        return total > 0u ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+      }
+
+      Stats &operator+=(const Stats &rhs) {
+        bytes_held += rhs.bytes_held;
+        buffers_held += rhs.buffers_held;
+        hits += rhs.hits;
+        allocations += rhs.allocations;
+        buffers_released += rhs.buffers_released;
+        bytes_released += rhs.bytes_released;
+        return *this;
+      }
+    };
+
     BufferPool() = default;
 
-    explicit BufferPool(size_t estimated_size) : _queue(estimated_size) {}
+    /// @a estimated_size is kept for compatibility, queues grow on demand.
+    explicit BufferPool(size_t /* estimated_size */) {}
 
-    /// Pop a Buffer from the queue, creates a new one if the queue is empty.
-    Buffer Pop() {
-      Buffer item;
-      _queue.try_dequeue(item); // we don't care if it fails.
-#if __cplusplus >= 201703L // C++17
-      item._parent_pool = weak_from_this();
-#else
-      item._parent_pool = shared_from_this();
-#endif
-      return item;
+    explicit BufferPool(const Settings &settings) {
+      SetSettings(settings);
     }
 
+    /// Pop a Buffer from the pool, returns an empty one if there is none
+    /// available. If @a size_hint is given, the buffer comes from the size
+    /// class fitting that many bytes, otherwise from the size class of the
+    /// last buffer returned to the pool.
+    Buffer Pop(size_t size_hint = 0u);
+
+    void SetSettings(const Settings &settings);
+
+    Settings GetSettings() const;
+
+    Stats GetStats() const;
+
+    /// Delete every buffer held by the pool.
+    void Clear();
+
   private:
 
     friend class Buffer;
 
-    void Push(Buffer &&buffer) {
-      _queue.enqueue(std::move(buffer));
+    /// Class 0 holds capacities under 2^(min_class_bits + 1), class i holds
+    /// capacities in [2^(min_class_bits + i), 2^(min_class_bits + i + 1)).
+    static constexpr size_t min_class_bits = 12u;
+
+    static constexpr size_t number_of_classes = 32u - min_class_bits;
+
+    static size_t GetClassOfCapacity(size_t capacity);
+
+    static size_t GetClassOfSize(size_t size);
+
+    struct SizeClass {
+      moodycamel::ConcurrentQueue<Buffer> queue{0u};
+
+      std::atomic<int64_t> last_used{0};
+    };
+
+    void Push(Buffer &&buffer);
+
+    bool TryPop(size_t index, Buffer &buffer);
+
+    void Release(size_t capacity);
+
+    void TrimIfNeeded(int64_t now);
+
+    static int64_t Now();
+
+    static int64_t Nanoseconds(time_duration duration) {
+      return static_cast<int64_t>(duration.milliseconds()) * 1000000;
     }
 
-    moodycamel::ConcurrentQueue<Buffer> _queue;
+    std::atomic<uint64_t> _max_bytes_held{Settings{}.max_bytes_held};
+
+    std::atomic<int64_t> _idle_timeout{Nanoseconds(Settings{}.idle_timeout)};
+
+    std::array<SizeClass, number_of_classes> _classes;
+
+    std::atomic_size_t _last_class{0u};
+
+    std::atomic<int64_t> _last_trim{0};
+
+    std::atomic<uint64_t> _bytes_held{0u};
+
+    std::atomic<uint64_t> _buffers_held{0u};
+
+    std::atomic<uint64_t> _hits{0u};
+
+    std::atomic<uint64_t> _allocations{0u};
+
+    std::atomic<uint64_t> _buffers_released{0u};
+
+    std::atomic<uint64_t> _bytes_released{0u};
   };
 
 } // namespace carla
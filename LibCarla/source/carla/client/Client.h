@@ -54,6 +54,16 @@ namespace client {
       return _simulator->GetAvailableMaps();
     }
 
+    /// Memory held and reuse of the buffer pools of the streaming server.
+    rpc::BufferPoolStats GetBufferPoolStats() const {
+      return _simulator->GetBufferPoolStats();
+    }
+
+    /// Queued messages, drops and send latency of the stream of @a sensor.
+    rpc::StreamStats GetStreamStats(rpc::ActorId sensor) const {
+      return _simulator->GetStreamStats(sensor);
+    }
+
     bool SetFilesBaseFolder(const std::string &path) {
       return _simulator->SetFilesBaseFolder(path);
     }
@@ -31,6 +31,15 @@ namespace client {
     return _filesBaseFolder;
   }
 
+  std::string FileTransfer::GetFilePath(const std::string &path) {
+    std::string fullpath = _filesBaseFolder;
+    fullpath += "/";
+    fullpath += ::carla::version();
+    fullpath += "/";
+    fullpath += path;
+    return fullpath;
+  }
+
   bool FileTransfer::FileExists(std::string file) {
     // Check if the file exists or not
     struct stat buffer;
@@ -26,6 +26,9 @@ namespace client {
 
     static const std::string& GetFilesBaseFolder();
 
+    /// Full path of a file of the cache, in the folder of this version.
+    static std::string GetFilePath(const std::string &path);
+
     static bool FileExists(std::string file);
 
     static bool WriteFile(std::string path, std::vector<uint8_t> content);
@@ -257,6 +257,10 @@ namespace client {
     return _episode.Lock()->CastRay(start_location, end_location);
   }
 
+  std::vector<rpc::RayCastHit> World::CastRays(const rpc::RayCastBatch &rays) const {
+    return _episode.Lock()->CastRays(rays);
+  }
+
   std::vector<SharedPtr<Actor>> World::GetTrafficLightsFromWaypoint(
       const Waypoint& waypoint, double distance) const {
     std::vector<SharedPtr<Actor>> Result;
@@ -23,6 +23,7 @@
 #include "carla/rpc/EnvironmentObject.h"
 #include "carla/rpc/LabelledPoint.h"
 #include "carla/rpc/MapLayer.h"
+#include "carla/rpc/RayCastBatch.h"
 #include "carla/rpc/VehiclePhysicsControl.h"
 #include "carla/rpc/WeatherParameters.h"
 #include "carla/rpc/VehicleLightStateList.h"
@@ -186,6 +187,10 @@ namespace client {
     std::vector<rpc::LabelledPoint> CastRay(
         geom::Location start_location, geom::Location end_location) const;
 
+    /// Cast every ray of @a rays in a single call, returns the closest hit of
+    /// each ray in the same order.
+    std::vector<rpc::RayCastHit> CastRays(const rpc::RayCastBatch &rays) const;
+
     std::vector<SharedPtr<Actor>> GetTrafficLightsFromWaypoint(
         const Waypoint& waypoint, double distance) const;
 
@@ -144,6 +144,14 @@ namespace detail {
     return _pimpl->CallAndWait<std::string>("version");
   }
 
+  rpc::BufferPoolStats Client::GetBufferPoolStats() {
+    return _pimpl->CallAndWait<rpc::BufferPoolStats>("get_buffer_pool_stats");
+  }
+
+  rpc::StreamStats Client::GetStreamStats(rpc::ActorId sensor) {
+    return _pimpl->CallAndWait<rpc::StreamStats>("get_stream_stats", sensor);
+  }
+
   void Client::LoadEpisode(std::string map_name, bool reset_settings, rpc::MapLayer map_layer) {
     // Await response, we need to be sure in this one.
     _pimpl->CallAndWait<void>("load_new_episode", std::move(map_name), reset_settings, map_layer);
@@ -667,6 +675,11 @@ namespace detail {
     return _pimpl->CallAndWait<return_t>("cast_ray", start_location, end_location);
   }
 
+  std::vector<rpc::RayCastHit> Client::CastRays(const rpc::RayCastBatch &rays) const {
+    using return_t = std::vector<uint8_t>;
+    return rpc::RayCastHit::Unpack(_pimpl->CallAndWait<return_t>("cast_rays", rays));
+  }
+
 } // namespace detail
 } // namespace client
 } // namespace carla
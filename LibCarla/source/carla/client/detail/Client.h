@@ -14,6 +14,7 @@
 #include "carla/rpc/Actor.h"
 #include "carla/rpc/ActorDefinition.h"
 #include "carla/rpc/AttachmentType.h"
+#include "carla/rpc/BufferPoolStats.h"
 #include "carla/rpc/Command.h"
 #include "carla/rpc/CommandResponse.h"
 #include "carla/rpc/EnvironmentObject.h"
@@ -24,6 +25,8 @@
 #include "carla/rpc/MapInfo.h"
 #include "carla/rpc/MapLayer.h"
 #include "carla/rpc/OpendriveGenerationParameters.h"
+#include "carla/rpc/RayCastBatch.h"
+#include "carla/rpc/StreamStats.h"
 #include "carla/rpc/TrafficLightState.h"
 #include "carla/rpc/VehicleDoor.h"
 #include "carla/rpc/VehicleLightStateList.h"
@@ -98,6 +101,10 @@ namespace detail {
 
     std::string GetServerVersion();
 
+    rpc::BufferPoolStats GetBufferPoolStats();
+
+    rpc::StreamStats GetStreamStats(rpc::ActorId sensor);
+
     void LoadEpisode(std::string map_name, bool reset_settings = true, rpc::MapLayer map_layer = rpc::MapLayer::All);
 
     void LoadLevelLayer(rpc::MapLayer map_layer) const;
@@ -414,6 +421,8 @@ namespace detail {
     std::vector<rpc::LabelledPoint> CastRay(
         geom::Location start_location, geom::Location end_location) const;
 
+    std::vector<rpc::RayCastHit> CastRays(const rpc::RayCastBatch &rays) const;
+
   private:
 
     class Pimpl;
@@ -169,6 +169,14 @@ namespace detail {
       return _client.GetServerVersion();
     }
 
+    rpc::BufferPoolStats GetBufferPoolStats() {
+      return _client.GetBufferPoolStats();
+    }
+
+    rpc::StreamStats GetStreamStats(ActorId sensor) {
+      return _client.GetStreamStats(sensor);
+    }
+
     /// @}
     // =========================================================================
     /// @name Tick
@@ -278,6 +286,10 @@ namespace detail {
       return _client.CastRay(start_location, end_location);
     }
 
+    std::vector<rpc::RayCastHit> CastRays(const rpc::RayCastBatch &rays) const {
+      return _client.CastRays(rays);
+    }
+
     /// @}
     // =========================================================================
     /// @name AI
@@ -15,7 +15,9 @@ enum MultiGPUCommand : uint32_t {
   SEND_FRAME = 0,
   LOAD_MAP,
   GET_TOKEN,
-  YOU_ALIVE
+  YOU_ALIVE,
+  SEND_FRAME_DELTA,
+  FRAME_ACK
 };
 
 struct CommandHeader {
@@ -23,5 +25,25 @@ struct CommandHeader {
   uint32_t size;
 };
 
+/// Version of the frames sent with SEND_FRAME_DELTA, the secondary servers
+/// drop the frames of any other version.
+constexpr uint32_t FRAME_PROTOCOL_VERSION = 1u;
+
+/// The frame contains all the actors, not only the ones that changed.
+constexpr uint32_t FRAME_FLAG_KEYFRAME = 1u << 0;
+
+/// Header of the frames sent with SEND_FRAME_DELTA, followed by the frame data.
+struct FrameHeader {
+  uint32_t version;
+  uint32_t flags;
+  uint64_t frame;
+};
+
+/// Sent back by the secondary servers with FRAME_ACK once a frame is rendered.
+struct FrameAck {
+  CommandHeader header;
+  uint64_t frame;
+};
+
 } // namespace multigpu
 } // namespace carla
@@ -133,10 +133,11 @@ namespace multigpu {
         if (!ec) {
           DEBUG_ASSERT_EQ(bytes, message->size());
           DEBUG_ASSERT_NE(bytes, 0u);
+          ++self->_messages_received;
+          self->_bytes_received += message->size();
           // Move the buffer to the callback function and start reading the next
           // piece of data.
           self->_on_response(self, message->pop());
-          std::cout << "Getting data on listener\n";
           self->ReadData();
         } else {
           // As usual, if anything fails start over from the very top.
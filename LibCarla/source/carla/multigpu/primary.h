@@ -19,6 +19,7 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/strand.hpp>
 
+#include <atomic>
 #include <functional>
 #include <memory>
 
@@ -76,6 +77,16 @@ namespace multigpu {
     /// Post a job to close the session.
     void Close();
 
+    /// Number of messages received from the secondary server.
+    uint64_t GetMessagesReceived() const {
+      return _messages_received;
+    }
+
+    /// Number of bytes received from the secondary server.
+    uint64_t GetBytesReceived() const {
+      return _bytes_received;
+    }
+
   private:
 
     void StartTimer();
@@ -104,6 +115,10 @@ namespace multigpu {
 
     bool _is_writing = false;
 
+    std::atomic<uint64_t> _messages_received{0u};
+
+    std::atomic<uint64_t> _bytes_received{0u};
+
   };
 
 } // namespace multigpu
@@ -6,7 +6,8 @@
 
 #include "carla/multigpu/primaryCommands.h"
 
-// #include "carla/Logging.h"
+#include "carla/Logging.h"
+#include "carla/Time.h"
 #include "carla/multigpu/commands.h"
 #include "carla/multigpu/primary.h"
 #include "carla/multigpu/router.h"
@@ -17,6 +18,12 @@
 namespace carla {
 namespace multigpu {
 
+// frames sent and not acknowledged yet by the secondary servers
+static constexpr uint64_t FRAMES_IN_FLIGHT = 2u;
+
+// do not wait forever for a secondary server that stopped rendering
+static const time_duration FRAME_ACK_TIMEOUT = time_duration::seconds(1u);
+
 PrimaryCommands::PrimaryCommands() {
 }
 
@@ -30,6 +37,17 @@ void PrimaryCommands::SendFrameData(carla::Buffer buffer) {
   // log_info("sending frame command");
 }
 
+// broadcast to all secondary servers a frame
+void PrimaryCommands::SendFrame(uint64_t frame, bool is_keyframe, carla::Buffer buffer) {
+  if (frame > FRAMES_IN_FLIGHT) {
+    const uint64_t previous = frame - FRAMES_IN_FLIGHT;
+    if (!_router->WaitForFrameAck(previous, FRAME_ACK_TIMEOUT)) {
+      log_warning("secondary servers did not acknowledge frame ", previous, " in time");
+    }
+  }
+  _router->WriteFrame(frame, is_keyframe, std::move(buffer));
+}
+
 // broadcast to all secondary servers the map to load
 void PrimaryCommands::SendLoadMap(std::string map) {
   carla::Buffer buf((unsigned char *) map.c_str(), (size_t) map.size() + 1);
@@ -31,6 +31,11 @@ class PrimaryCommands {
 
     // broadcast to all secondary servers the frame data
     void SendFrameData(carla::Buffer buffer);
+
+    // broadcast to all secondary servers a frame of the versioned protocol;
+    // waits for the frames before the previous one to be acknowledged, so the
+    // secondaries can render a frame while the next one is being sent
+    void SendFrame(uint64_t frame, bool is_keyframe, carla::Buffer buffer);
     
     // broadcast to all secondary servers the map to load
     void SendLoadMap(std::string map);
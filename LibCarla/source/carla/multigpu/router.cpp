@@ -9,6 +9,8 @@
 #include "carla/multigpu/listener.h"
 #include "carla/streaming/EndPoint.h"
 
+#include <algorithm>
+
 namespace carla {
 namespace multigpu {
 
@@ -53,6 +55,14 @@ void Router::SetCallbacks() {
     [=](std::shared_ptr<carla::multigpu::Primary> session, carla::Buffer buffer) { 
       auto self = weak.lock();
       if (!self) return;
+      // frame acknowledgements, any other data answers a request
+      if (buffer.size() == sizeof(FrameAck)) {
+        auto ack = reinterpret_cast<const FrameAck *>(buffer.data());
+        if (ack->header.id == MultiGPUCommand::FRAME_ACK) {
+          self->AckFrame(session.get(), ack->frame);
+          return;
+        }
+      }
       std::lock_guard<std::mutex> lock(self->_mutex);
       auto prom =self-> _promises.find(session.get());
       if (prom != self->_promises.end()) {
@@ -86,6 +96,7 @@ boost::asio::ip::tcp::endpoint Router::GetLocalEndpoint() const {
 void Router::ConnectSession(std::shared_ptr<Primary> session) {
   DEBUG_ASSERT(session != nullptr);
   std::lock_guard<std::mutex> lock(_mutex);
+  _acked_frames[session.get()] = _last_frame;
   _sessions.emplace_back(std::move(session));
   log_info("Connected secondary servers:", _sessions.size());
   // run external callback for new connections
@@ -97,6 +108,10 @@ void Router::DisconnectSession(std::shared_ptr<Primary> session) {
   DEBUG_ASSERT(session != nullptr);
   std::lock_guard<std::mutex> lock(_mutex);
   if (_sessions.size() == 0) return;
+  _stats.messages_received += session->GetMessagesReceived();
+  _stats.bytes_received += session->GetBytesReceived();
+  _acked_frames.erase(session.get());
+  _ack_condition.notify_all();
   _sessions.erase(
       std::remove(_sessions.begin(), _sessions.end(), session),
       _sessions.end());
@@ -106,6 +121,8 @@ void Router::DisconnectSession(std::shared_ptr<Primary> session) {
 void Router::ClearSessions() {
   std::lock_guard<std::mutex> lock(_mutex);
   _sessions.clear();
+  _acked_frames.clear();
+  _ack_condition.notify_all();
   log_info("Disconnecting all secondary servers");
 }
 
@@ -149,7 +166,6 @@ std::future<SessionInfo> Router::WriteToNext(MultiGPUCommand id, Buffer &&buffer
     auto s = _sessions[_next];
     if (s != nullptr) {
       _promises[s.get()] = response;
-      std::cout << "Updated promise into map: " << _promises.size() << std::endl;
       s->Write(message);
     }
   }
@@ -157,5 +173,68 @@ std::future<SessionInfo> Router::WriteToNext(MultiGPUCommand id, Buffer &&buffer
   return response->get_future();
 }
 
+void Router::WriteFrame(uint64_t frame, bool is_keyframe, Buffer &&buffer) {
+  FrameHeader frame_header;
+  frame_header.version = FRAME_PROTOCOL_VERSION;
+  frame_header.flags = (is_keyframe ? FRAME_FLAG_KEYFRAME : 0u);
+  frame_header.frame = frame;
+
+  // define the command header
+  CommandHeader header;
+  header.id = MultiGPUCommand::SEND_FRAME_DELTA;
+  header.size = sizeof(frame_header) + buffer.size();
+
+  auto message = Primary::MakeMessage(
+      Buffer((uint8_t *) &header, sizeof(header)),
+      Buffer((uint8_t *) &frame_header, sizeof(frame_header)),
+      std::move(buffer));
+
+  // write to multiple servers
+  std::lock_guard<std::mutex> lock(_mutex);
+  _last_frame = frame;
+  ++_stats.frames_sent;
+  for (auto &s : _sessions) {
+    if (s != nullptr) {
+      s->Write(message);
+    }
+  }
+}
+
+bool Router::WaitForFrameAck(uint64_t frame, time_duration timeout) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  auto acknowledged = [&]() {
+    for (auto &acked : _acked_frames) {
+      if (acked.second < frame) {
+        return false;
+      }
+    }
+    return true;
+  };
+  if (_ack_condition.wait_for(lock, timeout.to_chrono(), acknowledged)) {
+    return true;
+  }
+  ++_stats.ack_timeouts;
+  return false;
+}
+
+void Router::AckFrame(Primary *session, uint64_t frame) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto acked = _acked_frames.find(session);
+  if (acked == _acked_frames.end()) return;
+  acked->second = std::max(acked->second, frame);
+  ++_stats.frames_acknowledged;
+  _ack_condition.notify_all();
+}
+
+Router::Stats Router::GetStats() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  Stats stats = _stats;
+  for (auto &s : _sessions) {
+    stats.messages_received += s->GetMessagesReceived();
+    stats.bytes_received += s->GetBytesReceived();
+  }
+  return stats;
+}
+
 } // namespace multigpu
 } // namespace carla
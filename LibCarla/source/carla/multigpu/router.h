@@ -9,6 +9,7 @@
 // #include "carla/Logging.h"
 #include "carla/streaming/detail/tcp/Message.h"
 #include "carla/ThreadPool.h"
+#include "carla/Time.h"
 #include "carla/multigpu/primary.h"
 #include "carla/multigpu/primaryCommands.h"
 #include "carla/multigpu/commands.h"
@@ -16,6 +17,7 @@
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
 
+#include <condition_variable>
 #include <mutex>
 #include <vector>
 #include <sstream>
@@ -35,12 +37,31 @@ namespace multigpu {
   class Router : public std::enable_shared_from_this<Router> {
   public:
 
+    /// Counters of the traffic with the secondary servers.
+    struct Stats {
+      uint64_t frames_sent = 0u;
+      uint64_t frames_acknowledged = 0u;
+      uint64_t ack_timeouts = 0u;
+      uint64_t messages_received = 0u;
+      uint64_t bytes_received = 0u;
+    };
+
     Router(void);
     explicit Router(uint16_t port);
     ~Router();
     
     void Write(MultiGPUCommand id, Buffer &&buffer);
     std::future<SessionInfo> WriteToNext(MultiGPUCommand id, Buffer &&buffer);
+
+    /// Broadcast the data of @a frame, preceded by its FrameHeader.
+    void WriteFrame(uint64_t frame, bool is_keyframe, Buffer &&buffer);
+
+    /// Wait until all the secondary servers acknowledge @a frame (or a later
+    /// one), returns false if @a timeout expires first.
+    bool WaitForFrameAck(uint64_t frame, time_duration timeout);
+
+    Stats GetStats();
+
     void Stop();
 
     void SetCallbacks();
@@ -62,6 +83,7 @@ namespace multigpu {
     void ConnectSession(std::shared_ptr<Primary> session);
     void DisconnectSession(std::shared_ptr<Primary> session);
     void ClearSessions();
+    void AckFrame(Primary *session, uint64_t frame);
     
     // mutex and thread pool must be at the beginning to be destroyed last
     std::mutex                              _mutex;
@@ -73,6 +95,12 @@ namespace multigpu {
     std::unordered_map<Primary *, std::shared_ptr<std::promise<SessionInfo>>>   _promises;
     PrimaryCommands                         _commander;
     std::function<void(void)>               _callback;
+    // last frame acknowledged by each session, new sessions start at the last
+    // frame sent as they only need the following ones
+    std::unordered_map<Primary *, uint64_t> _acked_frames;
+    std::condition_variable                 _ack_condition;
+    uint64_t                                _last_frame = 0u;
+    Stats                                   _stats;
   };
 
 } // namespace multigpu
@@ -4,8 +4,10 @@
 // This work is licensed under the terms of the MIT license.
 // For a copy, see <https://opensource.org/licenses/MIT>.
 
-// #include "carla/Logging.h"
 #include "carla/multigpu/secondaryCommands.h"
+
+#include "carla/Logging.h"
+#include "carla/multigpu/secondary.h"
 // #include "carla/streaming/detail/tcp/Message.h"
 
 namespace carla {
@@ -24,6 +26,15 @@ void SecondaryCommands::process_command(Buffer buffer) {
   CommandHeader *header;
   header = reinterpret_cast<CommandHeader *>(buffer.data());
   
+  // drop the frames of other versions of the protocol
+  if (header->id == MultiGPUCommand::SEND_FRAME_DELTA) {
+    auto frame = reinterpret_cast<FrameHeader *>(buffer.data() + sizeof(CommandHeader));
+    if (header->size < sizeof(FrameHeader) || frame->version != FRAME_PROTOCOL_VERSION) {
+      log_error("secondary server: ignoring frame of an unsupported protocol version");
+      return;
+    }
+  }
+
   // send only data to the callback
   Buffer data(buffer.data() + sizeof(CommandHeader), header->size);
   _callback(header->id, std::move(data));
@@ -31,6 +42,13 @@ void SecondaryCommands::process_command(Buffer buffer) {
   // log_info("Secondary got a command to process");
 }
 
+void SecondaryCommands::SendFrameAck(uint64_t frame) {
+  FrameAck ack;
+  ack.header.id = MultiGPUCommand::FRAME_ACK;
+  ack.header.size = sizeof(ack.frame);
+  ack.frame = frame;
+  _secondary->Write(Buffer(reinterpret_cast<const unsigned char *>(&ack), sizeof(ack)));
+}
 
 } // namespace multigpu
 } // namespace carla
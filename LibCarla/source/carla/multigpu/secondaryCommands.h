@@ -25,6 +25,9 @@ class SecondaryCommands {
   void set_callback(callback_type callback);
   void process_command(Buffer buffer);
 
+  // tell the primary server that a frame has been rendered
+  void SendFrameAck(uint64_t frame);
+
   private:
   std::shared_ptr<Secondary>  _secondary;
   callback_type               _callback;
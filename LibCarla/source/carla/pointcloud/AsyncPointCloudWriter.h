@@ -0,0 +1,126 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Logging.h"
+#include "carla/NonCopyable.h"
+#include "carla/ThreadGroup.h"
+#include "carla/pointcloud/PointCloudIO.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+
+namespace carla {
+namespace pointcloud {
+
+  /// Writes point clouds to disk in the background with a fixed number of
+  /// worker threads. At most @a max_pending clouds are queued, SaveToDisk
+  /// blocks while the queue is full so memory stays bounded if the disk cannot
+  /// keep up.
+  class AsyncPointCloudWriter : private NonCopyable {
+  public:
+
+    explicit AsyncPointCloudWriter(size_t worker_threads = 2u, size_t max_pending = 64u)
+      : _max_pending(std::max(max_pending, size_t(1u))) {
+      _workers.CreateThreads(std::max(worker_threads, size_t(1u)), [this]() { Run(); });
+    }
+
+    /// Writes every pending cloud and joins the worker threads.
+    ~AsyncPointCloudWriter() {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+      }
+      _queue_changed.notify_all();
+      _workers.JoinAll();
+    }
+
+    /// Queue @a cloud to be saved to @a path, see PointCloudIO::SaveToDisk.
+    /// @a cloud is any pointer-like owner of a point range, it is kept alive
+    /// until the cloud is written and released on a worker thread, so it must
+    /// not hold references that need a lock to drop (e.g. Python objects).
+    /// Returns the final path.
+    template <typename PointCloudPtrT>
+    std::string SaveToDisk(PointCloudPtrT cloud, std::string path, bool binary = false) {
+      // Validate synchronously so the caller gets the final path.
+      FileSystem::ValidateFilePath(path, ".ply");
+      Push([cloud=std::move(cloud), path, binary]() {
+        PointCloudIO::SaveToDisk(path, cloud->begin(), cloud->end(), binary);
+      });
+      return path;
+    }
+
+    /// Block until every queued cloud has been written.
+    void Flush() {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _queue_changed.wait(lock, [this]() { return _pending == 0u; });
+    }
+
+    /// Number of clouds queued or being written.
+    size_t GetPendingCount() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _pending;
+    }
+
+  private:
+
+    void Push(std::function<void()> job) {
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _queue_changed.wait(lock, [this]() { return _pending < _max_pending; });
+        _jobs.emplace_back(std::move(job));
+        ++_pending;
+      }
+      _queue_changed.notify_all();
+    }
+
+    void Run() {
+      for (;;) {
+        std::function<void()> job;
+        {
+          std::unique_lock<std::mutex> lock(_mutex);
+          _queue_changed.wait(lock, [this]() { return _stop || !_jobs.empty(); });
+          if (_jobs.empty()) {
+            return;
+          }
+          job = std::move(_jobs.front());
+          _jobs.pop_front();
+        }
+        try {
+          job();
+        } catch (const std::exception &e) {
+          log_error("failed to save point cloud:", e.what());
+        }
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+          --_pending;
+        }
+        _queue_changed.notify_all();
+      }
+    }
+
+    const size_t _max_pending;
+
+    mutable std::mutex _mutex;
+
+    std::condition_variable _queue_changed;
+
+    std::deque<std::function<void()>> _jobs;
+
+    size_t _pending = 0u;
+
+    bool _stop = false;
+
+    ThreadGroup _workers;
+  };
+
+} // namespace pointcloud
+} // namespace carla
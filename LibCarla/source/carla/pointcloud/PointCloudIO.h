@@ -11,6 +11,9 @@
 #include <fstream>
 #include <iterator>
 #include <iomanip>
+#include <memory>
+#include <type_traits>
+#include <vector>
 
 namespace carla {
 namespace pointcloud {
@@ -20,30 +23,97 @@ namespace pointcloud {
   public:
     template <typename PointIt>
     static void Dump(std::ostream &out, PointIt begin, PointIt end) {
-      WriteHeader(out, begin, end);
+      WriteHeader(out, begin, end, "ascii");
+      out << std::fixed << std::setprecision(4u);
       for (; begin != end; ++begin) {
         begin->WriteDetection(out);
         out << '\n';
       }
     }
 
+    /// Dump the points as binary_little_endian PLY. The points are written as
+    /// laid out in memory, so the properties of WritePlyHeaderInfo must match
+    /// the fields of the point type, in order.
+    template <typename PointIt>
+    static void DumpBinary(std::ostream &out, PointIt begin, PointIt end) {
+      WriteHeader(out, begin, end, "binary_little_endian");
+      WritePoints(out, begin, end);
+    }
+
+    /// Dump x, y, z and intensity of every point as a KITTI Velodyne scan,
+    /// 4 float32 per point. Points without intensity are written with 0.
+    template <typename PointIt>
+    static void DumpKitti(std::ostream &out, PointIt begin, PointIt end) {
+      std::vector<float> buffer;
+      buffer.reserve(4u * static_cast<size_t>(std::distance(begin, end)));
+      for (; begin != end; ++begin) {
+        buffer.insert(buffer.end(), {begin->point.x, begin->point.y, begin->point.z, GetIntensity(*begin, 0)});
+      }
+      out.write(reinterpret_cast<const char *>(buffer.data()), sizeof(float) * buffer.size());
+    }
+
+    /// Save the points to @a path. The format is chosen from the extension,
+    /// ".bin" for a KITTI scan, otherwise PLY (ASCII, or binary if @a binary
+    /// is true). The ".ply" extension is added if missing.
     template <typename PointIt>
-    static std::string SaveToDisk(std::string path, PointIt begin, PointIt end) {
+    static std::string SaveToDisk(std::string path, PointIt begin, PointIt end, bool binary = false) {
       FileSystem::ValidateFilePath(path, ".ply");
-      std::ofstream out(path);
-      Dump(out, begin, end);
+      if (IsKittiPath(path)) {
+        std::ofstream out(path, std::ios::binary);
+        DumpKitti(out, begin, end);
+      } else if (binary) {
+        std::ofstream out(path, std::ios::binary);
+        DumpBinary(out, begin, end);
+      } else {
+        std::ofstream out(path);
+        Dump(out, begin, end);
+      }
       return path;
     }
 
   private:
-    template <typename PointIt> static void WriteHeader(std::ostream &out, PointIt begin, PointIt end) {
+    template <typename PointIt>
+    static void WriteHeader(std::ostream &out, PointIt begin, PointIt end, const char *format) {
       DEBUG_ASSERT(std::distance(begin, end) >= 0);
       out << "ply\n"
-           "format ascii 1.0\n"
+           "format " << format << " 1.0\n"
            "element vertex " << std::to_string(static_cast<size_t>(std::distance(begin, end))) << "\n";
-      begin->WritePlyHeaderInfo(out);
-      out << "\nend_header\n";
-      out << std::fixed << std::setprecision(4u);
+      if (begin != end) {
+        begin->WritePlyHeaderInfo(out);
+        out << '\n';
+      }
+      out << "end_header\n";
+    }
+
+    /// Contiguous points, written in a single call.
+    template <typename T>
+    static void WritePoints(std::ostream &out, T *begin, T *end) {
+      static_assert(std::is_trivially_copyable<T>::value, "Points must be trivially copyable");
+      out.write(reinterpret_cast<const char *>(begin), sizeof(T) * static_cast<size_t>(end - begin));
+    }
+
+    template <typename PointIt>
+    static void WritePoints(std::ostream &out, PointIt begin, PointIt end) {
+      for (; begin != end; ++begin) {
+        const auto *point = std::addressof(*begin);
+        WritePoints(out, point, point + 1);
+      }
+    }
+
+    template <typename T>
+    static auto GetIntensity(const T &point, int) -> decltype(static_cast<float>(point.intensity)) {
+      return point.intensity;
+    }
+
+    template <typename T>
+    static float GetIntensity(const T &, long) {
+      return 0.0f;
+    }
+
+    static bool IsKittiPath(const std::string &path) {
+      constexpr char extension[] = ".bin";
+      constexpr size_t length = sizeof(extension) - 1u;
+      return path.size() >= length && path.compare(path.size() - length, length, extension) == 0;
     }
   };
 
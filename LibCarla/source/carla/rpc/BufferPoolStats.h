@@ -0,0 +1,59 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/BufferPool.h"
+#include "carla/MsgPack.h"
+
+#include <cstdint>
+
+namespace carla {
+namespace rpc {
+
+  /// Statistics of the buffer pools of the streaming server, see
+  /// BufferPool::Stats.
+  class BufferPoolStats {
+  public:
+
+    BufferPoolStats() = default;
+
+    explicit BufferPoolStats(const BufferPool::Stats &stats)
+      : bytes_held(stats.bytes_held),
+        buffers_held(stats.buffers_held),
+        hits(stats.hits),
+        allocations(stats.allocations),
+        buffers_released(stats.buffers_released),
+        bytes_released(stats.bytes_released) {}
+
+    uint64_t bytes_held = 0u;
+
+    uint64_t buffers_held = 0u;
+
+    uint64_t hits = 0u;
+
+    uint64_t allocations = 0u;
+
+    uint64_t buffers_released = 0u;
+
+    uint64_t bytes_released = 0u;
+
+    double GetHitRate() const {
+      const auto total = hits + allocations;
+      return total > 0u ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+    }
+
+    MSGPACK_DEFINE_ARRAY(
+        bytes_held,
+        buffers_held,
+        hits,
+        allocations,
+        buffers_released,
+        bytes_released);
+  };
+
+} // namespace rpc
+} // namespace carla
@@ -0,0 +1,102 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/MsgPack.h"
+#include "carla/rpc/Location.h"
+#include "carla/rpc/ObjectLabel.h"
+#include "carla/rpc/Vector3D.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace carla {
+namespace rpc {
+
+  /// Rays of a batched ray cast, stored as a structure of arrays. Each ray
+  /// returns its closest hit within max_distance meters.
+  class RayCastBatch {
+  public:
+
+    RayCastBatch() = default;
+
+    explicit RayCastBatch(float distance) : max_distance(distance) {}
+
+    size_t size() const {
+      return origin_x.size();
+    }
+
+    void reserve(size_t count) {
+      for (auto *values : {&origin_x, &origin_y, &origin_z, &direction_x, &direction_y, &direction_z}) {
+        values->reserve(count);
+      }
+    }
+
+    void Add(const Location &origin, const Vector3D &direction) {
+      origin_x.emplace_back(origin.x);
+      origin_y.emplace_back(origin.y);
+      origin_z.emplace_back(origin.z);
+      direction_x.emplace_back(direction.x);
+      direction_y.emplace_back(direction.y);
+      direction_z.emplace_back(direction.z);
+    }
+
+    bool IsValid() const {
+      const auto count = size();
+      return origin_y.size() == count && origin_z.size() == count &&
+          direction_x.size() == count && direction_y.size() == count &&
+          direction_z.size() == count;
+    }
+
+    std::vector<float> origin_x;
+    std::vector<float> origin_y;
+    std::vector<float> origin_z;
+
+    std::vector<float> direction_x;
+    std::vector<float> direction_y;
+    std::vector<float> direction_z;
+
+    float max_distance = 10000.0f;
+
+    MSGPACK_DEFINE_ARRAY(
+        origin_x,
+        origin_y,
+        origin_z,
+        direction_x,
+        direction_y,
+        direction_z,
+        max_distance);
+  };
+
+  /// Result of one ray of a RayCastBatch. The server packs them back to back
+  /// into a binary buffer, see Unpack.
+#pragma pack(push, 1)
+  struct RayCastHit {
+    Location location;
+
+    /// Distance from the origin of the ray, in meters.
+    float distance = 0.0f;
+
+    CityObjectLabel label = CityObjectLabel::None;
+
+    bool hit = false;
+
+    static std::vector<RayCastHit> Unpack(const std::vector<uint8_t> &buffer) {
+      std::vector<RayCastHit> result(buffer.size() / sizeof(RayCastHit));
+      if (!result.empty()) {
+        std::memcpy(result.data(), buffer.data(), result.size() * sizeof(RayCastHit));
+      }
+      return result;
+    }
+  };
+#pragma pack(pop)
+
+  static_assert(sizeof(RayCastHit) == 18u, "Invalid RayCastHit size");
+
+} // namespace rpc
+} // namespace carla
@@ -0,0 +1,66 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/MsgPack.h"
+#include "carla/streaming/detail/StreamStats.h"
+
+#include <cstdint>
+
+namespace carla {
+namespace rpc {
+
+  /// Outbound traffic of the stream of a sensor, see
+  /// streaming::detail::StreamStats.
+  class StreamStats {
+  public:
+
+    StreamStats() = default;
+
+    explicit StreamStats(const streaming::detail::StreamStats &stats)
+      : queued_messages(stats.queued_messages),
+        queued_bytes(stats.queued_bytes),
+        sent_messages(stats.sent_messages),
+        sent_bytes(stats.sent_bytes),
+        dropped_messages(stats.dropped_messages),
+        dropped_bytes(stats.dropped_bytes),
+        last_latency_us(stats.last_latency_us),
+        max_latency_us(stats.max_latency_us),
+        average_latency_us(stats.GetAverageLatency()) {}
+
+    uint64_t queued_messages = 0u;
+
+    uint64_t queued_bytes = 0u;
+
+    uint64_t sent_messages = 0u;
+
+    uint64_t sent_bytes = 0u;
+
+    uint64_t dropped_messages = 0u;
+
+    uint64_t dropped_bytes = 0u;
+
+    uint64_t last_latency_us = 0u;
+
+    uint64_t max_latency_us = 0u;
+
+    uint64_t average_latency_us = 0u;
+
+    MSGPACK_DEFINE_ARRAY(
+        queued_messages,
+        queued_bytes,
+        sent_messages,
+        sent_bytes,
+        dropped_messages,
+        dropped_bytes,
+        last_latency_us,
+        max_latency_us,
+        average_latency_us);
+  };
+
+} // namespace rpc
+} // namespace carla
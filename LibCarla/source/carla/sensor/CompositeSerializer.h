@@ -7,6 +7,7 @@
 #pragma once
 
 #include "carla/Buffer.h"
+#include "carla/BufferList.h"
 #include "carla/Memory.h"
 #include "carla/sensor/CompileTimeTypeMap.h"
 #include "carla/sensor/RawData.h"
@@ -33,10 +34,10 @@ namespace sensor {
 
     using interpreted_type = SharedPtr<SensorData>;
 
-    /// Serialize the arguments provided into a Buffer by calling to the
-    /// serializer registered for the given @a Sensor type.
+    /// Serialize the arguments provided into a Buffer, or a BufferList, by
+    /// calling to the serializer registered for the given @a Sensor type.
     template <typename Sensor, typename... Args>
-    static Buffer Serialize(Sensor &sensor, Args &&... args);
+    static auto Serialize(Sensor &sensor, Args &&... args);
 
     /// Deserializes a Buffer by calling the "Deserialize" function of the
     /// serializer that generated the Buffer.
@@ -77,7 +78,7 @@ namespace sensor {
 
   template <typename... Items>
   template <typename Sensor, typename... Args>
-  inline Buffer CompositeSerializer<Items...>::Serialize(Sensor &sensor, Args &&... args) {
+  inline auto CompositeSerializer<Items...>::Serialize(Sensor &sensor, Args &&... args) {
     using TheSensor = typename std::remove_const<Sensor>::type;
     using Serializer = typename Super::template get<TheSensor*>::type;
     return Serializer::Serialize(sensor, std::forward<Args>(args)...);
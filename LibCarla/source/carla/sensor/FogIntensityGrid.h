@@ -0,0 +1,208 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Debug.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+namespace carla {
+namespace sensor {
+
+  /// Soft-return tables (R_tmp and i_tmp) of several attenuation coefficients
+  /// sampled on the same distances, stored as one row-major alpha × distance
+  /// grid. Rows are kept sorted by alpha so any alpha in between can be
+  /// interpolated without reloading anything.
+  class FogIntensityGrid {
+  public:
+
+    FogIntensityGrid() = default;
+
+    FogIntensityGrid(uint32_t columns, float steps_per_meter, float max_distance)
+      : _columns(columns),
+        _steps_per_meter(steps_per_meter),
+        _max_distance(max_distance) {}
+
+    uint32_t columns() const {
+      return _columns;
+    }
+
+    size_t rows() const {
+      return _alphas.size();
+    }
+
+    bool empty() const {
+      return _alphas.empty();
+    }
+
+    float steps_per_meter() const {
+      return _steps_per_meter;
+    }
+
+    float max_distance() const {
+      return _max_distance;
+    }
+
+    const std::vector<float> &alphas() const {
+      return _alphas;
+    }
+
+    /// Add the table of @a alpha, @a distance and @a integral must have
+    /// columns() elements. Replaces the row if @a alpha is already present.
+    void AddRow(float alpha, const float *distance, const float *integral) {
+      DEBUG_ASSERT(distance != nullptr && integral != nullptr);
+      const auto it = std::lower_bound(_alphas.begin(), _alphas.end(), alpha);
+      const auto row = static_cast<size_t>(std::distance(_alphas.begin(), it));
+      const auto offset = static_cast<std::ptrdiff_t>(row * _columns);
+      if (it != _alphas.end() && *it == alpha) {
+        std::copy(distance, distance + _columns, _distance.begin() + offset);
+        std::copy(integral, integral + _columns, _integral.begin() + offset);
+        return;
+      }
+      _alphas.insert(it, alpha);
+      _distance.insert(_distance.begin() + offset, distance, distance + _columns);
+      _integral.insert(_integral.begin() + offset, integral, integral + _columns);
+    }
+
+    /// Write into @a distance and @a integral (columns() elements each) the
+    /// table of @a alpha, linearly interpolated between the two closest rows.
+    /// Alphas out of range are clamped to the first or last row.
+    void Interpolate(float alpha, float *distance, float *integral) const {
+      DEBUG_ASSERT(!empty());
+      size_t upper = static_cast<size_t>(std::distance(
+          _alphas.begin(),
+          std::upper_bound(_alphas.begin(), _alphas.end(), alpha)));
+      upper = std::min(std::max(upper, size_t(1u)), rows() - 1u);
+      const size_t lower = rows() > 1u ? upper - 1u : 0u;
+      float weight = 0.0f;
+      if (upper != lower) {
+        weight = (alpha - _alphas[lower]) / (_alphas[upper] - _alphas[lower]);
+        weight = std::min(std::max(weight, 0.0f), 1.0f);
+      }
+      const float *distance0 = _distance.data() + lower * _columns;
+      const float *distance1 = _distance.data() + upper * _columns;
+      const float *integral0 = _integral.data() + lower * _columns;
+      const float *integral1 = _integral.data() + upper * _columns;
+      for (auto i = 0u; i < _columns; ++i) {
+        distance[i] = distance0[i] + weight * (distance1[i] - distance0[i]);
+        integral[i] = integral0[i] + weight * (integral1[i] - integral0[i]);
+      }
+    }
+
+    // =========================================================================
+    /// @name Binary cache
+    // =========================================================================
+    /// @{
+
+    /// Pack the grid into a little-endian binary blob. @a source_key
+    /// identifies the text tables the grid was built from.
+    std::vector<unsigned char> Serialize(uint64_t source_key) const {
+      Header header;
+      header.source_key = source_key;
+      header.rows = static_cast<uint32_t>(rows());
+      header.columns = _columns;
+      header.steps_per_meter = _steps_per_meter;
+      header.max_distance = _max_distance;
+      std::vector<unsigned char> buffer(sizeof(Header) + GetPayloadSize(header.rows, header.columns));
+      unsigned char *out = buffer.data();
+      out = Write(out, &header, sizeof(Header));
+      out = Write(out, _alphas.data(), _alphas.size() * sizeof(float));
+      out = Write(out, _distance.data(), _distance.size() * sizeof(float));
+      Write(out, _integral.data(), _integral.size() * sizeof(float));
+      return buffer;
+    }
+
+    /// Unpack a blob written by Serialize. Returns false, leaving @a grid
+    /// untouched, if the blob is malformed, from another version or built
+    /// from different tables than @a source_key.
+    static bool Deserialize(
+        const unsigned char *data,
+        size_t size,
+        uint64_t source_key,
+        FogIntensityGrid &grid) {
+      Header header;
+      if (data == nullptr || size < sizeof(Header)) {
+        return false;
+      }
+      std::memcpy(&header, data, sizeof(Header));
+      if (std::memcmp(header.magic, Header().magic, sizeof(header.magic)) != 0 ||
+          header.version != Header().version ||
+          header.source_key != source_key ||
+          size != sizeof(Header) + GetPayloadSize(header.rows, header.columns)) {
+        return false;
+      }
+      FogIntensityGrid result{header.columns, header.steps_per_meter, header.max_distance};
+      const size_t cells = static_cast<size_t>(header.rows) * header.columns;
+      const unsigned char *in = data + sizeof(Header);
+      result._alphas.resize(header.rows);
+      result._distance.resize(cells);
+      result._integral.resize(cells);
+      in = Read(in, result._alphas.data(), header.rows * sizeof(float));
+      in = Read(in, result._distance.data(), cells * sizeof(float));
+      Read(in, result._integral.data(), cells * sizeof(float));
+      if (!std::is_sorted(result._alphas.begin(), result._alphas.end())) {
+        return false;
+      }
+      grid = std::move(result);
+      return true;
+    }
+
+    /// @}
+
+  private:
+
+#pragma pack(push, 1)
+    struct Header {
+      char magic[4u] = {'C', 'F', 'O', 'G'};
+      uint32_t version = 1u;
+      uint64_t source_key = 0u;
+      uint32_t rows = 0u;
+      uint32_t columns = 0u;
+      float steps_per_meter = 0.0f;
+      float max_distance = 0.0f;
+    };
+#pragma pack(pop)
+
+    static size_t GetPayloadSize(uint32_t rows, uint32_t columns) {
+      return sizeof(float) * (rows + 2u * static_cast<size_t>(rows) * columns);
+    }
+
+    static unsigned char *Write(unsigned char *out, const void *data, size_t size) {
+      if (size > 0u) {
+        std::memcpy(out, data, size);
+      }
+      return out + size;
+    }
+
+    static const unsigned char *Read(const unsigned char *in, void *data, size_t size) {
+      if (size > 0u) {
+        std::memcpy(data, in, size);
+      }
+      return in + size;
+    }
+
+    uint32_t _columns = 0u;
+
+    float _steps_per_meter = 10.0f;
+
+    float _max_distance = 200.0f;
+
+    std::vector<float> _alphas;
+
+    /// R_tmp, row-major.
+    std::vector<float> _distance;
+
+    /// i_tmp, row-major.
+    std::vector<float> _integral;
+  };
+
+} // namespace sensor
+} // namespace carla
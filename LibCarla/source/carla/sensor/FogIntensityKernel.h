@@ -0,0 +1,309 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#  include <immintrin.h>
+#  define LIBCARLA_FOG_KERNEL_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define LIBCARLA_FOG_KERNEL_SSE2
+#endif
+
+namespace carla {
+namespace sensor {
+
+  /// Coefficients of the fog LiDAR intensity model, shared by every point of
+  /// a tick.
+  struct FogIntensityParameters {
+    /// C_A * P_0.
+    float original_intensity = 5e9f;
+
+    /// Attenuation coefficient.
+    float alpha = 0.0f;
+
+    /// Backscattering coefficient.
+    float beta = 0.0f;
+
+    /// Whether there is fog, if false only the hard return is computed.
+    bool is_foggy = false;
+
+    /// Soft-return table (R_tmp and i_tmp) sampled every 1 / steps_per_meter
+    /// meters from 0 up to max_distance, may be null. Looked up with linear
+    /// interpolation between samples.
+    const float *step_distance = nullptr;
+    const float *step_integral = nullptr;
+    uint32_t table_size = 0u;
+    float steps_per_meter = 10.0f;
+    float max_distance = 200.0f;
+
+    bool HasTable() const {
+      return step_distance != nullptr && step_integral != nullptr && table_size > 0u;
+    }
+
+    /// R_tmp and i_tmp at @a distance, linearly interpolated between the two
+    /// closest samples.
+    void SampleTable(float distance, float &out_distance, float &out_integral) const {
+      const float position = std::min(std::max(distance, 0.0f), max_distance) * steps_per_meter;
+      const uint32_t last = table_size - 1u;
+      const uint32_t index0 = std::min(static_cast<uint32_t>(position), last);
+      const uint32_t index1 = std::min(index0 + 1u, last);
+      const float weight = std::min(position - static_cast<float>(index0), 1.0f);
+      out_distance = step_distance[index0] + weight * (step_distance[index1] - step_distance[index0]);
+      out_integral = step_integral[index0] + weight * (step_integral[index1] - step_integral[index0]);
+    }
+  };
+
+  /// Structure-of-arrays view over the points of one channel.
+  struct FogIntensityBatch {
+    size_t size = 0u;
+
+    /// Input, distance from the sensor to each hit.
+    const float *distance = nullptr;
+
+    /// Input, reflectivity / pi of each hit.
+    const float *beta0 = nullptr;
+
+    /// Input, range noise factor applied to soft returns.
+    const float *noise_factor = nullptr;
+
+    /// Output, received intensity.
+    float *intensity = nullptr;
+
+    /// Output, factor to rescale each point by.
+    float *scaling = nullptr;
+
+    /// Output, 1 if the soft return (fog) is stronger than the hard return.
+    uint8_t *is_soft = nullptr;
+  };
+
+  /// Evaluates the hard return, the soft return, the soft-vs-hard selection
+  /// and the point rescaling of the fog LiDAR for a whole channel at once.
+  class FogIntensityKernel {
+  public:
+
+    /// Reference implementation, one point at a time.
+    static void ComputeScalar(const FogIntensityParameters &params, const FogIntensityBatch &batch) {
+      ComputeScalar(params, batch, 0u);
+    }
+
+    /// Vectorized implementation (AVX2 or SSE2 depending on the target),
+    /// falls back to ComputeScalar when none is available.
+    static void Compute(const FogIntensityParameters &params, const FogIntensityBatch &batch) {
+#if defined(LIBCARLA_FOG_KERNEL_AVX2)
+      ComputeScalar(params, batch, ComputeAVX2(params, batch));
+#elif defined(LIBCARLA_FOG_KERNEL_SSE2)
+      ComputeScalar(params, batch, ComputeSSE2(params, batch));
+#else
+      ComputeScalar(params, batch, 0u);
+#endif
+    }
+
+  private:
+
+    static void ComputeScalar(
+        const FogIntensityParameters &params,
+        const FogIntensityBatch &batch,
+        size_t begin) {
+      const bool has_table = params.HasTable();
+      for (auto i = begin; i < batch.size; ++i) {
+        const float distance = batch.distance[i];
+        float hard = params.original_intensity * batch.beta0[i] / (distance * distance) *
+            std::exp(-2.0f * params.alpha * distance);
+        batch.intensity[i] = hard;
+        batch.scaling[i] = 1.0f;
+        batch.is_soft[i] = 0u;
+        if (!params.is_foggy) {
+          continue;
+        }
+        hard = std::min(hard, 255.0f);
+        batch.intensity[i] = hard;
+        if (!has_table) {
+          continue;
+        }
+        float step_distance;
+        float step_integral;
+        params.SampleTable(distance, step_distance, step_integral);
+        const float soft = std::min(
+            params.original_intensity * params.beta * step_integral,
+            255.0f);
+        if (soft > hard) {
+          batch.intensity[i] = soft;
+          batch.scaling[i] = step_distance / distance * batch.noise_factor[i];
+          batch.is_soft[i] = 1u;
+        }
+      }
+    }
+
+#if defined(LIBCARLA_FOG_KERNEL_AVX2)
+
+    /// Cephes-style single precision exp(x).
+    static __m256 Exp(__m256 x) {
+      x = _mm256_min_ps(x, _mm256_set1_ps(88.3762626647949f));
+      x = _mm256_max_ps(x, _mm256_set1_ps(-88.3762626647949f));
+      __m256 fx = _mm256_fmadd_ps(x, _mm256_set1_ps(1.44269504088896341f), _mm256_set1_ps(0.5f));
+      fx = _mm256_floor_ps(fx);
+      x = _mm256_fnmadd_ps(fx, _mm256_set1_ps(0.693359375f), x);
+      x = _mm256_fnmadd_ps(fx, _mm256_set1_ps(-2.12194440e-4f), x);
+      __m256 y = _mm256_set1_ps(1.9875691500e-4f);
+      y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(1.3981999507e-3f));
+      y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(8.3334519073e-3f));
+      y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(4.1665795894e-2f));
+      y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(1.6666665459e-1f));
+      y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(5.0000001201e-1f));
+      y = _mm256_fmadd_ps(y, _mm256_mul_ps(x, x), _mm256_add_ps(x, _mm256_set1_ps(1.0f)));
+      __m256i exponent = _mm256_add_epi32(_mm256_cvttps_epi32(fx), _mm256_set1_epi32(0x7f));
+      exponent = _mm256_slli_epi32(exponent, 23);
+      return _mm256_mul_ps(y, _mm256_castsi256_ps(exponent));
+    }
+
+    /// Returns the number of points processed.
+    static size_t ComputeAVX2(const FogIntensityParameters &params, const FogIntensityBatch &batch) {
+      constexpr size_t width = 8u;
+      const size_t end = batch.size - batch.size % width;
+      const bool has_table = params.is_foggy && params.HasTable();
+      const __m256 original_intensity = _mm256_set1_ps(params.original_intensity);
+      const __m256 minus_two_alpha = _mm256_set1_ps(-2.0f * params.alpha);
+      const __m256 soft_gain = _mm256_set1_ps(params.original_intensity * params.beta);
+      const __m256 max_intensity = _mm256_set1_ps(255.0f);
+      const __m256 one = _mm256_set1_ps(1.0f);
+      const __m256 zero = _mm256_setzero_ps();
+      const __m256 max_distance = _mm256_set1_ps(params.max_distance);
+      const __m256 steps_per_meter = _mm256_set1_ps(params.steps_per_meter);
+      const __m256i last_index = _mm256_set1_epi32(static_cast<int>(params.table_size) - 1);
+      for (size_t i = 0u; i < end; i += width) {
+        const __m256 distance = _mm256_loadu_ps(batch.distance + i);
+        const __m256 beta0 = _mm256_loadu_ps(batch.beta0 + i);
+        __m256 hard = _mm256_div_ps(
+            _mm256_mul_ps(original_intensity, beta0),
+            _mm256_mul_ps(distance, distance));
+        hard = _mm256_mul_ps(hard, Exp(_mm256_mul_ps(minus_two_alpha, distance)));
+        __m256 intensity = hard;
+        __m256 scaling = one;
+        int soft_mask = 0;
+        if (params.is_foggy) {
+          hard = _mm256_min_ps(hard, max_intensity);
+          intensity = hard;
+          if (has_table) {
+            const __m256 position = _mm256_mul_ps(
+                _mm256_min_ps(_mm256_max_ps(distance, zero), max_distance),
+                steps_per_meter);
+            const __m256i index0 = _mm256_min_epi32(_mm256_cvttps_epi32(position), last_index);
+            const __m256i index1 = _mm256_min_epi32(_mm256_add_epi32(index0, _mm256_set1_epi32(1)), last_index);
+            const __m256 weight = _mm256_min_ps(_mm256_sub_ps(position, _mm256_cvtepi32_ps(index0)), one);
+            const __m256 integral0 = _mm256_i32gather_ps(params.step_integral, index0, 4);
+            const __m256 integral1 = _mm256_i32gather_ps(params.step_integral, index1, 4);
+            const __m256 distance0 = _mm256_i32gather_ps(params.step_distance, index0, 4);
+            const __m256 distance1 = _mm256_i32gather_ps(params.step_distance, index1, 4);
+            const __m256 integral = _mm256_fmadd_ps(weight, _mm256_sub_ps(integral1, integral0), integral0);
+            const __m256 step_distance = _mm256_fmadd_ps(weight, _mm256_sub_ps(distance1, distance0), distance0);
+            const __m256 soft = _mm256_min_ps(_mm256_mul_ps(soft_gain, integral), max_intensity);
+            const __m256 is_soft = _mm256_cmp_ps(soft, hard, _CMP_GT_OQ);
+            const __m256 soft_scaling = _mm256_mul_ps(
+                _mm256_div_ps(step_distance, distance),
+                _mm256_loadu_ps(batch.noise_factor + i));
+            intensity = _mm256_blendv_ps(hard, soft, is_soft);
+            scaling = _mm256_blendv_ps(one, soft_scaling, is_soft);
+            soft_mask = _mm256_movemask_ps(is_soft);
+          }
+        }
+        _mm256_storeu_ps(batch.intensity + i, intensity);
+        _mm256_storeu_ps(batch.scaling + i, scaling);
+        for (auto j = 0u; j < width; ++j) {
+          batch.is_soft[i + j] = static_cast<uint8_t>((soft_mask >> j) & 1);
+        }
+      }
+      return end;
+    }
+
+#elif defined(LIBCARLA_FOG_KERNEL_SSE2)
+
+    /// Cephes-style single precision exp(x).
+    static __m128 Exp(__m128 x) {
+      x = _mm_min_ps(x, _mm_set1_ps(88.3762626647949f));
+      x = _mm_max_ps(x, _mm_set1_ps(-88.3762626647949f));
+      __m128 fx = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(1.44269504088896341f)), _mm_set1_ps(0.5f));
+      // floor(fx), SSE2 has no rounding instruction.
+      __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(fx));
+      fx = _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, fx), _mm_set1_ps(1.0f)));
+      x = _mm_sub_ps(x, _mm_mul_ps(fx, _mm_set1_ps(0.693359375f)));
+      x = _mm_sub_ps(x, _mm_mul_ps(fx, _mm_set1_ps(-2.12194440e-4f)));
+      __m128 y = _mm_set1_ps(1.9875691500e-4f);
+      y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.3981999507e-3f));
+      y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(8.3334519073e-3f));
+      y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(4.1665795894e-2f));
+      y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.6666665459e-1f));
+      y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(5.0000001201e-1f));
+      y = _mm_add_ps(_mm_mul_ps(y, _mm_mul_ps(x, x)), _mm_add_ps(x, _mm_set1_ps(1.0f)));
+      __m128i exponent = _mm_add_epi32(_mm_cvttps_epi32(fx), _mm_set1_epi32(0x7f));
+      exponent = _mm_slli_epi32(exponent, 23);
+      return _mm_mul_ps(y, _mm_castsi128_ps(exponent));
+    }
+
+    static __m128 Select(__m128 mask, __m128 a, __m128 b) {
+      return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    /// Returns the number of points processed.
+    static size_t ComputeSSE2(const FogIntensityParameters &params, const FogIntensityBatch &batch) {
+      constexpr size_t width = 4u;
+      const size_t end = batch.size - batch.size % width;
+      const bool has_table = params.is_foggy && params.HasTable();
+      const __m128 original_intensity = _mm_set1_ps(params.original_intensity);
+      const __m128 minus_two_alpha = _mm_set1_ps(-2.0f * params.alpha);
+      const __m128 soft_gain = _mm_set1_ps(params.original_intensity * params.beta);
+      const __m128 max_intensity = _mm_set1_ps(255.0f);
+      const __m128 one = _mm_set1_ps(1.0f);
+      alignas(16) float integral[width];
+      alignas(16) float step_distance[width];
+      for (size_t i = 0u; i < end; i += width) {
+        const __m128 distance = _mm_loadu_ps(batch.distance + i);
+        const __m128 beta0 = _mm_loadu_ps(batch.beta0 + i);
+        __m128 hard = _mm_div_ps(
+            _mm_mul_ps(original_intensity, beta0),
+            _mm_mul_ps(distance, distance));
+        hard = _mm_mul_ps(hard, Exp(_mm_mul_ps(minus_two_alpha, distance)));
+        __m128 intensity = hard;
+        __m128 scaling = one;
+        int soft_mask = 0;
+        if (params.is_foggy) {
+          hard = _mm_min_ps(hard, max_intensity);
+          intensity = hard;
+          if (has_table) {
+            // No gather instruction in SSE2.
+            for (auto j = 0u; j < width; ++j) {
+              params.SampleTable(batch.distance[i + j], step_distance[j], integral[j]);
+            }
+            const __m128 soft = _mm_min_ps(_mm_mul_ps(soft_gain, _mm_load_ps(integral)), max_intensity);
+            const __m128 is_soft = _mm_cmpgt_ps(soft, hard);
+            const __m128 soft_scaling = _mm_mul_ps(
+                _mm_div_ps(_mm_load_ps(step_distance), distance),
+                _mm_loadu_ps(batch.noise_factor + i));
+            intensity = Select(is_soft, soft, hard);
+            scaling = Select(is_soft, soft_scaling, one);
+            soft_mask = _mm_movemask_ps(is_soft);
+          }
+        }
+        _mm_storeu_ps(batch.intensity + i, intensity);
+        _mm_storeu_ps(batch.scaling + i, scaling);
+        for (auto j = 0u; j < width; ++j) {
+          batch.is_soft[i + j] = static_cast<uint8_t>((soft_mask >> j) & 1);
+        }
+      }
+      return end;
+    }
+
+#endif
+  };
+
+} // namespace sensor
+} // namespace carla
@@ -15,6 +15,10 @@
 namespace carla {
 namespace sensor {
 
+namespace s11n {
+  class LidarWithFogSerializer;
+} // namespace s11n
+
   /// Wrapper around the raw data generated by a sensor plus some useful
   /// meta-information.
   class RawData {
@@ -89,6 +93,9 @@ namespace sensor {
     template <typename... Items>
     friend class CompositeSerializer;
 
+    /// Rebuilds the raw data of quantized measurements.
+    friend class s11n::LidarWithFogSerializer;
+
     RawData(Buffer &&buffer) : _buffer(std::move(buffer)) {}
 
     Buffer _buffer;
@@ -10,6 +10,7 @@
 #include "carla/sensor/data/SemanticLidarData.h"
 
 #include <cstdint>
+#include <cstring>
 #include <vector>
 
 namespace carla
@@ -34,19 +35,32 @@ namespace carla
       ///    {
       ///      Horizontal angle (float),
       ///      Channel count,
+      ///      Encoding of the points (LidarWithFogEncoding),
+      ///      Position scale (float, only used by the quantized encoding),
+      ///      Intensity scale (float, only used by the quantized encoding),
       ///      Point count of channel 0,
       ///      ...
       ///      Point count of channel n,
       ///    }
       ///
-      /// The points are stored in an array of floats
+      /// The points are stored in an array of detections
       ///
       ///    {
-      ///      X0, Y0, Z0, I0
+      ///      X0, Y0, Z0, I0, tag_0
       ///      ...
-      ///      Xn, Yn, Zn, In
+      ///      Xn, Yn, Zn, In, tag_n
       ///    }
       ///
+      /// or, with the quantized encoding, as int16 positions in units of the
+      /// position scale, and uint8 intensities in units of the intensity scale
+      /// and uint8 tags. The client always expands the quantized points back
+      /// into LidarWithFogDetection.
+      enum class LidarWithFogEncoding : uint32_t
+      {
+        Float32 = 0u,
+        Quantized = 1u
+      };
+
 #pragma pack(push, 1)
       class LidarWithFogDetection
       {
@@ -65,7 +79,7 @@ namespace carla
                  "property float32 y\n" \
                  "property float32 z\n" \
                  "property float32 I\n" \
-                 "property uint32_t object_tag";
+                 "property uint32 object_tag";
         }
 
         void WriteDetection(std::ostream &out) const
@@ -73,15 +87,37 @@ namespace carla
           out << point.x << ' ' << point.y << ' ' << point.z << ' ' << intensity << ' ' << object_tag;
         }
       };
+
+      class LidarWithFogQuantizedDetection
+      {
+      public:
+        int16_t x;
+        int16_t y;
+        int16_t z;
+        uint8_t intensity;
+        uint8_t object_tag;
+      };
 #pragma pack(pop)
 
       class LidarWithFogData : public SemanticLidarData
       {
 
+      protected:
+        enum Index : size_t
+        {
+          HorizontalAngle,
+          ChannelCount,
+          Encoding,
+          PositionScale,
+          IntensityScale,
+          SIZE
+        };
+
       public:
-        explicit LidarWithFogData(uint32_t ChannelCount = 0u)
-            : SemanticLidarData(ChannelCount)
+        explicit LidarWithFogData(uint32_t channel_count = 0u)
+            : SemanticLidarData(channel_count)
         {
+          _header.resize(Index::SIZE + channel_count, 0u);
         }
 
         LidarWithFogData &operator=(LidarWithFogData &&) = default;
@@ -101,6 +137,23 @@ namespace carla
           _points.reserve(total_points);
         }
 
+        virtual void WriteChannelCount(std::vector<uint32_t> points_per_channel)
+        {
+          for (auto idx_channel = 0u; idx_channel < GetChannelCount(); ++idx_channel)
+            _header[Index::SIZE + idx_channel] = points_per_channel[idx_channel];
+        }
+
+        LidarWithFogEncoding GetEncoding() const
+        {
+          return static_cast<LidarWithFogEncoding>(_header[Index::Encoding]);
+        }
+
+        /// Encoding used to send the points to the client.
+        void SetEncoding(LidarWithFogEncoding encoding)
+        {
+          _header[Index::Encoding] = static_cast<uint32_t>(encoding);
+        }
+
         void WritePointSync(LidarWithFogDetection &detection)
         {
           _points.emplace_back(detection);
@@ -117,9 +170,60 @@ namespace carla
           DEBUG_ASSERT(false);
         }
 
+        /// Size the point buffer so that every channel owns a contiguous slice
+        /// of @a max_points_per_channel detections. Each slice can then be
+        /// filled concurrently with WritePointAsync.
+        void ResetChannelSlices(const std::vector<uint32_t> &max_points_per_channel)
+        {
+          DEBUG_ASSERT(GetChannelCount() == max_points_per_channel.size());
+          std::memset(_header.data() + Index::SIZE, 0, sizeof(uint32_t) * GetChannelCount());
+
+          _channel_offsets.resize(max_points_per_channel.size());
+          uint32_t total_points = 0u;
+          for (auto idx_channel = 0u; idx_channel < max_points_per_channel.size(); ++idx_channel)
+          {
+            _channel_offsets[idx_channel] = total_points;
+            total_points += max_points_per_channel[idx_channel];
+          }
+          _points.resize(total_points);
+        }
+
+        /// Write the @a index-th detection of @a channel into its slice. Safe
+        /// to call concurrently for different channels.
+        void WritePointAsync(uint32_t channel, uint32_t index, const LidarWithFogDetection &detection)
+        {
+          DEBUG_ASSERT(channel < _channel_offsets.size());
+          DEBUG_ASSERT(_channel_offsets[channel] + index < _points.size());
+          _points[_channel_offsets[channel] + index] = detection;
+        }
+
+        /// Close the gaps left by the dropped detections of every slice and
+        /// write the final point count of each channel in the header.
+        void CompactChannelSlices(const std::vector<uint32_t> &points_per_channel)
+        {
+          DEBUG_ASSERT(points_per_channel.size() == _channel_offsets.size());
+          size_t write_index = 0u;
+          for (auto idx_channel = 0u; idx_channel < points_per_channel.size(); ++idx_channel)
+          {
+            const size_t read_index = _channel_offsets[idx_channel];
+            const size_t count = points_per_channel[idx_channel];
+            if (write_index != read_index && count > 0u)
+            {
+              std::memmove(
+                  _points.data() + write_index,
+                  _points.data() + read_index,
+                  sizeof(LidarWithFogDetection) * count);
+            }
+            write_index += count;
+          }
+          _points.resize(write_index);
+          WriteChannelCount(points_per_channel);
+        }
+
       private:
         // std::vector<float> _points;
         std::vector<LidarWithFogDetection> _points;
+        std::vector<uint32_t> _channel_offsets;
         friend class s11n::LidarWithFogSerializer;
         friend class s11n::LidarWithFogHeaderView;
       };
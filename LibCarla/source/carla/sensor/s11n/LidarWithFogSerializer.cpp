@@ -8,15 +8,46 @@
 #include "carla/sensor/data/LidarWithFogMeasurement.h"
 #include "carla/sensor/s11n/LidarWithFogSerializer.h"
 
+#include <cstring>
+
 namespace carla {
 namespace sensor {
 namespace s11n {
 
   SharedPtr<SensorData> LidarWithFogSerializer::Deserialize(RawData &&data) {
+    if (DeserializeHeader(data).GetEncoding() == data::LidarWithFogEncoding::Quantized) {
+      return SharedPtr<data::LidarWithFogMeasurement>(
+          new data::LidarWithFogMeasurement{DequantizeRawData(data)});
+    }
     return SharedPtr<data::LidarWithFogMeasurement>(
         new data::LidarWithFogMeasurement{std::move(data)});
   }
 
+  RawData LidarWithFogSerializer::DequantizeRawData(const RawData &data) {
+    const auto header = DeserializeHeader(data);
+    const size_t header_size = GetHeaderOffset(data);
+    size_t count = 0u;
+    for (auto channel = 0u; channel < header.GetChannelCount(); ++channel) {
+      count += header.GetPointCount(channel);
+    }
+    DEBUG_ASSERT(data.size() == header_size + count * sizeof(data::LidarWithFogQuantizedDetection));
+
+    // Keep the sensor header and the lidar header, only the points change.
+    const size_t offset = SensorHeaderSerializer::header_offset + header_size;
+    Buffer buffer{static_cast<uint64_t>(offset + count * sizeof(data::LidarWithFogDetection))};
+    std::memcpy(buffer.data(), data._buffer.data(), offset);
+    auto *lidar_header = reinterpret_cast<uint32_t *>(buffer.data() + SensorHeaderSerializer::header_offset);
+    lidar_header[data::LidarWithFogData::Index::Encoding] =
+        static_cast<uint32_t>(data::LidarWithFogEncoding::Float32);
+    Dequantize(
+        reinterpret_cast<const data::LidarWithFogQuantizedDetection *>(data.data() + header_size),
+        count,
+        header.GetPositionScale(),
+        header.GetIntensityScale(),
+        reinterpret_cast<data::LidarWithFogDetection *>(buffer.data() + offset));
+    return RawData{std::move(buffer)};
+  }
+
 } // namespace s11n
 } // namespace sensor
 } // namespace carla
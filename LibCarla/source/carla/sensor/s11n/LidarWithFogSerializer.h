@@ -6,11 +6,17 @@
 
 #pragma once
 
+#include "carla/BufferList.h"
 #include "carla/Debug.h"
 #include "carla/Memory.h"
 #include "carla/sensor/RawData.h"
 #include "carla/sensor/data/LidarWithFogData.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
 namespace carla {
 namespace sensor {
 
@@ -35,6 +41,18 @@ namespace s11n {
       return _begin[Index::ChannelCount];
     }
 
+    data::LidarWithFogEncoding GetEncoding() const {
+      return static_cast<data::LidarWithFogEncoding>(_begin[Index::Encoding]);
+    }
+
+    float GetPositionScale() const {
+      return reinterpret_cast<const float &>(_begin[Index::PositionScale]);
+    }
+
+    float GetIntensityScale() const {
+      return reinterpret_cast<const float &>(_begin[Index::IntensityScale]);
+    }
+
     uint32_t GetPointCount(size_t channel) const {
       DEBUG_ASSERT(channel < GetChannelCount());
       return _begin[Index::SIZE + channel];
@@ -67,13 +85,49 @@ namespace s11n {
       return sizeof(uint32_t) * (View.GetChannelCount() + data::LidarWithFogData::Index::SIZE);
     }
 
+    /// The header and the points are copied to @a output. Quantized points
+    /// are written straight to @a output, after the header.
     template <typename Sensor>
-    static Buffer Serialize(
+    static BufferList Serialize(
         const Sensor &sensor,
         const data::LidarWithFogData &data,
         Buffer &&output);
 
     static SharedPtr<SensorData> Deserialize(RawData &&data);
+
+    // =========================================================================
+    /// @name Quantized encoding
+    // =========================================================================
+    /// @{
+
+    /// Positions are quantized in steps of max |coordinate| / 32767, and
+    /// intensities in steps of max intensity / 255.
+    static void ComputeQuantizationScales(
+        const data::LidarWithFogDetection *points,
+        size_t count,
+        float &position_scale,
+        float &intensity_scale);
+
+    static void Quantize(
+        const data::LidarWithFogDetection *points,
+        size_t count,
+        float position_scale,
+        float intensity_scale,
+        data::LidarWithFogQuantizedDetection *out);
+
+    static void Dequantize(
+        const data::LidarWithFogQuantizedDetection *points,
+        size_t count,
+        float position_scale,
+        float intensity_scale,
+        data::LidarWithFogDetection *out);
+
+    /// @}
+
+  private:
+
+    /// Expand the quantized points of @a data into a regular measurement.
+    static RawData DequantizeRawData(const RawData &data);
   };
 
   // ===========================================================================
@@ -81,15 +135,93 @@ namespace s11n {
   // ===========================================================================
 
   template <typename Sensor>
-  inline Buffer LidarWithFogSerializer::Serialize(
+  inline BufferList LidarWithFogSerializer::Serialize(
       const Sensor &,
       const data::LidarWithFogData &data,
       Buffer &&output) {
-    std::array<boost::asio::const_buffer, 2u> seq = {
-        boost::asio::buffer(data._header),
-        boost::asio::buffer(data._points)};
-    output.copy_from(seq);
-    return std::move(output);
+    BufferList buffers;
+    if (data.GetEncoding() != data::LidarWithFogEncoding::Quantized) {
+      std::array<boost::asio::const_buffer, 2u> seq = {
+          boost::asio::buffer(data._header),
+          boost::asio::buffer(data._points)};
+      output.copy_from(seq);
+      buffers.emplace_back(std::move(output));
+      return buffers;
+    }
+
+    const size_t header_size = sizeof(uint32_t) * data._header.size();
+    output.reset(static_cast<uint64_t>(
+        header_size + sizeof(data::LidarWithFogQuantizedDetection) * data._points.size()));
+    std::memcpy(output.data(), data._header.data(), header_size);
+
+    float position_scale;
+    float intensity_scale;
+    ComputeQuantizationScales(data._points.data(), data._points.size(), position_scale, intensity_scale);
+    auto *header = reinterpret_cast<uint32_t *>(output.data());
+    std::memcpy(&header[data::LidarWithFogData::Index::PositionScale], &position_scale, sizeof(float));
+    std::memcpy(&header[data::LidarWithFogData::Index::IntensityScale], &intensity_scale, sizeof(float));
+    Quantize(
+        data._points.data(),
+        data._points.size(),
+        position_scale,
+        intensity_scale,
+        reinterpret_cast<data::LidarWithFogQuantizedDetection *>(output.data() + header_size));
+    buffers.emplace_back(std::move(output));
+    return buffers;
+  }
+
+  inline void LidarWithFogSerializer::ComputeQuantizationScales(
+      const data::LidarWithFogDetection *points,
+      size_t count,
+      float &position_scale,
+      float &intensity_scale) {
+    float max_coordinate = 0.0f;
+    float max_intensity = 0.0f;
+    for (size_t i = 0u; i < count; ++i) {
+      const auto &point = points[i].point;
+      max_coordinate = std::max({max_coordinate, std::abs(point.x), std::abs(point.y), std::abs(point.z)});
+      max_intensity = std::max(max_intensity, points[i].intensity);
+    }
+    position_scale = max_coordinate > 0.0f ? max_coordinate / 32767.0f : 1.0f;
+    intensity_scale = max_intensity > 0.0f ? max_intensity / 255.0f : 1.0f;
+  }
+
+  inline void LidarWithFogSerializer::Quantize(
+      const data::LidarWithFogDetection *points,
+      size_t count,
+      float position_scale,
+      float intensity_scale,
+      data::LidarWithFogQuantizedDetection *out) {
+    const float position_factor = 1.0f / position_scale;
+    const float intensity_factor = 1.0f / intensity_scale;
+    auto quantize = [](float value, float factor, float min, float max) {
+      return std::min(std::max(std::round(value * factor), min), max);
+    };
+    for (size_t i = 0u; i < count; ++i) {
+      const auto &point = points[i];
+      out[i].x = static_cast<int16_t>(quantize(point.point.x, position_factor, -32767.0f, 32767.0f));
+      out[i].y = static_cast<int16_t>(quantize(point.point.y, position_factor, -32767.0f, 32767.0f));
+      out[i].z = static_cast<int16_t>(quantize(point.point.z, position_factor, -32767.0f, 32767.0f));
+      out[i].intensity = static_cast<uint8_t>(quantize(point.intensity, intensity_factor, 0.0f, 255.0f));
+      out[i].object_tag = static_cast<uint8_t>(std::min(point.object_tag, 255u));
+    }
+  }
+
+  inline void LidarWithFogSerializer::Dequantize(
+      const data::LidarWithFogQuantizedDetection *points,
+      size_t count,
+      float position_scale,
+      float intensity_scale,
+      data::LidarWithFogDetection *out) {
+    for (size_t i = 0u; i < count; ++i) {
+      const auto &point = points[i];
+      out[i] = data::LidarWithFogDetection{
+          position_scale * point.x,
+          position_scale * point.y,
+          position_scale * point.z,
+          intensity_scale * point.intensity,
+          point.object_tag};
+    }
   }
 
 } // namespace s11n
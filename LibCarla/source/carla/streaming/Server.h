@@ -69,6 +69,26 @@ namespace streaming {
       _server.SetSynchronousMode(is_synchro);
     }
 
+    /// Set the limits and overflow policies of the outbound queue of the
+    /// sessions, see detail::QueueSettings.
+    void SetQueueSettings(const detail::QueueSettings &settings) {
+      _server.SetQueueSettings(settings);
+    }
+
+    detail::QueueSettings GetQueueSettings() const {
+      return _server.GetQueueSettings();
+    }
+
+    /// Queued bytes, drops and send latency of the stream @a id.
+    detail::StreamStats GetStreamStats(detail::stream_id_type id) {
+      return _server.GetStreamStats(id);
+    }
+
+    /// Memory held and reuse of the buffer pools of all the streams.
+    BufferPool::Stats GetBufferPoolStats() {
+      return _server.GetBufferPoolStats();
+    }
+
     carla::streaming::detail::token_type GetToken(carla::streaming::detail::stream_id_type sensor_id) {
       return _server.GetToken(sensor_id);
     }
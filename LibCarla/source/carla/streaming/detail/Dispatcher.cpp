@@ -129,6 +129,29 @@ namespace detail {
     return token_type();
   }
 
+  StreamStats Dispatcher::GetStreamStats(stream_id_type id) {
+    std::shared_ptr<MultiStreamState> stream_state;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto search = _stream_map.find(id);
+      if (search != _stream_map.end()) {
+        stream_state = search->second;
+      }
+    }
+    return stream_state != nullptr ? stream_state->GetStats() : StreamStats{};
+  }
+
+  BufferPool::Stats Dispatcher::GetBufferPoolStats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    BufferPool::Stats stats;
+    for (auto &pair : _stream_map) {
+      if (pair.second != nullptr) {
+        stats += pair.second->GetBufferPool().GetStats();
+      }
+    }
+    return stats;
+  }
+
 } // namespace detail
 } // namespace streaming
 } // namespace carla
@@ -6,10 +6,12 @@
 
 #pragma once
 
+#include "carla/BufferPool.h"
 #include "carla/streaming/EndPoint.h"
 #include "carla/streaming/Stream.h"
 #include "carla/streaming/detail/Session.h"
 #include "carla/streaming/detail/Stream.h"
+#include "carla/streaming/detail/StreamStats.h"
 #include "carla/streaming/detail/Token.h"
 
 #include <memory>
@@ -43,6 +45,12 @@ namespace detail {
     
     token_type GetToken(stream_id_type sensor_id);
 
+    /// Counters of the stream @a id, all zero if there is no such stream.
+    StreamStats GetStreamStats(stream_id_type id);
+
+    /// Statistics of the buffer pools of every stream added together.
+    BufferPool::Stats GetBufferPoolStats();
+
   private:
 
     // We use a mutex here, but we assume that sessions and streams won't be
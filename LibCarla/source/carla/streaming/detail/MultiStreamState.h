@@ -9,8 +9,10 @@
 #include "carla/AtomicSharedPtr.h"
 #include "carla/Logging.h"
 #include "carla/streaming/detail/StreamStateBase.h"
+#include "carla/streaming/detail/StreamStats.h"
 #include "carla/streaming/detail/tcp/Message.h"
 
+#include <algorithm>
 #include <mutex>
 #include <vector>
 #include <atomic>
@@ -45,11 +47,16 @@ namespace detail {
         return; 
       }
 
-      // try write multiple stream
-      std::lock_guard<std::mutex> lock(_mutex);
-      if (_sessions.size() > 0) {
+      // try write multiple stream, outside the lock since a session may block
+      // waiting for space in its queue
+      std::vector<std::shared_ptr<Session>> sessions;
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        sessions = _sessions;
+      }
+      if (sessions.size() > 0) {
         auto message = Session::MakeMessage(std::move(buffers)...);
-        for (auto &s : _sessions) {
+        for (auto &s : sessions) {
           if (s != nullptr) {
             s->Write(message);
             log_debug("sensor ", s->get_stream_id()," data sent ");
@@ -84,6 +91,9 @@ namespace detail {
       std::lock_guard<std::mutex> lock(_mutex);
       log_debug("Calling DisconnectSession for ", session->get_stream_id());
       if (_sessions.size() == 0) return;
+      if (std::find(_sessions.begin(), _sessions.end(), session) != _sessions.end()) {
+        AccumulateStats(*session);
+      }
       if (_sessions.size() == 1) {
         DEBUG_ASSERT(session == _session.load());
         _session.store(nullptr);
@@ -109,6 +119,7 @@ namespace detail {
       for (auto &s : _sessions) {
         if (s != nullptr) {
           s->Close();
+          AccumulateStats(*s);
         }
       }
       _sessions.clear();
@@ -117,8 +128,31 @@ namespace detail {
       log_debug("Disconnecting all multistream sessions");
     }
 
+    /// Counters of the messages written to this stream, including the
+    /// sessions already closed.
+    StreamStats GetStats() {
+      std::lock_guard<std::mutex> lock(_mutex);
+      StreamStats stats = _closed_sessions_stats;
+      for (auto &s : _sessions) {
+        if (s != nullptr) {
+          stats += s->GetStats();
+        }
+      }
+      return stats;
+    }
+
   private:
 
+    void AccumulateStats(const Session &session) {
+      auto stats = session.GetStats();
+      // Whatever is still queued is never going to be sent.
+      stats.dropped_messages += stats.queued_messages;
+      stats.dropped_bytes += stats.queued_bytes;
+      stats.queued_messages = 0u;
+      stats.queued_bytes = 0u;
+      _closed_sessions_stats += stats;
+    }
+
     std::mutex _mutex;
 
     // if there is only one session, then we use atomic
@@ -126,6 +160,8 @@ namespace detail {
     // if there are more than one session, we use vector of sessions with mutex
     std::vector<std::shared_ptr<Session>> _sessions;
     bool _force_active {false};
+
+    StreamStats _closed_sessions_stats;
   };
 
 } // namespace detail
@@ -0,0 +1,58 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace carla {
+namespace streaming {
+namespace detail {
+
+  /// What a session does with a new message when its outbound queue is full.
+  enum class OverflowPolicy : uint8_t {
+    /// Block the writer until the client catches up, or the session times out.
+    Block,
+    /// Discard the oldest message waiting in the queue.
+    DropOldest,
+    /// Discard the new message.
+    DropNewest,
+    /// Replace every message waiting in the queue with the new one, a slow
+    /// client always receives the latest data available.
+    CoalesceLatest
+  };
+
+  /// Limits of the outbound queue of each session and policy applied when
+  /// they are reached. A message being sent does not count against the
+  /// limits.
+  struct QueueLimits {
+    OverflowPolicy policy;
+
+    size_t max_queued_messages;
+
+    /// Zero for no limit in bytes.
+    size_t max_queued_bytes;
+  };
+
+  /// Queue limits of the server in each mode.
+  struct QueueSettings {
+    /// The simulation waits for slow clients, with a few messages queued so
+    /// that a write is always ready when the previous one finishes.
+    QueueLimits synchronous = {OverflowPolicy::Block, 8u, 0u};
+
+    /// A slow client never delays the simulation and receives at most one
+    /// message behind the one being sent, always the latest.
+    QueueLimits asynchronous = {OverflowPolicy::CoalesceLatest, 1u, 0u};
+
+    const QueueLimits &GetLimits(bool synchronous_mode) const {
+      return synchronous_mode ? synchronous : asynchronous;
+    }
+  };
+
+} // namespace detail
+} // namespace streaming
+} // namespace carla
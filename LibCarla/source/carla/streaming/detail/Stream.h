@@ -46,7 +46,9 @@ namespace detail {
       return _shared_state->MakeBuffer();
     }
 
-    /// Flush @a buffers down the stream. No copies are made.
+    /// Flush @a buffers down the stream. No copies are made. Accepts any
+    /// number of Buffer and BufferList objects, the client receives them
+    /// concatenated.
     template <typename... Buffers>
     void Write(Buffers &&... buffers) {
       _shared_state->Write(std::move(buffers)...);
@@ -34,6 +34,10 @@ namespace detail {
 
     Buffer MakeBuffer();
 
+    const BufferPool &GetBufferPool() const {
+      return *_buffer_pool;
+    }
+
     virtual void ConnectSession(std::shared_ptr<Session> session) = 0;
 
     virtual void DisconnectSession(std::shared_ptr<Session> session) = 0;
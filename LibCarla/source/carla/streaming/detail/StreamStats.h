@@ -0,0 +1,58 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+namespace carla {
+namespace streaming {
+namespace detail {
+
+  /// Counters of the outbound traffic of a stream, summed over its sessions.
+  /// Send latency is measured from the moment a message is queued until it is
+  /// written to the socket or to shared memory.
+  struct StreamStats {
+    uint64_t queued_messages = 0u;
+
+    uint64_t queued_bytes = 0u;
+
+    uint64_t sent_messages = 0u;
+
+    uint64_t sent_bytes = 0u;
+
+    uint64_t dropped_messages = 0u;
+
+    uint64_t dropped_bytes = 0u;
+
+    uint64_t last_latency_us = 0u;
+
+    uint64_t max_latency_us = 0u;
+
+    uint64_t total_latency_us = 0u;
+
+    uint64_t GetAverageLatency() const {
+      return sent_messages > 0u ? total_latency_us / sent_messages : 0u;
+    }
+
+    StreamStats &operator+=(const StreamStats &rhs) {
+      queued_messages += rhs.queued_messages;
+      queued_bytes += rhs.queued_bytes;
+      sent_messages += rhs.sent_messages;
+      sent_bytes += rhs.sent_bytes;
+      dropped_messages += rhs.dropped_messages;
+      dropped_bytes += rhs.dropped_bytes;
+      last_latency_us = std::max(last_latency_us, rhs.last_latency_us);
+      max_latency_us = std::max(max_latency_us, rhs.max_latency_us);
+      total_latency_us += rhs.total_latency_us;
+      return *this;
+    }
+  };
+
+} // namespace detail
+} // namespace streaming
+} // namespace carla
@@ -0,0 +1,403 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/streaming/detail/shm/SharedMemoryRing.h"
+
+#include "carla/Debug.h"
+#include "carla/Logging.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#ifdef __linux__
+#  include <cerrno>
+#  include <fcntl.h>
+#  include <linux/futex.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <sys/syscall.h>
+#  include <time.h>
+#  include <unistd.h>
+#endif // __linux__
+
+namespace carla {
+namespace streaming {
+namespace detail {
+namespace shm {
+
+  // ===========================================================================
+  // -- Header -----------------------------------------------------------------
+  // ===========================================================================
+
+  /// Lives at the beginning of the mapping, shared by both processes. Each
+  /// side only writes its own cache line.
+  struct SharedMemoryRing::Header {
+    static constexpr uint32_t MAGIC = 0x4d485343u; // "CSHM"
+
+    static constexpr uint32_t VERSION = 1u;
+
+    uint32_t magic = MAGIC;
+
+    uint32_t version = VERSION;
+
+    uint64_t capacity = 0u;
+
+    /// Producer side.
+    alignas(64) std::atomic<uint64_t> write_position{0u};
+
+    std::atomic<uint32_t> data_signal{0u};
+
+    std::atomic<uint32_t> data_waiters{0u};
+
+    /// Consumer side.
+    alignas(64) std::atomic<uint64_t> read_position{0u};
+
+    std::atomic<uint32_t> space_signal{0u};
+
+    std::atomic<uint32_t> space_waiters{0u};
+
+    alignas(64) std::atomic<uint32_t> closed{0u};
+  };
+
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "Invalid futex word.");
+  static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Shared atomics must be lock-free.");
+
+  /// Data starts on its own page.
+  static constexpr size_t HEADER_SIZE = 4096u;
+
+  /// Time slice of the futex waits, so closing is noticed even if the other
+  /// side dies without waking us up.
+  static constexpr auto WAIT_SLICE = std::chrono::milliseconds(100);
+
+  // ===========================================================================
+  // -- Futex ------------------------------------------------------------------
+  // ===========================================================================
+
+#ifdef __linux__
+
+  static uint32_t *AsFutex(std::atomic<uint32_t> &word) {
+    return reinterpret_cast<uint32_t *>(&word);
+  }
+
+  static void FutexWait(std::atomic<uint32_t> &word, uint32_t expected, std::chrono::milliseconds timeout) {
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+    ts.tv_nsec = static_cast<long>((timeout.count() % 1000) * 1000000);
+    // Not FUTEX_PRIVATE_FLAG, the word is shared between processes.
+    ::syscall(SYS_futex, AsFutex(word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+  }
+
+  static void FutexWakeAll(std::atomic<uint32_t> &word) {
+    ::syscall(SYS_futex, AsFutex(word), FUTEX_WAKE, std::numeric_limits<int>::max(), nullptr, nullptr, 0);
+  }
+
+#else
+
+  static void FutexWait(std::atomic<uint32_t> &, uint32_t, std::chrono::milliseconds) {}
+
+  static void FutexWakeAll(std::atomic<uint32_t> &) {}
+
+#endif // __linux__
+
+  /// Wait until @a condition holds, blocking on @a signal while it does not.
+  /// Returns false if @a timeout expires or the ring is closed first.
+  template <typename ConditionT>
+  static bool WaitFor(
+      std::atomic<uint32_t> &signal,
+      std::atomic<uint32_t> &waiters,
+      const std::atomic<uint32_t> &closed,
+      std::chrono::milliseconds timeout,
+      ConditionT &&condition) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (;;) {
+      const auto seen = signal.load();
+      if (condition()) {
+        return true;
+      }
+      const auto now = std::chrono::steady_clock::now();
+      if ((closed.load() != 0u) || (now >= deadline)) {
+        return false;
+      }
+      ++waiters;
+      // Check again now that the other side knows we are waiting.
+      if (!condition()) {
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+        FutexWait(signal, seen, std::min(std::max(remaining, std::chrono::milliseconds(1)), WAIT_SLICE));
+      }
+      --waiters;
+    }
+  }
+
+  static void Notify(std::atomic<uint32_t> &signal, std::atomic<uint32_t> &waiters) {
+    ++signal;
+    if (waiters.load() > 0u) {
+      FutexWakeAll(signal);
+    }
+  }
+
+  // ===========================================================================
+  // -- SharedMemoryRing -------------------------------------------------------
+  // ===========================================================================
+
+  constexpr stream_id_type SharedMemoryRing::request_flag;
+  constexpr message_size_type SharedMemoryRing::redirect_marker;
+  constexpr size_t SharedMemoryRing::min_capacity;
+  constexpr size_t SharedMemoryRing::max_capacity;
+
+  bool SharedMemoryRing::IsSupported() {
+#ifdef __linux__
+    const char *value = std::getenv("CARLA_STREAMING_SHARED_MEMORY");
+    return (value == nullptr) || (std::strcmp(value, "0") != 0);
+#else
+    return false;
+#endif // __linux__
+  }
+
+  size_t SharedMemoryRing::CapacityFor(const size_t size) {
+    size_t capacity = min_capacity;
+    while (capacity < 2u * size) {
+      capacity *= 2u;
+    }
+    return capacity <= max_capacity ? capacity : 0u;
+  }
+
+  std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Create(std::string name, const size_t capacity) {
+#ifdef __linux__
+    DEBUG_ASSERT(capacity > 0u);
+    DEBUG_ASSERT((capacity & (capacity - 1u)) == 0u);
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+      log_warning("shared memory: failed to create", name, ':', std::strerror(errno));
+      return nullptr;
+    }
+    const size_t mapped_size = HEADER_SIZE + capacity;
+    // Reserve the pages now, a full /dev/shm would raise SIGBUS on write.
+    const int error = ::posix_fallocate(fd, 0, static_cast<off_t>(mapped_size));
+    void *mapping = (error == 0) ?
+        ::mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) :
+        MAP_FAILED;
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+      log_warning("shared memory: failed to allocate", mapped_size, "bytes for", name, ':',
+          std::strerror(error != 0 ? error : errno));
+      ::shm_unlink(name.c_str());
+      return nullptr;
+    }
+    auto *header = new (mapping) Header;
+    header->capacity = capacity;
+    return std::unique_ptr<SharedMemoryRing>(
+        new SharedMemoryRing(std::move(name), mapping, mapped_size, true));
+#else
+    (void) name;
+    (void) capacity;
+    return nullptr;
+#endif // __linux__
+  }
+
+  std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Open(const std::string &name) {
+#ifdef __linux__
+    const int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+      log_warning("shared memory: failed to open", name, ':', std::strerror(errno));
+      return nullptr;
+    }
+    ::shm_unlink(name.c_str());
+    struct stat info;
+    void *mapping = MAP_FAILED;
+    size_t mapped_size = 0u;
+    if ((::fstat(fd, &info) == 0) && (static_cast<size_t>(info.st_size) > HEADER_SIZE)) {
+      mapped_size = static_cast<size_t>(info.st_size);
+      mapping = ::mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+      log_warning("shared memory: failed to map", name);
+      return nullptr;
+    }
+    const auto *header = static_cast<const Header *>(mapping);
+    if ((header->magic != Header::MAGIC) ||
+        (header->version != Header::VERSION) ||
+        (HEADER_SIZE + header->capacity != mapped_size) ||
+        ((header->capacity & (header->capacity - 1u)) != 0u)) {
+      log_warning("shared memory: invalid ring", name);
+      ::munmap(mapping, mapped_size);
+      return nullptr;
+    }
+    return std::unique_ptr<SharedMemoryRing>(
+        new SharedMemoryRing(name, mapping, mapped_size, false));
+#else
+    (void) name;
+    return nullptr;
+#endif // __linux__
+  }
+
+  SharedMemoryRing::SharedMemoryRing(
+      std::string name,
+      void *mapping,
+      const size_t mapped_size,
+      const bool is_owner)
+    : _name(std::move(name)),
+      _mapping(mapping),
+      _mapped_size(mapped_size),
+      _header(*static_cast<Header *>(mapping)),
+      _data(static_cast<unsigned char *>(mapping) + HEADER_SIZE),
+      _capacity(static_cast<size_t>(_header.capacity)),
+      _is_owner(is_owner) {
+    static_assert(sizeof(Header) <= HEADER_SIZE, "Header too big.");
+  }
+
+  SharedMemoryRing::~SharedMemoryRing() {
+#ifdef __linux__
+    if (_is_owner) {
+      // Fails if the consumer already opened it, that is fine.
+      ::shm_unlink(_name.c_str());
+    }
+    ::munmap(_mapping, _mapped_size);
+#endif // __linux__
+  }
+
+  size_t SharedMemoryRing::GetPendingBytes() const {
+    return static_cast<size_t>(
+        _header.write_position.load(std::memory_order_relaxed) -
+        _header.read_position.load(std::memory_order_relaxed));
+  }
+
+  bool SharedMemoryRing::WriteRedirect(const std::string &name, const time_duration timeout) {
+    const message_size_type header[] = {
+        redirect_marker,
+        static_cast<message_size_type>(name.size())};
+    uint64_t position;
+    if (!Reserve(sizeof(header) + name.size(), timeout, position)) {
+      return false;
+    }
+    CopyIn(position, header, sizeof(header));
+    CopyIn(position + sizeof(header), name.data(), name.size());
+    Commit(position + sizeof(header) + name.size());
+    return true;
+  }
+
+  SharedMemoryRing::ReadResult SharedMemoryRing::Read(
+      Buffer &buffer,
+      std::string &redirect,
+      const time_duration timeout) {
+    const uint64_t position = _header.read_position.load(std::memory_order_relaxed);
+    uint64_t write_position = position;
+    const bool has_data = WaitFor(
+        _header.data_signal,
+        _header.data_waiters,
+        _header.closed,
+        timeout.to_chrono(),
+        [&]() {
+          write_position = _header.write_position.load(std::memory_order_acquire);
+          return write_position != position;
+        });
+    if (!has_data) {
+      return IsClosed() ? ReadResult::Closed : ReadResult::Timeout;
+    }
+    // The other process is not trusted, a record must lie within the span
+    // committed by the producer, itself no larger than the ring.
+    const uint64_t readable = write_position - position;
+    const auto fits = [&](const uint64_t record_size) {
+      return (readable <= _capacity) && (record_size <= readable);
+    };
+    message_size_type size;
+    if (!fits(sizeof(size))) {
+      return Corrupted();
+    }
+    CopyOut(position, &size, sizeof(size));
+    uint64_t next = position + sizeof(size);
+    ReadResult result = ReadResult::Message;
+    if (size == redirect_marker) {
+      message_size_type name_size;
+      if (!fits(2u * sizeof(size))) {
+        return Corrupted();
+      }
+      CopyOut(next, &name_size, sizeof(name_size));
+      if (!fits(uint64_t(2u * sizeof(size)) + name_size)) {
+        return Corrupted();
+      }
+      next += sizeof(name_size);
+      redirect.resize(name_size);
+      CopyOut(next, &redirect[0u], name_size);
+      next += name_size;
+      result = ReadResult::Redirect;
+    } else {
+      if (!fits(uint64_t(sizeof(size)) + size)) {
+        return Corrupted();
+      }
+      buffer.reset(size);
+      CopyOut(next, buffer.data(), size);
+      next += size;
+    }
+    _header.read_position.store(next, std::memory_order_release);
+    Notify(_header.space_signal, _header.space_waiters);
+    return result;
+  }
+
+  void SharedMemoryRing::Close() {
+    _header.closed = 1u;
+    ++_header.data_signal;
+    ++_header.space_signal;
+    FutexWakeAll(_header.data_signal);
+    FutexWakeAll(_header.space_signal);
+  }
+
+  bool SharedMemoryRing::IsClosed() const {
+    return _header.closed.load() != 0u;
+  }
+
+  SharedMemoryRing::ReadResult SharedMemoryRing::Corrupted() {
+    log_error("shared memory: invalid record in", _name, ", closing the ring");
+    Close();
+    return ReadResult::Closed;
+  }
+
+  bool SharedMemoryRing::Reserve(const size_t size, const time_duration timeout, uint64_t &position) {
+    if ((size > _capacity) || IsClosed()) {
+      return false;
+    }
+    position = _header.write_position.load(std::memory_order_relaxed);
+    const auto has_space = [&]() {
+      const auto used = position - _header.read_position.load(std::memory_order_acquire);
+      return (_capacity - used) >= size;
+    };
+    return WaitFor(
+        _header.space_signal,
+        _header.space_waiters,
+        _header.closed,
+        timeout.to_chrono(),
+        has_space);
+  }
+
+  void SharedMemoryRing::Commit(const uint64_t position) {
+    _header.write_position.store(position, std::memory_order_release);
+    Notify(_header.data_signal, _header.data_waiters);
+  }
+
+  void SharedMemoryRing::CopyIn(const uint64_t position, const void *data, const size_t size) {
+    const auto offset = static_cast<size_t>(position & (_capacity - 1u));
+    const auto first = std::min(size, _capacity - offset);
+    const auto *source = static_cast<const unsigned char *>(data);
+    std::memcpy(_data + offset, source, first);
+    std::memcpy(_data, source + first, size - first);
+  }
+
+  void SharedMemoryRing::CopyOut(const uint64_t position, void *data, const size_t size) const {
+    const auto offset = static_cast<size_t>(position & (_capacity - 1u));
+    const auto first = std::min(size, _capacity - offset);
+    auto *destination = static_cast<unsigned char *>(data);
+    std::memcpy(destination, _data + offset, first);
+    std::memcpy(destination + first, _data, size - first);
+  }
+
+} // namespace shm
+} // namespace detail
+} // namespace streaming
+} // namespace carla
@@ -0,0 +1,157 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Buffer.h"
+#include "carla/NonCopyable.h"
+#include "carla/Time.h"
+#include "carla/streaming/detail/Types.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+
+namespace carla {
+namespace streaming {
+namespace detail {
+namespace shm {
+
+  /// Single-producer single-consumer byte ring in POSIX shared memory, used to
+  /// deliver the messages of a stream to a client running on the same host.
+  /// Messages keep the framing of the TCP sessions, the size of the message
+  /// followed by its data. Both sides block on a futex living in the ring.
+  ///
+  /// Only available on Linux, elsewhere Create and Open always fail and the
+  /// sessions keep streaming through the socket.
+  class SharedMemoryRing : private NonCopyable {
+  public:
+
+    /// Set in the stream id sent by a client to request a shared memory ring
+    /// instead of receiving the messages through the socket.
+    static constexpr stream_id_type request_flag = 1u << 31;
+
+    /// Message size that tells the consumer to continue reading from another
+    /// ring, whose name follows.
+    static constexpr message_size_type redirect_marker =
+        std::numeric_limits<message_size_type>::max();
+
+    static constexpr size_t min_capacity = 4u << 20;
+
+    static constexpr size_t max_capacity = 1u << 30;
+
+    enum class ReadResult {
+      Message,
+      Redirect,
+      Timeout,
+      Closed
+    };
+
+    /// Whether shared memory is available on this platform and has not been
+    /// disabled with the environment variable CARLA_STREAMING_SHARED_MEMORY=0.
+    static bool IsSupported();
+
+    /// Smallest capacity able to hold two messages of @a size bytes (header
+    /// included), or zero if such a ring would exceed max_capacity.
+    static size_t CapacityFor(size_t size);
+
+    /// Create a new ring named @a name. Returns nullptr on failure.
+    static std::unique_ptr<SharedMemoryRing> Create(std::string name, size_t capacity);
+
+    /// Open the ring created by another process and remove its name, the
+    /// memory is released once both sides unmap it. Returns nullptr on failure.
+    static std::unique_ptr<SharedMemoryRing> Open(const std::string &name);
+
+    ~SharedMemoryRing();
+
+    const std::string &GetName() const {
+      return _name;
+    }
+
+    size_t GetCapacity() const {
+      return _capacity;
+    }
+
+    /// Whether a message of @a size bytes (header included) leaves room in
+    /// the ring for the next one.
+    bool Fits(size_t size) const {
+      return 2u * size <= _capacity;
+    }
+
+    /// Bytes written by the producer and not yet read by the consumer.
+    size_t GetPendingBytes() const;
+
+    /// Copy @a buffers into the ring as a single record. If there is no space
+    /// left, waits up to @a timeout for the consumer to free enough, then
+    /// returns false. Also returns false if the ring is closed.
+    template <typename ConstBufferSequence>
+    bool Write(const ConstBufferSequence &buffers, time_duration timeout) {
+      size_t size = 0u;
+      for (const auto &buffer : buffers) {
+        size += buffer.size();
+      }
+      uint64_t position;
+      if (!Reserve(size, timeout, position)) {
+        return false;
+      }
+      for (const auto &buffer : buffers) {
+        CopyIn(position, buffer.data(), buffer.size());
+        position += buffer.size();
+      }
+      Commit(position);
+      return true;
+    }
+
+    /// Tell the consumer to continue reading from the ring named @a name.
+    bool WriteRedirect(const std::string &name, time_duration timeout);
+
+    /// Read the next record. A message is stored in @a buffer, and the name of
+    /// the next ring in @a redirect. A record that does not fit in the data
+    /// committed by the producer closes the ring.
+    ReadResult Read(Buffer &buffer, std::string &redirect, time_duration timeout);
+
+    /// Wake up and fail any pending or future Write and Read on both sides.
+    void Close();
+
+    bool IsClosed() const;
+
+  private:
+
+    struct Header;
+
+    SharedMemoryRing(std::string name, void *mapping, size_t mapped_size, bool is_owner);
+
+    bool Reserve(size_t size, time_duration timeout, uint64_t &position);
+
+    void Commit(uint64_t position);
+
+    /// Close the ring after reading an invalid record.
+    ReadResult Corrupted();
+
+    void CopyIn(uint64_t position, const void *data, size_t size);
+
+    void CopyOut(uint64_t position, void *data, size_t size) const;
+
+    const std::string _name;
+
+    void *const _mapping;
+
+    const size_t _mapped_size;
+
+    Header &_header;
+
+    unsigned char *const _data;
+
+    const size_t _capacity;
+
+    const bool _is_owner;
+  };
+
+} // namespace shm
+} // namespace detail
+} // namespace streaming
+} // namespace carla
@@ -76,13 +76,16 @@ namespace tcp {
       _socket(io_context),
       _strand(io_context),
       _connection_timer(io_context),
-      _buffer_pool(std::make_shared<BufferPool>()) {
+      _buffer_pool(std::make_shared<BufferPool>()),
+      _use_shared_memory(shm::SharedMemoryRing::IsSupported()) {
     if (!_token.protocol_is_tcp()) {
       throw_exception(std::invalid_argument("invalid token, only TCP tokens supported"));
     }
   }
 
-  Client::~Client() = default;
+  Client::~Client() {
+    StopSharedMemoryReader();
+  }
 
   void Client::Connect() {
     auto self = shared_from_this();
@@ -93,6 +96,8 @@ namespace tcp {
 
       using boost::system::error_code;
 
+      StopSharedMemoryReader();
+
       if (_socket.is_open()) {
         _socket.close();
       }
@@ -110,21 +115,30 @@ namespace tcp {
           // Improves the sync mode velocity on Linux by a factor of ~3.
           _socket.set_option(boost::asio::ip::tcp::no_delay(true));
           log_debug("streaming client: connected to", ep);
-          // Send the stream id to subscribe to the stream.
-          const auto &stream_id = _token.get_stream_id();
-          log_debug("streaming client: sending stream id", stream_id);
+          // Send the stream id to subscribe to the stream, flagged to ask for
+          // shared memory if the server runs on this host.
+          const bool use_shared_memory = _use_shared_memory && IsLocalServer();
+          _requested_stream_id = _token.get_stream_id();
+          if (use_shared_memory) {
+            _requested_stream_id |= shm::SharedMemoryRing::request_flag;
+          }
+          log_debug("streaming client: sending stream id", _token.get_stream_id());
           boost::asio::async_write(
               _socket,
-              boost::asio::buffer(&stream_id, sizeof(stream_id)),
+              boost::asio::buffer(&_requested_stream_id, sizeof(_requested_stream_id)),
               boost::asio::bind_executor(_strand, [=](error_code ec, size_t DEBUG_ONLY(bytes)) {
                 // Ensures to stop the execution once the connection has been stopped.
                 if (_done) {
                   return;
                 }
                 if (!ec) {
-                  DEBUG_ASSERT_EQ(bytes, sizeof(stream_id));
+                  DEBUG_ASSERT_EQ(bytes, sizeof(_requested_stream_id));
                   // If succeeded start reading data.
-                  ReadData();
+                  if (use_shared_memory) {
+                    ReadSharedMemoryName();
+                  } else {
+                    ReadData();
+                  }
                 } else {
                   // Else try again.
                   log_debug("streaming client: failed to send stream id:", ec.message());
@@ -144,6 +158,8 @@ namespace tcp {
 
   void Client::Stop() {
     _connection_timer.cancel();
+    _done = true;
+    StopSharedMemoryReader();
     auto self = shared_from_this();
     boost::asio::post(_strand, [this, self]() {
       _done = true;
@@ -222,6 +238,155 @@ namespace tcp {
     });
   }
 
+  bool Client::IsLocalServer() const {
+    boost::system::error_code remote_ec;
+    boost::system::error_code local_ec;
+    const auto remote = _socket.remote_endpoint(remote_ec).address();
+    const auto local = _socket.local_endpoint(local_ec).address();
+    return !remote_ec && !local_ec && (remote.is_loopback() || (remote == local));
+  }
+
+  void Client::ReadSharedMemoryName() {
+    auto self = shared_from_this();
+
+    auto handle_read_name = [this, self](const std::shared_ptr<std::string> &name) {
+      return [this, self, name](boost::system::error_code ec, size_t) {
+        if (_done) {
+          return;
+        }
+        if (!ec) {
+          OpenSharedMemory(*name);
+        } else {
+          log_debug("streaming client: failed to read shared memory name:", ec.message());
+          Connect();
+        }
+      };
+    };
+
+    auto handle_read_size = [this, self, handle_read_name](boost::system::error_code ec, size_t) {
+      if (_done) {
+        return;
+      }
+      if (ec) {
+        // Most likely a server without shared memory support that did not
+        // recognize the stream id, use the socket from now on.
+        log_info("streaming client: shared memory not available:", ec.message());
+        _use_shared_memory = false;
+        Connect();
+      } else if (_shared_memory_name_size == 0u) {
+        // The server prefers the socket.
+        ReadData();
+      } else {
+        auto name = std::make_shared<std::string>(_shared_memory_name_size, '\0');
+        boost::asio::async_read(
+            _socket,
+            boost::asio::buffer(&(*name)[0u], name->size()),
+            boost::asio::bind_executor(_strand, handle_read_name(name)));
+      }
+    };
+
+    boost::asio::async_read(
+        _socket,
+        boost::asio::buffer(&_shared_memory_name_size, sizeof(_shared_memory_name_size)),
+        boost::asio::bind_executor(_strand, handle_read_size));
+  }
+
+  void Client::OpenSharedMemory(const std::string &name) {
+    auto ring = shm::SharedMemoryRing::Open(name);
+    if (ring == nullptr) {
+      _use_shared_memory = false;
+      Connect();
+      return;
+    }
+    log_debug("streaming client: reading from shared memory", name);
+    {
+      std::lock_guard<std::mutex> lock(_shared_memory_mutex);
+      if (_done) {
+        return;
+      }
+      _stop_shared_memory_reader = false;
+      _shared_memory = std::move(ring);
+      _shared_memory_reader = std::thread([this, self=shared_from_this()]() { ReadSharedMemory(); });
+    }
+    WatchSocket();
+  }
+
+  void Client::ReadSharedMemory() {
+    auto self = shared_from_this();
+    std::shared_ptr<shm::SharedMemoryRing> ring;
+    {
+      std::lock_guard<std::mutex> lock(_shared_memory_mutex);
+      ring = _shared_memory;
+    }
+    if (ring == nullptr) {
+      return; // Already stopped.
+    }
+    std::string redirect;
+    while (!_done && !_stop_shared_memory_reader) {
+      auto message = std::make_shared<Buffer>(_buffer_pool->Pop());
+      using Result = shm::SharedMemoryRing::ReadResult;
+      switch (ring->Read(*message, redirect, time_duration::milliseconds(100u))) {
+        case Result::Message:
+          boost::asio::post(_strand, [self, message]() { self->_callback(std::move(*message)); });
+          break;
+        case Result::Redirect: {
+          std::lock_guard<std::mutex> lock(_shared_memory_mutex);
+          ring = _shared_memory = shm::SharedMemoryRing::Open(redirect);
+          if (ring == nullptr) {
+            boost::asio::post(_strand, [self]() {
+              self->_use_shared_memory = false;
+              self->Connect();
+            });
+            return;
+          }
+          break;
+        }
+        case Result::Timeout:
+          break;
+        case Result::Closed:
+          // The session is closing, WatchSocket reconnects.
+          return;
+      }
+    }
+    ring->Close();
+  }
+
+  void Client::WatchSocket() {
+    auto self = shared_from_this();
+    boost::asio::async_read(
+        _socket,
+        boost::asio::buffer(&_watch_byte, sizeof(_watch_byte)),
+        boost::asio::bind_executor(_strand, [this, self](boost::system::error_code ec, size_t) {
+          // Aborted only when we close the socket ourselves.
+          if (!_done && (ec != boost::asio::error::operation_aborted)) {
+            log_debug("streaming client: shared memory session closed:", ec.message());
+            Connect();
+          }
+        }));
+  }
+
+  void Client::StopSharedMemoryReader() {
+    std::thread reader;
+    std::shared_ptr<shm::SharedMemoryRing> ring;
+    {
+      std::lock_guard<std::mutex> lock(_shared_memory_mutex);
+      reader = std::move(_shared_memory_reader);
+      ring = std::move(_shared_memory);
+    }
+    _stop_shared_memory_reader = true;
+    if (ring != nullptr) {
+      // Wakes up the reader, and tells the session we are leaving.
+      ring->Close();
+    }
+    if (reader.joinable()) {
+      if (reader.get_id() == std::this_thread::get_id()) {
+        reader.detach();
+      } else {
+        reader.join();
+      }
+    }
+  }
+
 } // namespace tcp
 } // namespace detail
 } // namespace streaming
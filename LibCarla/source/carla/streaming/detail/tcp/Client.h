@@ -11,6 +11,7 @@
 #include "carla/profiler/LifetimeProfiled.h"
 #include "carla/streaming/detail/Token.h"
 #include "carla/streaming/detail/Types.h"
+#include "carla/streaming/detail/shm/SharedMemoryRing.h"
 
 #include <boost/asio/deadline_timer.hpp>
 #include <boost/asio/io_context.hpp>
@@ -20,6 +21,9 @@
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 
 namespace carla {
 
@@ -31,6 +35,11 @@ namespace tcp {
 
   /// A client that connects to a single stream.
   ///
+  /// If the server runs on the same host, the client asks for the messages to
+  /// be delivered through shared memory, see shm::SharedMemoryRing, and reads
+  /// them from a dedicated thread. Otherwise, or if the server does not
+  /// support it, the messages are read from the socket.
+  ///
   /// @warning This client should be stopped before releasing the shared pointer
   /// or won't be destroyed.
   class Client
@@ -64,6 +73,21 @@ namespace tcp {
 
     void ReadData();
 
+    bool IsLocalServer() const;
+
+    /// Read the name of the shared memory ring sent by the server.
+    void ReadSharedMemoryName();
+
+    void OpenSharedMemory(const std::string &name);
+
+    void ReadSharedMemory();
+
+    /// Wait for the server to close the socket while reading from shared
+    /// memory.
+    void WatchSocket();
+
+    void StopSharedMemoryReader();
+
     const token_type _token;
 
     callback_function_type _callback;
@@ -77,6 +101,22 @@ namespace tcp {
     std::shared_ptr<BufferPool> _buffer_pool;
 
     std::atomic_bool _done{false};
+
+    bool _use_shared_memory;
+
+    stream_id_type _requested_stream_id = 0u;
+
+    message_size_type _shared_memory_name_size = 0u;
+
+    unsigned char _watch_byte = 0u;
+
+    std::mutex _shared_memory_mutex;
+
+    std::thread _shared_memory_reader;
+
+    std::shared_ptr<shm::SharedMemoryRing> _shared_memory;
+
+    std::atomic_bool _stop_shared_memory_reader{false};
   };
 
 } // namespace tcp
@@ -8,57 +8,55 @@
 
 #include "carla/ListView.h"
 #include "carla/Buffer.h"
+#include "carla/BufferList.h"
 #include "carla/Debug.h"
 #include "carla/NonCopyable.h"
 #include "carla/streaming/detail/Types.h"
 
 #include <boost/asio/buffer.hpp>
 
-#include <array>
 #include <exception>
 #include <limits>
 #include <memory>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 namespace carla {
 namespace streaming {
 namespace detail {
 namespace tcp {
 
-  /// Serialization of a set of buffers to be sent over a TCP socket as a single
-  /// message. Template paramenter @a MaxNumberOfBuffers imposes a compile-time
-  /// limit on the maximum number of buffers that can be included in a single
-  /// message.
-  template <size_t MaxNumberOfBuffers>
-  class MessageTmpl
-    : public std::enable_shared_from_this<MessageTmpl<MaxNumberOfBuffers>>,
-      private NonCopyable {
-  public:
-
-    static constexpr size_t max_size() {
-      return MaxNumberOfBuffers;
-    }
-
-  private:
+  /// Whether every type in @a Ts is either Buffer or BufferList.
+  template <typename... Ts>
+  struct are_message_buffers : std::true_type {};
 
-    MessageTmpl(size_t) {}
-
-    template <typename... Buffers>
-    MessageTmpl(size_t size, Buffer &&buffer, Buffers &&... buffers)
-      : MessageTmpl(size, std::move(buffers)...) {
-      ++_number_of_buffers;
-      _total_size += buffer.size();
-      _buffer_views[1u + size - _number_of_buffers] = buffer.cbuffer();
-      _buffers[size - _number_of_buffers] = std::move(buffer);
-    }
+  template <typename T, typename... Ts>
+  struct are_message_buffers<T, Ts...>
+    : std::integral_constant<bool,
+          (std::is_same<T, Buffer>::value || std::is_same<T, BufferList>::value) &&
+          are_message_buffers<Ts...>::value> {};
 
+  /// Serialization of a set of buffers to be sent over a TCP socket as a single
+  /// message. The buffers are written one after the other preceded by the
+  /// total size, without copying them. Arguments can be any number of Buffer
+  /// and BufferList objects, empty buffers are skipped.
+  class Message
+    : public std::enable_shared_from_this<Message>,
+      private NonCopyable {
   public:
 
     template <typename... Buffers>
-    MessageTmpl(Buffer &&buf, Buffers &&... buffers)
-      : MessageTmpl(sizeof...(Buffers) + 1u, std::move(buf), std::move(buffers)...) {
-      static_assert(sizeof...(Buffers) < max_size(), "Too many buffers!");
-      _buffer_views[0u] = boost::asio::buffer(&_total_size, sizeof(_total_size));
+    explicit Message(Buffers &&... buffers) {
+      static_assert(sizeof...(Buffers) > 0u, "A message needs at least one buffer!");
+      _buffers.reserve(CountBuffers(buffers...));
+      using expand = int[];
+      (void)expand{0, (Append(std::move(buffers)), 0)...};
+      _buffer_views.reserve(_buffers.size() + 1u);
+      _buffer_views.emplace_back(boost::asio::buffer(&_total_size, sizeof(_total_size)));
+      for (const auto &buffer : _buffers) {
+        _buffer_views.emplace_back(buffer.cbuffer());
+      }
     }
 
     /// Size in bytes of the message excluding the header.
@@ -70,26 +68,55 @@ namespace tcp {
       return size() == 0u;
     }
 
+    /// Number of buffers in the message excluding the header.
+    size_t GetNumberOfBuffers() const noexcept {
+      return _buffers.size();
+    }
+
     auto GetBufferSequence() const {
-      auto begin = _buffer_views.begin();
-      return MakeListView(begin, begin + _number_of_buffers + 1u);
+      return MakeListView(_buffer_views.begin(), _buffer_views.end());
     }
 
   private:
 
-    message_size_type _number_of_buffers = 0u;
+    static size_t CountBuffers() {
+      return 0u;
+    }
+
+    template <typename... Buffers>
+    static size_t CountBuffers(const Buffer &, const Buffers &... buffers) {
+      return 1u + CountBuffers(buffers...);
+    }
+
+    template <typename... Buffers>
+    static size_t CountBuffers(const BufferList &list, const Buffers &... buffers) {
+      return list.size() + CountBuffers(buffers...);
+    }
+
+    void Append(Buffer &&buffer) {
+      if (buffer.empty()) {
+        return;
+      }
+      DEBUG_ASSERT(
+          static_cast<size_t>(_total_size) + buffer.size() <=
+          std::numeric_limits<message_size_type>::max());
+      _total_size += buffer.size();
+      _buffers.emplace_back(std::move(buffer));
+    }
+
+    void Append(BufferList &&list) {
+      for (auto &buffer : list) {
+        Append(std::move(buffer));
+      }
+    }
 
     message_size_type _total_size = 0u;
 
-    std::array<Buffer, MaxNumberOfBuffers> _buffers;
+    std::vector<Buffer> _buffers;
 
-    std::array<boost::asio::const_buffer, MaxNumberOfBuffers + 1u> _buffer_views;
+    std::vector<boost::asio::const_buffer> _buffer_views;
   };
 
-  /// A TCP message containing a maximum of 2 buffers. This is optimized for a
-  /// header and body sort of messages.
-  using Message = MessageTmpl<2u>;
-
 } // namespace tcp
 } // namespace detail
 } // namespace streaming
@@ -8,6 +8,7 @@
 
 #include "carla/NonCopyable.h"
 #include "carla/Time.h"
+#include "carla/streaming/detail/QueueSettings.h"
 #include "carla/streaming/detail/tcp/ServerSession.h"
 
 #include <boost/asio/io_context.hpp>
@@ -15,6 +16,7 @@
 #include <boost/asio/post.hpp>
 
 #include <atomic>
+#include <mutex>
 
 namespace carla {
 namespace streaming {
@@ -62,6 +64,24 @@ namespace tcp {
       return _synchronous;
     }
 
+    /// Set the limits and overflow policies of the outbound queue of every
+    /// session, applies to the messages written from now on.
+    void SetQueueSettings(const QueueSettings &settings) {
+      std::lock_guard<std::mutex> lock(_queue_settings_mutex);
+      _queue_settings = settings;
+    }
+
+    QueueSettings GetQueueSettings() const {
+      std::lock_guard<std::mutex> lock(_queue_settings_mutex);
+      return _queue_settings;
+    }
+
+    /// Limits applied by the sessions in the current mode.
+    QueueLimits GetQueueLimits() const {
+      std::lock_guard<std::mutex> lock(_queue_settings_mutex);
+      return _queue_settings.GetLimits(IsSynchronousMode());
+    }
+
   private:
 
     void OpenSession(
@@ -75,7 +95,11 @@ namespace tcp {
 
     std::atomic<time_duration> _timeout;
 
-    bool _synchronous;
+    std::atomic_bool _synchronous;
+
+    mutable std::mutex _queue_settings_mutex;
+
+    QueueSettings _queue_settings;
   };
 
 } // namespace tcp
@@ -15,8 +15,12 @@
 #include <boost/asio/bind_executor.hpp>
 #include <boost/asio/post.hpp>
 
+#include <array>
 #include <atomic>
-#include <thread>
+
+#ifdef __linux__
+#  include <unistd.h>
+#endif // __linux__
 
 namespace carla {
 namespace streaming {
@@ -25,6 +29,16 @@ namespace tcp {
 
   static std::atomic_size_t SESSION_COUNTER{0u};
 
+  static std::string MakeSharedMemoryName(size_t session_id, size_t count) {
+#ifdef __linux__
+    const auto pid = ::getpid();
+#else
+    const auto pid = 0;
+#endif // __linux__
+    return "/carla-stream-" + std::to_string(pid) + '-' +
+        std::to_string(session_id) + '-' + std::to_string(count);
+  }
+
   ServerSession::ServerSession(
       boost::asio::io_context &io_context,
       const time_duration timeout,
@@ -58,8 +72,16 @@ namespace tcp {
           size_t DEBUG_ONLY(bytes_received)) {
         if (!ec) {
           DEBUG_ASSERT_EQ(bytes_received, sizeof(_stream_id));
-          log_debug("session", _session_id, "for stream", _stream_id, " started");
-          boost::asio::post(_strand.context(), [=]() { callback(self); });
+          auto on_ready = [=]() {
+            log_debug("session", _session_id, "for stream", _stream_id, " started");
+            boost::asio::post(_strand.context(), [=]() { callback(self); });
+          };
+          if ((_stream_id & shm::SharedMemoryRing::request_flag) != 0u) {
+            _stream_id &= ~shm::SharedMemoryRing::request_flag;
+            OpenSharedMemory(std::move(on_ready));
+          } else {
+            on_ready();
+          }
         } else {
           log_error("session", _session_id, ": error retrieving stream id :", ec.message());
           CloseNow();
@@ -78,44 +100,24 @@ namespace tcp {
   void ServerSession::Write(std::shared_ptr<const Message> message) {
     DEBUG_ASSERT(message != nullptr);
     DEBUG_ASSERT(!message->empty());
-    auto self = shared_from_this();
-    boost::asio::post(_strand, [=]() {
-      if (!_socket.is_open()) {
-        return;
-      }
-      if (_is_writing) {
-        if (_server.IsSynchronousMode()) {
-          // wait until previous message has been sent
-          while (_is_writing) {
-            std::this_thread::yield();
-          }
-        } else {
-          // ignore this message
-          log_debug("session", _session_id, ": connection too slow: message discarded");
-          return;
-        }      
-      }
-      _is_writing = true;
-
-      auto handle_sent = [this, self, message](const boost::system::error_code &ec, size_t DEBUG_ONLY(bytes)) {
-        _is_writing = false;
-        if (ec) {
-          log_info("session", _session_id, ": error sending data :", ec.message());
-          CloseNow();
-        } else {
-          DEBUG_ONLY(log_debug("session", _session_id, ": successfully sent", bytes, "bytes"));
-          DEBUG_ASSERT_EQ(bytes, sizeof(message_size_type) + message->size());
-        }
-      };
-
-      log_debug("session", _session_id, ": sending message of", message->size(), "bytes");
-
-      _deadline.expires_from_now(_timeout);
-      boost::asio::async_write(
-          _socket,
-          message->GetBufferSequence(),
-          handle_sent);
-    });
+    if (_is_closed) {
+      return;
+    }
+    if (std::atomic_load(&_shared_memory) != nullptr) {
+      WriteSharedMemory(*message);
+      return;
+    }
+    const auto result = _queue.Push(std::move(message), _server.GetQueueLimits(), _timeout);
+    switch (result) {
+      case SessionQueue::PushResult::StartSending:
+        boost::asio::post(_strand, [self=shared_from_this()]() { self->WriteNext(); });
+        break;
+      case SessionQueue::PushResult::Dropped:
+        log_debug("session", _session_id, ": connection too slow: message discarded");
+        break;
+      default:
+        break;
+    }
   }
 
   void ServerSession::Close() {
@@ -139,6 +141,12 @@ namespace tcp {
 
   void ServerSession::CloseNow() {
     _deadline.cancel();
+    _is_closed = true;
+    _queue.Close();
+    auto ring = std::atomic_load(&_shared_memory);
+    if (ring != nullptr) {
+      ring->Close();
+    }
     if (_socket.is_open()) {
       boost::system::error_code ec;
       _socket.shutdown(boost::asio::socket_base::shutdown_both, ec);
@@ -148,6 +156,140 @@ namespace tcp {
     log_debug("session", _session_id, "closed");
   }
 
+  void ServerSession::WriteNext() {
+    SessionQueue::Entry entry;
+    if (!_socket.is_open() || !_queue.Pop(entry)) {
+      return;
+    }
+    auto self = shared_from_this();
+    auto handle_sent = [this, self, entry](const boost::system::error_code &ec, size_t bytes) {
+      if (ec) {
+        log_info("session", _session_id, ": error sending data :", ec.message());
+        CloseNow();
+      } else {
+        DEBUG_ONLY(log_debug("session", _session_id, ": successfully sent", bytes, "bytes"));
+        DEBUG_ASSERT_EQ(bytes, sizeof(message_size_type) + entry.message->size());
+        _queue.RecordSent(bytes, entry.queued_at);
+        WriteNext();
+      }
+    };
+
+    log_debug("session", _session_id, ": sending message of", entry.message->size(), "bytes");
+
+    _deadline.expires_from_now(_timeout);
+    boost::asio::async_write(
+        _socket,
+        entry.message->GetBufferSequence(),
+        boost::asio::bind_executor(_strand, handle_sent));
+  }
+
+  bool ServerSession::IsLocalClient() const {
+    boost::system::error_code ec;
+    const auto remote = _socket.remote_endpoint(ec).address();
+    const auto local = _socket.local_endpoint(ec).address();
+    return !ec && (remote.is_loopback() || (remote == local));
+  }
+
+  void ServerSession::OpenSharedMemory(std::function<void()> on_ready) {
+    if (IsLocalClient() && shm::SharedMemoryRing::IsSupported()) {
+      std::atomic_store(&_shared_memory, std::shared_ptr<shm::SharedMemoryRing>(
+          shm::SharedMemoryRing::Create(
+              MakeSharedMemoryName(_session_id, _shared_memory_count++),
+              shm::SharedMemoryRing::min_capacity)));
+    }
+    const auto ring = std::atomic_load(&_shared_memory);
+    _shared_memory_name = ring != nullptr ? ring->GetName() : std::string();
+    _shared_memory_name_size = static_cast<message_size_type>(_shared_memory_name.size());
+    log_debug("session", _session_id, ": shared memory", _shared_memory_name);
+
+    auto self = shared_from_this();
+    auto handle_sent = [this, self, ring, callback=std::move(on_ready)](
+        const boost::system::error_code &ec,
+        size_t) {
+      if (ec) {
+        log_info("session", _session_id, ": error sending shared memory name :", ec.message());
+        CloseNow();
+        return;
+      }
+      if (ring != nullptr) {
+        WatchSocket();
+      }
+      callback();
+    };
+
+    const std::array<boost::asio::const_buffer, 2u> buffers = {
+        boost::asio::buffer(&_shared_memory_name_size, sizeof(_shared_memory_name_size)),
+        boost::asio::buffer(_shared_memory_name)};
+    _deadline.expires_from_now(_timeout);
+    boost::asio::async_write(
+        _socket,
+        buffers,
+        boost::asio::bind_executor(_strand, handle_sent));
+  }
+
+  void ServerSession::WriteSharedMemory(const Message &message) {
+    const auto queued_at = SessionQueue::clock_type::now();
+    // Like SessionQueue::Push, only the blocking policy waits for space, and
+    // never longer than the session timeout in total.
+    const auto deadline = queued_at + (
+        _server.GetQueueLimits().policy == OverflowPolicy::Block ?
+            _timeout.to_chrono() :
+            std::chrono::milliseconds(0));
+    const auto remaining = [&]() -> time_duration {
+      const auto now = SessionQueue::clock_type::now();
+      return now < deadline ? deadline - now : std::chrono::milliseconds(0);
+    };
+    const size_t size = sizeof(message_size_type) + message.size();
+    std::lock_guard<std::mutex> lock(_shared_memory_mutex);
+    auto ring = std::atomic_load(&_shared_memory);
+    if (!ring->Fits(size)) {
+      // Move to a ring big enough, the client follows the redirect.
+      const auto capacity = shm::SharedMemoryRing::CapacityFor(size);
+      std::shared_ptr<shm::SharedMemoryRing> next = capacity > 0u ?
+          shm::SharedMemoryRing::Create(
+              MakeSharedMemoryName(_session_id, _shared_memory_count++),
+              capacity) :
+          nullptr;
+      if ((next == nullptr) || !ring->WriteRedirect(next->GetName(), remaining())) {
+        log_error("session", _session_id, ": message of", size, "bytes does not fit in shared memory, discarded");
+        _queue.RecordDropped(size);
+        return;
+      }
+      log_debug("session", _session_id, ": shared memory grown to", capacity, "bytes");
+      std::atomic_store(&_shared_memory, next);
+      // CloseNow may have closed the previous ring in the meantime.
+      if (_is_closed) {
+        next->Close();
+      }
+      ring = std::move(next);
+    }
+    if (ring->Write(message.GetBufferSequence(), remaining())) {
+      _queue.RecordSent(size, queued_at);
+      // The session times out after a while without writes.
+      boost::asio::post(_strand, [self=shared_from_this()]() {
+        self->_deadline.expires_from_now(self->_timeout);
+      });
+    } else if (ring->IsClosed()) {
+      Close();
+    } else {
+      log_debug("session", _session_id, ": connection too slow: message discarded");
+      _queue.RecordDropped(size);
+    }
+  }
+
+  void ServerSession::WatchSocket() {
+    auto self = shared_from_this();
+    boost::asio::async_read(
+        _socket,
+        boost::asio::buffer(&_watch_byte, sizeof(_watch_byte)),
+        boost::asio::bind_executor(_strand, [this, self](const boost::system::error_code &ec, size_t) {
+          if (_socket.is_open()) {
+            log_debug("session", _session_id, ": client disconnected :", ec.message());
+            CloseNow();
+          }
+        }));
+  }
+
 } // namespace tcp
 } // namespace detail
 } // namespace streaming
@@ -8,18 +8,23 @@
 
 #include "carla/NonCopyable.h"
 #include "carla/Time.h"
-#include "carla/TypeTraits.h"
 #include "carla/profiler/LifetimeProfiled.h"
+#include "carla/streaming/detail/StreamStats.h"
 #include "carla/streaming/detail/Types.h"
+#include "carla/streaming/detail/shm/SharedMemoryRing.h"
 #include "carla/streaming/detail/tcp/Message.h"
+#include "carla/streaming/detail/tcp/SessionQueue.h"
 
 #include <boost/asio/deadline_timer.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/strand.hpp>
 
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
 
 namespace carla {
 namespace streaming {
@@ -31,6 +36,16 @@ namespace tcp {
   /// A TCP server session. When a session opens, it reads from the socket a
   /// stream id object and passes itself to the callback functor. The session
   /// closes itself after @a timeout of inactivity is met.
+  ///
+  /// Messages wait in a bounded queue while the previous one is being sent,
+  /// when the queue is full the overflow policy of the server decides whether
+  /// the writer blocks or which message is discarded (see QueueSettings).
+  ///
+  /// If a client on the same host requests it in the stream id, the messages
+  /// are written to a shared memory ring instead, and the socket is only kept
+  /// to notice when the client goes away. The ring replaces the queue: with
+  /// OverflowPolicy::Block the writer waits for space in the ring, with any
+  /// other policy the new message is dropped if the ring is full.
   class ServerSession
     : public std::enable_shared_from_this<ServerSession>,
       private profiler::LifetimeProfiled,
@@ -60,12 +75,13 @@ namespace tcp {
     template <typename... Buffers>
     static auto MakeMessage(Buffers &&... buffers) {
       static_assert(
-          are_same<Buffer, Buffers...>::value,
-          "This function only accepts arguments of type Buffer.");
+          are_message_buffers<Buffers...>::value,
+          "This function only accepts arguments of type Buffer or BufferList.");
       return std::make_shared<const Message>(std::move(buffers)...);
     }
 
-    /// Writes some data to the socket.
+    /// Writes some data to the socket. May block the calling thread if the
+    /// queue is full and the overflow policy is OverflowPolicy::Block.
     void Write(std::shared_ptr<const Message> message);
 
     /// Writes some data to the socket.
@@ -77,12 +93,37 @@ namespace tcp {
     /// Post a job to close the session.
     void Close();
 
+    /// Counters of the messages written to this session.
+    StreamStats GetStats() const {
+      auto stats = _queue.GetStats();
+      // The backlog of a shared memory session waits in the ring instead.
+      const auto ring = std::atomic_load(&_shared_memory);
+      if (ring != nullptr) {
+        stats.queued_bytes += ring->GetPendingBytes();
+      }
+      return stats;
+    }
+
   private:
 
     void StartTimer();
 
     void CloseNow();
 
+    /// Send the next message in the queue, must be called from the strand.
+    void WriteNext();
+
+    bool IsLocalClient() const;
+
+    /// Create the shared memory ring and send its name to the client, an empty
+    /// name if it cannot be created and the socket should be used instead.
+    void OpenSharedMemory(std::function<void()> on_ready);
+
+    void WriteSharedMemory(const Message &message);
+
+    /// Wait for the client to close the socket.
+    void WatchSocket();
+
     friend class Server;
 
     Server &_server;
@@ -101,7 +142,24 @@ namespace tcp {
 
     callback_function_type _on_closed;
 
-    bool _is_writing = false;
+    SessionQueue _queue;
+
+    std::atomic_bool _is_closed{false};
+
+    /// Accessed with std::atomic_load and std::atomic_store, writers use it
+    /// outside the strand.
+    std::shared_ptr<shm::SharedMemoryRing> _shared_memory;
+
+    /// Serializes the writers of the shared memory ring.
+    std::mutex _shared_memory_mutex;
+
+    std::string _shared_memory_name;
+
+    message_size_type _shared_memory_name_size = 0u;
+
+    size_t _shared_memory_count = 0u;
+
+    unsigned char _watch_byte = 0u;
   };
 
 } // namespace tcp
@@ -0,0 +1,150 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/streaming/detail/tcp/SessionQueue.h"
+
+#include "carla/Debug.h"
+
+#include <algorithm>
+
+namespace carla {
+namespace streaming {
+namespace detail {
+namespace tcp {
+
+  static size_t GetMessageBytes(const Message &message) {
+    return sizeof(message_size_type) + message.size();
+  }
+
+  SessionQueue::PushResult SessionQueue::Push(
+      std::shared_ptr<const Message> message,
+      const QueueLimits &limits,
+      const time_duration timeout) {
+    DEBUG_ASSERT(message != nullptr);
+    const size_t bytes = GetMessageBytes(*message);
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_is_closed) {
+      return PushResult::Closed;
+    }
+    if (IsFull(limits, bytes)) {
+      switch (limits.policy) {
+        case OverflowPolicy::Block: {
+          const bool has_space = _space_available.wait_for(lock, timeout.to_chrono(), [&]() {
+            return _is_closed || !IsFull(limits, bytes);
+          });
+          if (_is_closed) {
+            return PushResult::Closed;
+          }
+          if (!has_space) {
+            CountDropped(bytes);
+            return PushResult::Dropped;
+          }
+          break;
+        }
+        case OverflowPolicy::DropOldest:
+          while (IsFull(limits, bytes)) {
+            DropFront();
+          }
+          break;
+        case OverflowPolicy::DropNewest:
+          CountDropped(bytes);
+          return PushResult::Dropped;
+        case OverflowPolicy::CoalesceLatest:
+          while (!_queue.empty()) {
+            DropFront();
+          }
+          break;
+      }
+    }
+    _queued_bytes += bytes;
+    _queue.push_back(Entry{std::move(message), clock_type::now()});
+    if (_is_sending) {
+      return PushResult::Queued;
+    }
+    _is_sending = true;
+    return PushResult::StartSending;
+  }
+
+  bool SessionQueue::Pop(Entry &entry) {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_queue.empty()) {
+        _is_sending = false;
+        return false;
+      }
+      entry = std::move(_queue.front());
+      _queue.pop_front();
+      _queued_bytes -= GetMessageBytes(*entry.message);
+    }
+    _space_available.notify_all();
+    return true;
+  }
+
+  void SessionQueue::RecordSent(const size_t bytes, const clock_type::time_point queued_at) {
+    const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+        clock_type::now() - queued_at).count();
+    const auto latency_us = static_cast<uint64_t>(std::max<decltype(latency)>(0, latency));
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.sent_messages += 1u;
+    _stats.sent_bytes += bytes;
+    _stats.last_latency_us = latency_us;
+    _stats.max_latency_us = std::max(_stats.max_latency_us, latency_us);
+    _stats.total_latency_us += latency_us;
+  }
+
+  void SessionQueue::RecordDropped(const size_t bytes) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    CountDropped(bytes);
+  }
+
+  void SessionQueue::Close() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _is_closed = true;
+      while (!_queue.empty()) {
+        DropFront();
+      }
+    }
+    _space_available.notify_all();
+  }
+
+  StreamStats SessionQueue::GetStats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    StreamStats stats = _stats;
+    stats.queued_messages = _queue.size();
+    stats.queued_bytes = _queued_bytes;
+    return stats;
+  }
+
+  bool SessionQueue::IsFull(const QueueLimits &limits, const size_t incoming_bytes) const {
+    if (_queue.empty()) {
+      // A single message is always accepted, whatever its size.
+      return false;
+    }
+    const size_t max_messages = std::max<size_t>(1u, limits.max_queued_messages);
+    return
+        (_queue.size() >= max_messages) ||
+        ((limits.max_queued_bytes > 0u) &&
+         (_queued_bytes + incoming_bytes > limits.max_queued_bytes));
+  }
+
+  void SessionQueue::DropFront() {
+    DEBUG_ASSERT(!_queue.empty());
+    const size_t bytes = GetMessageBytes(*_queue.front().message);
+    _queued_bytes -= bytes;
+    CountDropped(bytes);
+    _queue.pop_front();
+  }
+
+  void SessionQueue::CountDropped(const size_t bytes) {
+    _stats.dropped_messages += 1u;
+    _stats.dropped_bytes += bytes;
+  }
+
+} // namespace tcp
+} // namespace detail
+} // namespace streaming
+} // namespace carla
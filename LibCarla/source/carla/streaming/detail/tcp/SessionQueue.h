@@ -0,0 +1,100 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/Time.h"
+#include "carla/streaming/detail/QueueSettings.h"
+#include "carla/streaming/detail/StreamStats.h"
+#include "carla/streaming/detail/tcp/Message.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace carla {
+namespace streaming {
+namespace detail {
+namespace tcp {
+
+  /// Bounded queue of the messages waiting to be sent by a session. Writers
+  /// push from any thread, the session pops from its strand one message at a
+  /// time, so at most one write is in flight per session.
+  class SessionQueue : private NonCopyable {
+  public:
+
+    using clock_type = std::chrono::steady_clock;
+
+    struct Entry {
+      std::shared_ptr<const Message> message;
+      clock_type::time_point queued_at;
+    };
+
+    enum class PushResult {
+      /// Queued behind a message being sent.
+      Queued,
+      /// Queued, the caller has to start sending since the queue was idle.
+      StartSending,
+      /// Discarded by the overflow policy.
+      Dropped,
+      /// Discarded because the queue is closed.
+      Closed
+    };
+
+    /// Queue @a message applying the policy of @a limits if the queue is
+    /// full. With OverflowPolicy::Block the calling thread waits up to
+    /// @a timeout for space, then the message is dropped.
+    PushResult Push(
+        std::shared_ptr<const Message> message,
+        const QueueLimits &limits,
+        time_duration timeout);
+
+    /// Retrieve the next message to send. If there is none, returns false and
+    /// the next Push returns PushResult::StartSending.
+    bool Pop(Entry &entry);
+
+    /// Account for a message written, @a bytes including the header.
+    void RecordSent(size_t bytes, clock_type::time_point queued_at);
+
+    /// Account for a message discarded outside the queue.
+    void RecordDropped(size_t bytes);
+
+    /// Discard the queued messages and wake up any blocked writer. Any later
+    /// Push fails.
+    void Close();
+
+    StreamStats GetStats() const;
+
+  private:
+
+    bool IsFull(const QueueLimits &limits, size_t incoming_bytes) const;
+
+    void DropFront();
+
+    void CountDropped(size_t bytes);
+
+    mutable std::mutex _mutex;
+
+    std::condition_variable _space_available;
+
+    std::deque<Entry> _queue;
+
+    size_t _queued_bytes = 0u;
+
+    bool _is_sending = false;
+
+    bool _is_closed = false;
+
+    StreamStats _stats;
+  };
+
+} // namespace tcp
+} // namespace detail
+} // namespace streaming
+} // namespace carla
@@ -7,6 +7,8 @@
 #pragma once
 
 #include "carla/streaming/detail/Dispatcher.h"
+#include "carla/streaming/detail/QueueSettings.h"
+#include "carla/streaming/detail/StreamStats.h"
 #include "carla/streaming/detail/Types.h"
 #include "carla/streaming/Stream.h"
 
@@ -73,6 +75,22 @@ namespace low_level {
       _server.SetSynchronousMode(is_synchro);
     }
 
+    void SetQueueSettings(const detail::QueueSettings &settings) {
+      _server.SetQueueSettings(settings);
+    }
+
+    detail::QueueSettings GetQueueSettings() const {
+      return _server.GetQueueSettings();
+    }
+
+    detail::StreamStats GetStreamStats(detail::stream_id_type id) {
+      return _dispatcher.GetStreamStats(id);
+    }
+
+    BufferPool::Stats GetBufferPoolStats() {
+      return _dispatcher.GetBufferPoolStats();
+    }
+
     carla::streaming::detail::token_type GetToken(carla::streaming::detail::stream_id_type sensor_id) {
       return _dispatcher.GetToken(sensor_id);
     }
@@ -9,8 +9,6 @@
 namespace carla {
 namespace traffic_manager {
 
-  using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
-
   CachedSimpleWaypoint::CachedSimpleWaypoint(const SimpleWaypointPtr& simple_waypoint) {
     this->waypoint_id = simple_waypoint->GetId();
 
@@ -13,8 +13,6 @@
 namespace carla {
 namespace traffic_manager {
 
-  using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
-
   class CachedSimpleWaypoint {
   public:
     uint64_t waypoint_id;
@@ -15,8 +15,21 @@ using TLS = carla::rpc::TrafficLightState;
 using namespace constants::Collision;
 using constants::WaypointSelection::JUNCTION_LOOK_AHEAD;
 
+namespace {
+
+  int32_t GetBroadPhaseCell(const float coordinate) {
+    return static_cast<int32_t>(std::floor(coordinate / BROAD_PHASE_CELL_SIZE));
+  }
+
+  uint64_t GetBroadPhaseKey(const int32_t cell_x, const int32_t cell_y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cell_x)) << 32) | static_cast<uint32_t>(cell_y);
+  }
+
+} // namespace
+
 CollisionStage::CollisionStage(
   const std::vector<ActorId> &vehicle_id_list,
+  const std::vector<StateSlot> &vehicle_slot_list,
   const SimulationState &simulation_state,
   const BufferMap &buffer_map,
   const TrackTraffic &track_traffic,
@@ -24,6 +37,7 @@ CollisionStage::CollisionStage(
   CollisionFrame &output_array,
   RandomGenerator &random_device)
   : vehicle_id_list(vehicle_id_list),
+    vehicle_slot_list(vehicle_slot_list),
     simulation_state(simulation_state),
     buffer_map(buffer_map),
     track_traffic(track_traffic),
@@ -37,67 +51,96 @@ void CollisionStage::Update(const unsigned long index) {
   float available_distance_margin = std::numeric_limits<float>::infinity();
 
   const ActorId ego_actor_id = vehicle_id_list.at(index);
-  if (simulation_state.ContainsActor(ego_actor_id)) {
-    const cg::Location ego_location = simulation_state.GetLocation(ego_actor_id);
-    const Buffer &ego_buffer = buffer_map.at(ego_actor_id);
-    const unsigned long look_ahead_index = GetTargetWaypoint(ego_buffer, JUNCTION_LOOK_AHEAD).second;
-    const float velocity = simulation_state.GetVelocity(ego_actor_id).Length();
+  const StateSlot ego_slot = vehicle_slot_list.at(index);
+  const cg::Location ego_location = simulation_state.GetLocation(ego_slot);
+  const Buffer &ego_buffer = buffer_map.at(ego_actor_id);
+  const unsigned long look_ahead_index = GetTargetWaypoint(ego_buffer, JUNCTION_LOOK_AHEAD).second;
+  const float velocity = simulation_state.GetVelocity(ego_slot).Length();
+
+  // Collision candidates with their squared distance to the vehicle.
+  std::vector<std::pair<float, ActorId>> collision_candidates;
+  // Run through vehicles with overlapping paths and filter them;
+  const float distance_to_leading = parameters.GetDistanceToLeadingVehicle(ego_actor_id);
+  float collision_radius_square = SQUARE(COLLISION_RADIUS_RATE * velocity + COLLISION_RADIUS_MIN);
+  if (velocity < 2.0f) {
+    const float length = simulation_state.GetDimensions(ego_slot).x;
+    const float collision_radius_stop = COLLISION_RADIUS_STOP + length;
+    collision_radius_square = SQUARE(collision_radius_stop);
+  }
+  if (distance_to_leading > collision_radius_square) {
+      collision_radius_square = SQUARE(distance_to_leading);
+  }
 
-    ActorIdSet overlapping_actors = track_traffic.GetOverlappingVehicles(ego_actor_id);
-    std::vector<ActorId> collision_candidate_ids;
-    // Run through vehicles with overlapping paths and filter them;
-    const float distance_to_leading = parameters.GetDistanceToLeadingVehicle(ego_actor_id);
-    float collision_radius_square = SQUARE(COLLISION_RADIUS_RATE * velocity + COLLISION_RADIUS_MIN);
-    if (velocity < 2.0f) {
-      const float length = simulation_state.GetDimensions(ego_actor_id).x;
-      const float collision_radius_stop = COLLISION_RADIUS_STOP + length;
-      collision_radius_square = SQUARE(collision_radius_stop);
-    }
-    if (distance_to_leading > collision_radius_square) {
-        collision_radius_square = SQUARE(distance_to_leading);
+  // Cells of the broad phase grid within the collision radius.
+  const float collision_radius = std::sqrt(collision_radius_square);
+  const int32_t min_cell_x = GetBroadPhaseCell(ego_location.x - collision_radius);
+  const int32_t max_cell_x = GetBroadPhaseCell(ego_location.x + collision_radius);
+  const int32_t min_cell_y = GetBroadPhaseCell(ego_location.y - collision_radius);
+  const int32_t max_cell_y = GetBroadPhaseCell(ego_location.y + collision_radius);
+  const uint64_t number_of_cells = static_cast<uint64_t>(max_cell_x - min_cell_x + 1)
+                                   * static_cast<uint64_t>(max_cell_y - min_cell_y + 1);
+
+  if (number_of_cells <= broad_phase_grid.size()) {
+    // Run through the actors near the vehicle and keep the ones with overlapping paths.
+    for (int32_t cell_x = min_cell_x; cell_x <= max_cell_x; ++cell_x) {
+      for (int32_t cell_y = min_cell_y; cell_y <= max_cell_y; ++cell_y) {
+        auto cell = broad_phase_grid.find(GetBroadPhaseKey(cell_x, cell_y));
+        if (cell == broad_phase_grid.end()) {
+          continue;
+        }
+        for (const BroadPhaseEntry &entry : cell->second) {
+          const float distance_square = cg::Math::DistanceSquared(entry.location, ego_location);
+          if (entry.actor_id != ego_actor_id
+              && distance_square < collision_radius_square
+              && std::abs(ego_location.z - entry.location.z) < VERTICAL_OVERLAP_THRESHOLD
+              && track_traffic.IsOverlappingVehicle(ego_actor_id, entry.actor_id)) {
+            collision_candidates.emplace_back(distance_square, entry.actor_id);
+          }
+        }
+      }
     }
-
+  } else {
+    // With a very large radius, it is faster to go through the overlapping actors.
+    ActorIdSet overlapping_actors = track_traffic.GetOverlappingVehicles(ego_actor_id);
     for (ActorId overlapping_actor_id : overlapping_actors) {
       // If actor is within maximum collision avoidance and vertical overlap range.
-      const cg::Location &overlapping_actor_location = simulation_state.GetLocation(overlapping_actor_id);
+      const cg::Location overlapping_actor_location = simulation_state.GetLocation(overlapping_actor_id);
+      const float distance_square = cg::Math::DistanceSquared(overlapping_actor_location, ego_location);
       if (overlapping_actor_id != ego_actor_id
-          && cg::Math::DistanceSquared(overlapping_actor_location, ego_location) < collision_radius_square
+          && distance_square < collision_radius_square
           && std::abs(ego_location.z - overlapping_actor_location.z) < VERTICAL_OVERLAP_THRESHOLD) {
-        collision_candidate_ids.push_back(overlapping_actor_id);
+        collision_candidates.emplace_back(distance_square, overlapping_actor_id);
       }
     }
+  }
 
-    // Sorting collision candidates in accending order of distance to current vehicle.
-    std::sort(collision_candidate_ids.begin(), collision_candidate_ids.end(),
-              [this, &ego_location](const ActorId &a_id_1, const ActorId &a_id_2) {
-                const cg::Location &e_loc = ego_location;
-                const cg::Location &loc_1 = simulation_state.GetLocation(a_id_1);
-                const cg::Location &loc_2 = simulation_state.GetLocation(a_id_2);
-                return (cg::Math::DistanceSquared(e_loc, loc_1) < cg::Math::DistanceSquared(e_loc, loc_2));
-              });
-
-    // Check every actor in the vicinity if it poses a collision hazard.
-    for (auto iter = collision_candidate_ids.begin();
-         iter != collision_candidate_ids.end() && !collision_hazard;
-         ++iter) {
-      const ActorId other_actor_id = *iter;
-      const ActorType other_actor_type = simulation_state.GetType(other_actor_id);
-
-      if (parameters.GetCollisionDetection(ego_actor_id, other_actor_id)
-          && buffer_map.find(ego_actor_id) != buffer_map.end()
-          && simulation_state.ContainsActor(other_actor_id)) {
-        std::pair<bool, float> negotiation_result = NegotiateCollision(ego_actor_id,
-                                                                       other_actor_id,
-                                                                       look_ahead_index);
-        if (negotiation_result.first) {
-          if ((other_actor_type == ActorType::Vehicle
-               && parameters.GetPercentageIgnoreVehicles(ego_actor_id) <= random_device.next())
-              || (other_actor_type == ActorType::Pedestrian
-                  && parameters.GetPercentageIgnoreWalkers(ego_actor_id) <= random_device.next())) {
-            collision_hazard = true;
-            obstacle_id = other_actor_id;
-            available_distance_margin = negotiation_result.second;
-          }
+  // Sorting collision candidates in accending order of distance to current vehicle.
+  std::sort(collision_candidates.begin(), collision_candidates.end(),
+            [](const std::pair<float, ActorId> &candidate_1, const std::pair<float, ActorId> &candidate_2) {
+              return candidate_1.first < candidate_2.first;
+            });
+
+  // Check every actor in the vicinity if it poses a collision hazard.
+  for (auto iter = collision_candidates.begin();
+       iter != collision_candidates.end() && !collision_hazard;
+       ++iter) {
+    const ActorId other_actor_id = iter->second;
+    const ActorType other_actor_type = simulation_state.GetType(other_actor_id);
+
+    if (parameters.GetCollisionDetection(ego_actor_id, other_actor_id)
+        && buffer_map.find(ego_actor_id) != buffer_map.end()
+        && simulation_state.ContainsActor(other_actor_id)) {
+      std::pair<bool, float> negotiation_result = NegotiateCollision(ego_actor_id,
+                                                                     other_actor_id,
+                                                                     look_ahead_index);
+      if (negotiation_result.first) {
+        if ((other_actor_type == ActorType::Vehicle
+             && parameters.GetPercentageIgnoreVehicles(ego_actor_id) <= random_device.next())
+            || (other_actor_type == ActorType::Pedestrian
+                && parameters.GetPercentageIgnoreWalkers(ego_actor_id) <= random_device.next())) {
+          collision_hazard = true;
+          obstacle_id = other_actor_id;
+          available_distance_margin = negotiation_result.second;
         }
       }
     }
@@ -110,11 +153,23 @@ void CollisionStage::Update(const unsigned long index) {
 }
 
 void CollisionStage::RemoveActor(const ActorId actor_id) {
-  collision_locks.erase(actor_id);
+  {
+    std::lock_guard<std::mutex> lock(collision_locks_mutex);
+    collision_locks.erase(actor_id);
+  }
+  std::lock_guard<std::mutex> lock(cycle_cache_mutex);
+  boundaries_cache.erase(actor_id);
 }
 
 void CollisionStage::Reset() {
-  collision_locks.clear();
+  {
+    std::lock_guard<std::mutex> lock(collision_locks_mutex);
+    collision_locks.clear();
+  }
+  std::lock_guard<std::mutex> lock(cycle_cache_mutex);
+  boundaries_cache.clear();
+  geometry_cache.clear();
+  broad_phase_grid.clear();
 }
 
 float CollisionStage::GetBoundingBoxExtention(const ActorId actor_id) {
@@ -125,6 +180,7 @@ float CollisionStage::GetBoundingBoxExtention(const ActorId actor_id) {
   float velocity_extension = VEL_EXT_FACTOR * velocity;
   bbox_extension = BOUNDARY_EXTENSION_MINIMUM + velocity_extension * velocity_extension;
   // If a valid collision lock present, change boundary length to maintain lock.
+  std::lock_guard<std::mutex> locks_guard(collision_locks_mutex);
   if (collision_locks.find(actor_id) != collision_locks.end()) {
     const CollisionLock &lock = collision_locks.at(actor_id);
     float lock_boundary_length = static_cast<float>(lock.distance_to_lead_vehicle + LOCKING_DISTANCE_PADDING);
@@ -169,18 +225,13 @@ LocationVector CollisionStage::GetBoundary(const ActorId actor_id) {
   return bbox_boundary;
 }
 
-LocationVector CollisionStage::GetGeodesicBoundary(const ActorId actor_id) {
+LocationVector CollisionStage::GetGeodesicBoundary(const ActorId actor_id, const float bbox_extension) {
   LocationVector geodesic_boundary;
 
-  if (geodesic_boundary_map.find(actor_id) != geodesic_boundary_map.end()) {
-    geodesic_boundary = geodesic_boundary_map.at(actor_id);
-  } else {
+  {
     const LocationVector bbox = GetBoundary(actor_id);
 
     if (buffer_map.find(actor_id) != buffer_map.end()) {
-      float bbox_extension = GetBoundingBoxExtention(actor_id);
-      const float specific_lead_distance = parameters.GetDistanceToLeadingVehicle(actor_id);
-      bbox_extension = std::max(specific_lead_distance, bbox_extension);
       const float bbox_extension_square = SQUARE(bbox_extension);
 
       LocationVector left_boundary;
@@ -235,13 +286,82 @@ LocationVector CollisionStage::GetGeodesicBoundary(const ActorId actor_id) {
 
       geodesic_boundary = bbox;
     }
-
-    geodesic_boundary_map.insert({actor_id, geodesic_boundary});
   }
 
   return geodesic_boundary;
 }
 
+std::shared_ptr<const ActorBoundaries> CollisionStage::GetActorBoundaries(const ActorId actor_id) {
+
+  std::shared_ptr<const ActorBoundaries> cached_boundaries;
+  {
+    std::lock_guard<std::mutex> lock(cycle_cache_mutex);
+    auto cached = boundaries_cache.find(actor_id);
+    if (cached != boundaries_cache.end()) {
+      if (cached->second.cycle == current_cycle) {
+        return cached->second.boundaries;
+      }
+      cached_boundaries = cached->second.boundaries;
+    }
+  }
+
+  // State the boundaries are built from.
+  const cg::Location location = simulation_state.GetLocation(actor_id);
+  const cg::Vector3D heading = simulation_state.GetHeading(actor_id);
+  const cg::Vector3D velocity = simulation_state.GetVelocity(actor_id);
+  float bbox_extension = 0.0f;
+  SimpleWaypointPtr buffer_front = nullptr;
+  SimpleWaypointPtr buffer_back = nullptr;
+  std::size_t buffer_size = 0u;
+  auto buffer = buffer_map.find(actor_id);
+  if (buffer != buffer_map.end()) {
+    const float specific_lead_distance = parameters.GetDistanceToLeadingVehicle(actor_id);
+    bbox_extension = std::max(specific_lead_distance, GetBoundingBoxExtention(actor_id));
+    buffer_size = buffer->second.size();
+    if (buffer_size > 0u) {
+      buffer_front = buffer->second.front();
+      buffer_back = buffer->second.back();
+    }
+  }
+
+  // Reuse the boundaries of the previous cycles if the actor did not move and
+  // the buffer has the same ends. The buffer only changes by its ends, or
+  // completely on lane changes.
+  const bool unchanged = cached_boundaries != nullptr
+      && cached_boundaries->location == location
+      && cached_boundaries->heading == heading
+      && cached_boundaries->velocity == velocity
+      && cached_boundaries->bbox_extension == bbox_extension
+      && cached_boundaries->buffer_front == buffer_front
+      && cached_boundaries->buffer_back == buffer_back
+      && cached_boundaries->buffer_size == buffer_size;
+
+  if (!unchanged) {
+    auto boundaries = std::make_shared<ActorBoundaries>();
+    boundaries->location = location;
+    boundaries->heading = heading;
+    boundaries->velocity = velocity;
+    boundaries->bbox_extension = bbox_extension;
+    boundaries->buffer_front = buffer_front;
+    boundaries->buffer_back = buffer_back;
+    boundaries->buffer_size = buffer_size;
+    boundaries->bbox_polygon = GetPolygon(GetBoundary(actor_id));
+    boundaries->geodesic_polygon = GetPolygon(GetGeodesicBoundary(actor_id, bbox_extension));
+    bg::envelope(boundaries->geodesic_polygon, boundaries->geodesic_envelope);
+    cached_boundaries = std::move(boundaries);
+  }
+
+  std::lock_guard<std::mutex> lock(cycle_cache_mutex);
+  ActorBoundariesEntry &entry = boundaries_cache[actor_id];
+  if (entry.boundaries != nullptr && entry.cycle == current_cycle) {
+    // Computed by another vehicle in the meantime.
+    return entry.boundaries;
+  }
+  entry.cycle = current_cycle;
+  entry.boundaries = cached_boundaries;
+  return cached_boundaries;
+}
+
 Polygon CollisionStage::GetPolygon(const LocationVector &boundary) {
 
   traffic_manager::Polygon boundary_polygon;
@@ -271,31 +391,62 @@ GeometryComparison CollisionStage::GetGeometryBetweenActors(const ActorId refere
 
   GeometryComparison comparision_result{-1.0, -1.0, -1.0, -1.0};
 
-  if (geometry_cache.find(actor_id_key) != geometry_cache.end()) {
+  bool cached = false;
+  {
+    std::lock_guard<std::mutex> lock(cycle_cache_mutex);
+    auto cached_result = geometry_cache.find(actor_id_key);
+    if (cached_result != geometry_cache.end()) {
+      comparision_result = cached_result->second;
+      cached = true;
+    }
+  }
+
+  if (cached) {
 
-    comparision_result = geometry_cache.at(actor_id_key);
     double mref_veh_other = comparision_result.reference_vehicle_to_other_geodesic;
     comparision_result.reference_vehicle_to_other_geodesic = comparision_result.other_vehicle_to_reference_geodesic;
     comparision_result.other_vehicle_to_reference_geodesic = mref_veh_other;
   } else {
 
-    const Polygon reference_polygon = GetPolygon(GetBoundary(reference_vehicle_id));
-    const Polygon other_polygon = GetPolygon(GetBoundary(other_actor_id));
+    const std::shared_ptr<const ActorBoundaries> reference_boundaries = GetActorBoundaries(reference_vehicle_id);
+    const std::shared_ptr<const ActorBoundaries> other_boundaries = GetActorBoundaries(other_actor_id);
+
+    const Polygon &reference_polygon = reference_boundaries->bbox_polygon;
+    const Polygon &other_polygon = other_boundaries->bbox_polygon;
 
-    const Polygon reference_geodesic_polygon = GetPolygon(GetGeodesicBoundary(reference_vehicle_id));
+    const Polygon &reference_geodesic_polygon = reference_boundaries->geodesic_polygon;
 
-    const Polygon other_geodesic_polygon = GetPolygon(GetGeodesicBoundary(other_actor_id));
+    const Polygon &other_geodesic_polygon = other_boundaries->geodesic_polygon;
 
-    const double reference_vehicle_to_other_geodesic = bg::distance(reference_polygon, other_geodesic_polygon);
-    const double other_vehicle_to_reference_geodesic = bg::distance(other_polygon, reference_geodesic_polygon);
-    const auto inter_geodesic_distance = bg::distance(reference_geodesic_polygon, other_geodesic_polygon);
-    const auto inter_bbox_distance = bg::distance(reference_polygon, other_polygon);
+    // Distance between the envelopes of the path boundaries, which is a lower
+    // bound of all the distances below.
+    const Envelope &reference_envelope = reference_boundaries->geodesic_envelope;
+    const Envelope &other_envelope = other_boundaries->geodesic_envelope;
+    const double gap_x = std::max({0.0,
+                                   reference_envelope.min_corner().x() - other_envelope.max_corner().x(),
+                                   other_envelope.min_corner().x() - reference_envelope.max_corner().x()});
+    const double gap_y = std::max({0.0,
+                                   reference_envelope.min_corner().y() - other_envelope.max_corner().y(),
+                                   other_envelope.min_corner().y() - reference_envelope.max_corner().y()});
+    const double envelope_distance = std::sqrt(gap_x * gap_x + gap_y * gap_y);
 
-    comparision_result = {reference_vehicle_to_other_geodesic,
-              other_vehicle_to_reference_geodesic,
-              inter_geodesic_distance,
-              inter_bbox_distance};
+    if (envelope_distance > OVERLAP_THRESHOLD) {
+      // The paths do not touch, so the actors cannot be in a collision path
+      // and the exact distances are not needed.
+      comparision_result = {envelope_distance, envelope_distance, envelope_distance, envelope_distance};
+    } else {
+      const double reference_vehicle_to_other_geodesic = bg::distance(reference_polygon, other_geodesic_polygon);
+      const double other_vehicle_to_reference_geodesic = bg::distance(other_polygon, reference_geodesic_polygon);
+      const auto inter_geodesic_distance = bg::distance(reference_geodesic_polygon, other_geodesic_polygon);
+      const auto inter_bbox_distance = bg::distance(reference_polygon, other_polygon);
+
+      comparision_result = {reference_vehicle_to_other_geodesic,
+                other_vehicle_to_reference_geodesic,
+                inter_geodesic_distance,
+                inter_bbox_distance};
+    }
 
+    std::lock_guard<std::mutex> lock(cycle_cache_mutex);
     geometry_cache.insert({actor_id_key, comparision_result});
   }
 
@@ -385,6 +536,7 @@ std::pair<bool, float> CollisionStage::NegotiateCollision(const ActorId referenc
       // This enables us to smoothly approach the lead vehicle.
 
       // When possible collision found, check if an entry for collision lock present.
+      std::lock_guard<std::mutex> locks_guard(collision_locks_mutex);
       if (collision_locks.find(reference_vehicle_id) != collision_locks.end()) {
         CollisionLock &lock = collision_locks.at(reference_vehicle_id);
         // Check if the same vehicle is under lock.
@@ -412,16 +564,45 @@ std::pair<bool, float> CollisionStage::NegotiateCollision(const ActorId referenc
   }
 
   // If no collision hazard detected, then flush collision lock held by the vehicle.
-  if (!hazard && collision_locks.find(reference_vehicle_id) != collision_locks.end()) {
+  if (!hazard) {
+    std::lock_guard<std::mutex> locks_guard(collision_locks_mutex);
     collision_locks.erase(reference_vehicle_id);
   }
 
   return {hazard, available_distance_margin};
 }
 
+void CollisionStage::UpdateBroadPhase() {
+  for (auto &cell : broad_phase_grid) {
+    cell.second.clear();
+  }
+  simulation_state.ForEachActor([this](const ActorId actor_id, const StateSlot slot) {
+    const cg::Location location = simulation_state.GetLocation(slot);
+    const uint64_t key = GetBroadPhaseKey(GetBroadPhaseCell(location.x), GetBroadPhaseCell(location.y));
+    broad_phase_grid[key].push_back({actor_id, location});
+  });
+  // Drop the cells left empty, keeping the memory of the others.
+  for (auto cell = broad_phase_grid.begin(); cell != broad_phase_grid.end();) {
+    if (cell->second.empty()) {
+      cell = broad_phase_grid.erase(cell);
+    } else {
+      ++cell;
+    }
+  }
+}
+
 void CollisionStage::ClearCycleCache() {
-  geodesic_boundary_map.clear();
+  std::lock_guard<std::mutex> lock(cycle_cache_mutex);
   geometry_cache.clear();
+  // Forget the boundaries of the actors not seen in the last cycle.
+  for (auto entry = boundaries_cache.begin(); entry != boundaries_cache.end();) {
+    if (entry->second.cycle != current_cycle) {
+      entry = boundaries_cache.erase(entry);
+    } else {
+      ++entry;
+    }
+  }
+  ++current_cycle;
 }
 
 } // namespace traffic_manager
@@ -2,6 +2,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 
 #include "boost/geometry.hpp"
 #include "boost/geometry/geometries/geometries.hpp"
@@ -34,17 +35,48 @@ using CollisionLockMap = std::unordered_map<ActorId, CollisionLock>;
 namespace cc = carla::client;
 namespace bg = boost::geometry;
 
-using Buffer = std::deque<std::shared_ptr<SimpleWaypoint>>;
+using Buffer = RingBuffer<SimpleWaypointPtr>;
 using BufferMap = std::unordered_map<carla::ActorId, Buffer>;
 using LocationVector = std::vector<cg::Location>;
-using GeodesicBoundaryMap = std::unordered_map<ActorId, LocationVector>;
 using GeometryComparisonMap = std::unordered_map<uint64_t, GeometryComparison>;
 using Polygon = bg::model::polygon<bg::model::d2::point_xy<double>>;
+using Envelope = bg::model::box<bg::model::d2::point_xy<double>>;
+
+/// Polygons around the bounding box and the path of an actor, with the state
+/// they were built from.
+struct ActorBoundaries {
+  cg::Location location;
+  cg::Vector3D heading;
+  cg::Vector3D velocity;
+  float bbox_extension;
+  SimpleWaypointPtr buffer_front;
+  SimpleWaypointPtr buffer_back;
+  std::size_t buffer_size;
+  Polygon bbox_polygon;
+  Polygon geodesic_polygon;
+  // Envelope of the geodesic polygon, which also contains the bounding box.
+  Envelope geodesic_envelope;
+};
+
+/// Boundaries of an actor and the last update cycle they were used in.
+struct ActorBoundariesEntry {
+  uint64_t cycle;
+  std::shared_ptr<const ActorBoundaries> boundaries;
+};
+using ActorBoundariesMap = std::unordered_map<ActorId, ActorBoundariesEntry>;
+
+/// Actor stored in a cell of the broad phase grid.
+struct BroadPhaseEntry {
+  ActorId actor_id;
+  cg::Location location;
+};
+using BroadPhaseGrid = std::unordered_map<uint64_t, std::vector<BroadPhaseEntry>>;
 
 /// This class has functionality to detect potential collision with a nearby actor.
 class CollisionStage : Stage {
 private:
   const std::vector<ActorId> &vehicle_id_list;
+  const std::vector<StateSlot> &vehicle_slot_list;
   const SimulationState &simulation_state;
   const BufferMap &buffer_map;
   const TrackTraffic &track_traffic;
@@ -52,11 +84,20 @@ private:
   CollisionFrame &output_array;
   // Structure keeping track of blocking lead vehicles.
   CollisionLockMap collision_locks;
-  // Structures to cache geodesic boundaries of vehicle and
-  // comparision between vehicle boundaries
+  std::mutex collision_locks_mutex;
+  // Structure to cache comparision between vehicle boundaries
   // to avoid repeated computation within a cycle.
   GeometryComparisonMap geometry_cache;
-  GeodesicBoundaryMap geodesic_boundary_map;
+  // Structure to cache the boundaries of the actors, computed once per cycle
+  // and kept across cycles while the actor and its buffer do not change.
+  ActorBoundariesMap boundaries_cache;
+  uint64_t current_cycle = 0u;
+  // The caches are shared by the vehicles updated in parallel, the values
+  // are computed outside the lock and the first one stored is kept.
+  std::mutex cycle_cache_mutex;
+  // Grid with the location of all the actors, to select the collision
+  // candidates near a vehicle.
+  BroadPhaseGrid broad_phase_grid;
   RandomGenerator &random_device;
 
   // Method to determine if a vehicle is on a collision path to another.
@@ -71,7 +112,10 @@ private:
   LocationVector GetBoundary(const ActorId actor_id);
 
   // Method to construct polygon points around the path boundary of the vehicle.
-  LocationVector GetGeodesicBoundary(const ActorId actor_id);
+  LocationVector GetGeodesicBoundary(const ActorId actor_id, const float bbox_extension);
+
+  // Method to retrieve the boundary polygons of an actor for the current cycle.
+  std::shared_ptr<const ActorBoundaries> GetActorBoundaries(const ActorId actor_id);
 
   Polygon GetPolygon(const LocationVector &boundary);
 
@@ -85,6 +129,7 @@ private:
 
 public:
   CollisionStage(const std::vector<ActorId> &vehicle_id_list,
+                 const std::vector<StateSlot> &vehicle_slot_list,
                  const SimulationState &simulation_state,
                  const BufferMap &buffer_map,
                  const TrackTraffic &track_traffic,
@@ -98,6 +143,10 @@ public:
 
   void Reset() override;
 
+  // Method to place all the actors in the broad phase grid, before updating
+  // the vehicles of the current cycle.
+  void UpdateBroadPhase();
+
   // Method to flush cache for current update cycle.
   void ClearCycleCache();
 };
@@ -87,6 +87,7 @@ static const float EPSILON = 2.0f * std::numeric_limits<float>::epsilon();
 static const float MIN_REFERENCE_DISTANCE = 0.5f;
 static const float MIN_VELOCITY_COLL_RADIUS = 2.0f;
 static const float VEL_EXT_FACTOR = 0.36f;
+static const float BROAD_PHASE_CELL_SIZE = 20.0f;
 } // namespace Collision
 
 namespace FrameMemory {
@@ -95,6 +96,11 @@ static const uint64_t GROWTH_STEP_SIZE = 50u;
 static const float INV_GROWTH_STEP_SIZE = 1.0f / static_cast<float>(GROWTH_STEP_SIZE);
 } // namespace FrameMemory
 
+namespace ParallelStages {
+// Vehicles taken at once by each thread from the ones left in a stage loop.
+static const unsigned long VEHICLES_PER_CHUNK = 4u;
+} // namespace ParallelStages
+
 namespace Map {
 static const float INFINITE_DISTANCE = std::numeric_limits<float>::max();
 static const float MAX_GEODESIC_GRID_LENGTH = 20.0f;
@@ -4,7 +4,6 @@
 #pragma once
 
 #include <chrono>
-#include <deque>
 #include <vector>
 
 #include "carla/client/Actor.h"
@@ -15,6 +14,7 @@
 #include "carla/rpc/Command.h"
 #include "carla/rpc/TrafficLightState.h"
 
+#include "carla/trafficmanager/RingBuffer.h"
 #include "carla/trafficmanager/SimpleWaypoint.h"
 
 namespace carla {
@@ -28,8 +28,7 @@ using ActorId = carla::ActorId;
 using ActorPtr = carla::SharedPtr<cc::Actor>;
 using JunctionID = carla::road::JuncId;
 using Junction = carla::SharedPtr<carla::client::Junction>;
-using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
-using Buffer = std::deque<SimpleWaypointPtr>;
+using Buffer = RingBuffer<SimpleWaypointPtr>;
 using BufferMap = std::unordered_map<carla::ActorId, Buffer>;
 using TimeInstance = chr::time_point<chr::system_clock, chr::nanoseconds>;
 using TLS = carla::rpc::TrafficLightState;
@@ -4,12 +4,29 @@
 // This work is licensed under the terms of the MIT license.
 // For a copy, see <https://opensource.org/licenses/MIT>.
 
+#include "carla/client/FileTransfer.h"
+#include "carla/FileSystem.h"
 #include "carla/Logging.h"
 
 #include "carla/trafficmanager/Constants.h"
 #include "carla/trafficmanager/InMemoryMap.h"
+#include <boost/filesystem/operations.hpp>
 #include <boost/geometry/geometries/box.hpp>
 
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <random>
+
+#ifdef __linux__
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif // __linux__
+
 namespace carla {
 namespace traffic_manager {
 
@@ -19,7 +36,126 @@ namespace traffic_manager {
   using TopologyList = std::vector<std::pair<WaypointPtr, WaypointPtr>>;
   using RawNodeList = std::vector<WaypointPtr>;
 
-  InMemoryMap::InMemoryMap(WorldMap world_map) : _world_map(world_map) {}
+namespace {
+
+  // Layout of the local cache: the header, a record for each waypoint, and
+  // the next and previous waypoints of all of them as two arrays of offsets
+  // (one per waypoint plus the end) and two arrays of waypoint indices. All
+  // the sizes are fixed, so the file is used in place once mapped.
+  struct CacheHeader {
+    static constexpr uint32_t MAGIC = 0x434d4d54u; // "TMMC"
+
+    /// Increase it with any change to the layout or to how the map is built.
+    static constexpr uint32_t VERSION = 1u;
+
+    uint32_t magic;
+    uint32_t version;
+    uint64_t opendrive_hash;
+    uint32_t waypoint_count;
+    uint32_t next_count;
+    uint32_t previous_count;
+    uint32_t reserved;
+  };
+
+  struct CacheWaypoint {
+    static constexpr uint32_t NO_WAYPOINT = std::numeric_limits<uint32_t>::max();
+
+    uint32_t road_id;
+    int32_t lane_id;
+    float s;
+    int32_t geodesic_grid_id;
+    uint32_t left_waypoint;
+    uint32_t right_waypoint;
+    uint8_t is_junction;
+    uint8_t road_option;
+    uint8_t padding[2];
+  };
+
+  constexpr uint32_t CacheHeader::MAGIC;
+  constexpr uint32_t CacheHeader::VERSION;
+  constexpr uint32_t CacheWaypoint::NO_WAYPOINT;
+
+  static_assert(sizeof(CacheHeader) == 32u, "Unexpected padding in the cache header.");
+  static_assert(sizeof(CacheWaypoint) == 28u, "Unexpected padding in the cache waypoints.");
+
+  uint64_t HashOpenDrive(const std::string &open_drive) {
+    // 64-bit FNV-1a, the same on every platform and run.
+    uint64_t hash = 0xcbf29ce484222325u;
+    for (const char c : open_drive) {
+      hash ^= static_cast<uint8_t>(c);
+      hash *= 0x100000001b3u;
+    }
+    return hash;
+  }
+
+  /// Read only view of a whole file, mapped in memory where supported.
+  class MappedFile : private NonCopyable {
+  public:
+
+    explicit MappedFile(const std::string &path) {
+#ifdef __linux__
+      const int fd = ::open(path.c_str(), O_RDONLY);
+      if (fd < 0) {
+        return;
+      }
+      struct stat info;
+      if ((::fstat(fd, &info) == 0) && (info.st_size > 0)) {
+        void *mapping = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+          _mapping = mapping;
+          _data = static_cast<const uint8_t *>(mapping);
+          _size = static_cast<size_t>(info.st_size);
+        }
+      }
+      ::close(fd);
+#else
+      std::ifstream file(path, std::ios::binary);
+      _content.assign(std::istreambuf_iterator<char>(file), {});
+      _data = _content.data();
+      _size = _content.size();
+#endif // __linux__
+    }
+
+    ~MappedFile() {
+#ifdef __linux__
+      if (_mapping != nullptr) {
+        ::munmap(_mapping, _size);
+      }
+#endif // __linux__
+    }
+
+    const uint8_t *data() const {
+      return _data;
+    }
+
+    size_t size() const {
+      return _size;
+    }
+
+  private:
+
+#ifdef __linux__
+    void *_mapping = nullptr;
+#else
+    std::vector<uint8_t> _content;
+#endif // __linux__
+    const uint8_t *_data = nullptr;
+    size_t _size = 0u;
+  };
+
+  template <typename T>
+  void AppendValue(std::vector<uint8_t> &content, const T &value) {
+    const auto *bytes = reinterpret_cast<const uint8_t *>(&value);
+    content.insert(content.end(), bytes, bytes + sizeof(T));
+  }
+
+} // namespace
+
+  InMemoryMap::InMemoryMap(WorldMap world_map) : _world_map(world_map) {
+    if (_world_map != nullptr) {
+      opendrive_hash = HashOpenDrive(_world_map->GetOpenDrive());
+    }
+  }
   InMemoryMap::~InMemoryMap() {}
 
   SegmentId InMemoryMap::GetSegmentId(const WaypointPtr &wp) const {
@@ -118,6 +254,8 @@ namespace traffic_manager {
     uint32_t total;
     memcpy(&total, &content[pos], sizeof(total));
     pos += sizeof(total);
+    cached_waypoints.reserve(total);
+    waypoints.reserve(total);
 
     // read simple waypoints
     for (uint32_t i=0; i < total; i++) {
@@ -127,28 +265,25 @@ namespace traffic_manager {
       id2index.insert({cached_wp.waypoint_id, i});
 
       WaypointPtr waypoint_ptr = _world_map->GetWaypointXODR(cached_wp.road_id, cached_wp.lane_id, cached_wp.s);
-      SimpleWaypointPtr wp = std::make_shared<SimpleWaypoint>(waypoint_ptr);
+      SimpleWaypointPtr wp = AddWaypoint(waypoint_ptr);
       wp->SetGeodesicGridId(cached_wp.geodesic_grid_id);
       wp->SetIsJunction(cached_wp.is_junction);
       wp->SetRoadOption(static_cast<RoadOption>(cached_wp.road_option));
-      dense_topology.push_back(wp);
     }
 
     // connect waypoints
+    AdjacencyLists next_lists(total);
+    AdjacencyLists previous_lists(total);
     for (uint32_t i=0; i < dense_topology.size(); i++) {
       auto wp = dense_topology.at(i);
-      auto cached_wp = cached_waypoints.at(i);
+      auto &cached_wp = cached_waypoints.at(i);
 
-      std::vector<SimpleWaypointPtr> next_waypoints;
       for (auto id : cached_wp.next_waypoints) {
-        next_waypoints.push_back(dense_topology.at(id2index.at(id)));
+        next_lists.at(i).push_back(dense_topology.at(id2index.at(id)));
       }
-      std::vector<SimpleWaypointPtr> previous_waypoints;
       for (auto id : cached_wp.previous_waypoints) {
-        previous_waypoints.push_back(dense_topology.at(id2index.at(id)));
+        previous_lists.at(i).push_back(dense_topology.at(id2index.at(id)));
       }
-      wp->SetNextWaypoint(next_waypoints);
-      wp->SetPreviousWaypoint(previous_waypoints);
       if (cached_wp.next_left_waypoint > 0) {
         wp->SetLeftWaypoint(dense_topology.at(id2index.at(cached_wp.next_left_waypoint)));
       }
@@ -157,12 +292,258 @@ namespace traffic_manager {
       }
     }
 
+    SetUpAdjacency(next_lists, previous_lists);
+
     // create spatial tree
     SetUpSpatialTree();
 
     return true;
   }
 
+  bool InMemoryMap::LoadCache(const std::string& path) {
+    MappedFile file(path);
+    if (file.size() < sizeof(CacheHeader)) {
+      return false;
+    }
+
+    CacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (header.magic != CacheHeader::MAGIC ||
+        header.version != CacheHeader::VERSION ||
+        header.opendrive_hash != opendrive_hash) {
+      log_info("InMemoryMap cache outdated, ignoring it:", path);
+      return false;
+    }
+
+    const uint64_t total = header.waypoint_count;
+    const uint64_t expected_size = sizeof(CacheHeader)
+        + total * sizeof(CacheWaypoint)
+        + 2u * (total + 1u) * sizeof(uint32_t)
+        + (static_cast<uint64_t>(header.next_count) + header.previous_count) * sizeof(uint32_t);
+    if (file.size() != expected_size) {
+      log_warning("InMemoryMap cache corrupted, ignoring it:", path);
+      return false;
+    }
+
+    // All the sections are 4-byte aligned, as is the start of the file.
+    const auto *records = reinterpret_cast<const CacheWaypoint *>(file.data() + sizeof(CacheHeader));
+    const auto *next_offsets = reinterpret_cast<const uint32_t *>(records + total);
+    const auto *previous_offsets = next_offsets + total + 1u;
+    const uint32_t *next_indices = previous_offsets + total + 1u;
+    const uint32_t *previous_indices = next_indices + header.next_count;
+
+    // Check the whole graph before building anything.
+    auto valid_offsets = [total](const uint32_t *offsets, uint32_t count) {
+      if (offsets[0] != 0u || offsets[total] != count) {
+        return false;
+      }
+      for (uint64_t i = 0u; i < total; ++i) {
+        if (offsets[i] > offsets[i + 1u]) {
+          return false;
+        }
+      }
+      return true;
+    };
+    auto valid_indices = [total](const uint32_t *indices, uint32_t count) {
+      for (uint32_t i = 0u; i < count; ++i) {
+        if (indices[i] >= total) {
+          return false;
+        }
+      }
+      return true;
+    };
+    bool valid = valid_offsets(next_offsets, header.next_count)
+        && valid_offsets(previous_offsets, header.previous_count)
+        && valid_indices(next_indices, header.next_count)
+        && valid_indices(previous_indices, header.previous_count);
+    for (uint64_t i = 0u; valid && i < total; ++i) {
+      valid = (records[i].left_waypoint < total || records[i].left_waypoint == CacheWaypoint::NO_WAYPOINT)
+          && (records[i].right_waypoint < total || records[i].right_waypoint == CacheWaypoint::NO_WAYPOINT);
+    }
+    if (!valid) {
+      log_warning("InMemoryMap cache corrupted, ignoring it:", path);
+      return false;
+    }
+
+    waypoints.reserve(total);
+    for (uint64_t i = 0u; i < total; ++i) {
+      const CacheWaypoint &record = records[i];
+      WaypointPtr waypoint_ptr = _world_map->GetWaypointXODR(record.road_id, record.lane_id, record.s);
+      if (waypoint_ptr == nullptr) {
+        log_warning("InMemoryMap cache does not match the map, ignoring it:", path);
+        Clear();
+        return false;
+      }
+      SimpleWaypointPtr wp = AddWaypoint(waypoint_ptr);
+      wp->SetGeodesicGridId(record.geodesic_grid_id);
+      wp->SetIsJunction(record.is_junction != 0u);
+      wp->SetRoadOption(static_cast<RoadOption>(record.road_option));
+    }
+
+    for (uint64_t i = 0u; i < total; ++i) {
+      const CacheWaypoint &record = records[i];
+      if (record.left_waypoint != CacheWaypoint::NO_WAYPOINT) {
+        dense_topology[i]->SetLeftWaypoint(dense_topology[record.left_waypoint]);
+      }
+      if (record.right_waypoint != CacheWaypoint::NO_WAYPOINT) {
+        dense_topology[i]->SetRightWaypoint(dense_topology[record.right_waypoint]);
+      }
+    }
+
+    next_adjacency.resize(header.next_count);
+    for (uint32_t i = 0u; i < header.next_count; ++i) {
+      next_adjacency[i] = dense_topology[next_indices[i]];
+    }
+    previous_adjacency.resize(header.previous_count);
+    for (uint32_t i = 0u; i < header.previous_count; ++i) {
+      previous_adjacency[i] = dense_topology[previous_indices[i]];
+    }
+    for (uint64_t i = 0u; i < total; ++i) {
+      dense_topology[i]->SetNextWaypoint(WaypointRange(
+          next_adjacency.data() + next_offsets[i], next_adjacency.data() + next_offsets[i + 1u]));
+      dense_topology[i]->SetPreviousWaypoint(WaypointRange(
+          previous_adjacency.data() + previous_offsets[i], previous_adjacency.data() + previous_offsets[i + 1u]));
+    }
+
+    SetUpSpatialTree();
+
+    return true;
+  }
+
+  bool InMemoryMap::SaveCache(const std::string& path) const {
+    const uint32_t total = static_cast<uint32_t>(dense_topology.size());
+
+    std::vector<uint8_t> content;
+    content.reserve(sizeof(CacheHeader)
+        + total * sizeof(CacheWaypoint)
+        + (2u * (total + 1u) + next_adjacency.size() + previous_adjacency.size()) * sizeof(uint32_t));
+
+    CacheHeader header;
+    header.magic = CacheHeader::MAGIC;
+    header.version = CacheHeader::VERSION;
+    header.opendrive_hash = opendrive_hash;
+    header.waypoint_count = total;
+    header.next_count = static_cast<uint32_t>(next_adjacency.size());
+    header.previous_count = static_cast<uint32_t>(previous_adjacency.size());
+    header.reserved = 0u;
+    AppendValue(content, header);
+
+    for (const auto &swp : dense_topology) {
+      const WaypointPtr waypoint = swp->GetWaypoint();
+      CacheWaypoint record;
+      std::memset(&record, 0, sizeof(record));
+      record.road_id = waypoint->GetRoadId();
+      record.lane_id = waypoint->GetLaneId();
+      record.s = static_cast<float>(waypoint->GetDistance());
+      record.geodesic_grid_id = swp->GetGeodesicGridId();
+      record.left_waypoint = swp->GetLeftWaypoint() != nullptr ?
+          swp->GetLeftWaypoint()->GetIndex() : CacheWaypoint::NO_WAYPOINT;
+      record.right_waypoint = swp->GetRightWaypoint() != nullptr ?
+          swp->GetRightWaypoint()->GetIndex() : CacheWaypoint::NO_WAYPOINT;
+      record.is_junction = swp->CheckJunction() ? 1u : 0u;
+      record.road_option = static_cast<uint8_t>(swp->GetRoadOption());
+      AppendValue(content, record);
+    }
+
+    // The ranges of the waypoints are consecutive in the adjacency arrays.
+    uint32_t offset = 0u;
+    AppendValue(content, offset);
+    for (const auto &swp : dense_topology) {
+      offset += static_cast<uint32_t>(swp->GetNextWaypoint().size());
+      AppendValue(content, offset);
+    }
+    offset = 0u;
+    AppendValue(content, offset);
+    for (const auto &swp : dense_topology) {
+      offset += static_cast<uint32_t>(swp->GetPreviousWaypoint().size());
+      AppendValue(content, offset);
+    }
+    for (const auto &swp : next_adjacency) {
+      AppendValue(content, swp->GetIndex());
+    }
+    for (const auto &swp : previous_adjacency) {
+      AppendValue(content, swp->GetIndex());
+    }
+
+    // Write to a temporary file and move it, so other traffic managers never
+    // see a partial cache.
+    std::string cache_path = path;
+    try {
+      carla::FileSystem::ValidateFilePath(cache_path);
+    } catch (const std::exception &e) {
+      log_warning("Could not create the folder of the InMemoryMap cache", cache_path, ":", e.what());
+      return false;
+    }
+    const std::string temporary_path = cache_path + "." + std::to_string(std::random_device{}()) + ".tmp";
+    std::ofstream out_file(temporary_path, std::ios::binary | std::ios::trunc);
+    out_file.write(reinterpret_cast<const char *>(content.data()), static_cast<std::streamsize>(content.size()));
+    out_file.close();
+    // Unlike std::rename, replaces an outdated cache on Windows too.
+    boost::system::error_code error;
+    if (out_file) {
+      boost::filesystem::rename(temporary_path, cache_path, error);
+    }
+    if (!out_file || error) {
+      log_warning("Could not write the InMemoryMap cache", cache_path);
+      std::remove(temporary_path.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  std::string InMemoryMap::GetCachePath() const {
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(opendrive_hash));
+    return client::FileTransfer::GetFilePath(std::string("TM/cache/") + hash + ".bin");
+  }
+
+  void InMemoryMap::Clear() {
+    rtree.clear();
+    next_adjacency.clear();
+    previous_adjacency.clear();
+    dense_topology.clear();
+    waypoints.clear();
+  }
+
+  SimpleWaypointPtr InMemoryMap::AddWaypoint(WaypointPtr waypoint) {
+    // The storage is reserved up front, so the waypoints never move.
+    assert(waypoints.size() < waypoints.capacity() && "Waypoint storage not reserved.");
+    waypoints.emplace_back(waypoint, static_cast<uint32_t>(waypoints.size()));
+    SimpleWaypointPtr simple_waypoint = &waypoints.back();
+    dense_topology.push_back(simple_waypoint);
+    return simple_waypoint;
+  }
+
+  void InMemoryMap::SetUpAdjacency(const AdjacencyLists &next_lists, const AdjacencyLists &previous_lists) {
+    std::size_t total_next = 0u;
+    std::size_t total_previous = 0u;
+    for (std::size_t i = 0u; i < dense_topology.size(); ++i) {
+      total_next += next_lists.at(i).size();
+      total_previous += previous_lists.at(i).size();
+    }
+
+    // Fill the arrays before taking the ranges, as they must not grow after.
+    next_adjacency.clear();
+    previous_adjacency.clear();
+    next_adjacency.reserve(total_next);
+    previous_adjacency.reserve(total_previous);
+    for (std::size_t i = 0u; i < dense_topology.size(); ++i) {
+      next_adjacency.insert(next_adjacency.end(), next_lists.at(i).begin(), next_lists.at(i).end());
+      previous_adjacency.insert(previous_adjacency.end(), previous_lists.at(i).begin(), previous_lists.at(i).end());
+    }
+
+    const SimpleWaypointPtr *next_begin = next_adjacency.data();
+    const SimpleWaypointPtr *previous_begin = previous_adjacency.data();
+    for (std::size_t i = 0u; i < dense_topology.size(); ++i) {
+      const SimpleWaypointPtr *next_end = next_begin + next_lists.at(i).size();
+      const SimpleWaypointPtr *previous_end = previous_begin + previous_lists.at(i).size();
+      dense_topology.at(i)->SetNextWaypoint(WaypointRange(next_begin, next_end));
+      dense_topology.at(i)->SetPreviousWaypoint(WaypointRange(previous_begin, previous_end));
+      next_begin = next_end;
+      previous_begin = previous_end;
+    }
+  }
+
   void InMemoryMap::SetUp() {
 
     // 1. Building segment topology (i.e., defining set of segment predecessors and successors)
@@ -221,12 +602,12 @@ namespace traffic_manager {
       }
     }
 
-    // 2. Consuming the raw dense topology from cc::Map into SimpleWaypoints.
-    SegmentMap segment_map;
+    // 2. Consuming the raw dense topology from cc::Map, grouped by segment.
+    std::map<SegmentId, RawNodeList> raw_segment_map;
     assert(_world_map != nullptr && "No map reference found.");
     auto raw_dense_topology = _world_map->GenerateWaypoints(MAP_RESOLUTION);
     for (auto &waypoint_ptr: raw_dense_topology) {
-      segment_map[GetSegmentId(waypoint_ptr)].emplace_back(std::make_shared<SimpleWaypoint>(waypoint_ptr));
+      raw_segment_map[GetSegmentId(waypoint_ptr)].emplace_back(waypoint_ptr);
     }
 
     // 3. Processing waypoints.
@@ -234,8 +615,8 @@ namespace traffic_manager {
       return cg::Math::DistanceSquared(l1, l2);
     };
     auto square = [](float input) {return std::pow(input, 2);};
-    auto compare_s = [](const SimpleWaypointPtr &swp1, const SimpleWaypointPtr &swp2) {
-      return (swp1->GetWaypoint()->GetDistance() < swp2->GetWaypoint()->GetDistance());
+    auto compare_s = [](const WaypointPtr &wp1, const WaypointPtr &wp2) {
+      return (wp1->GetDistance() < wp2->GetDistance());
     };
     auto wpt_angle = [](cg::Vector3D l1, cg::Vector3D l2) {
       return cg::Math::GetVectorAngle(l1, l2);
@@ -244,23 +625,20 @@ namespace traffic_manager {
       return x ^ ((x ^ y) & -(x < y));
     };
 
-    GeoGridId geodesic_grid_id_counter = -1;
-    for (auto &segment: segment_map) {
+    std::size_t total_waypoints = 0u;
+    for (auto &segment: raw_segment_map) {
       auto &segment_waypoints = segment.second;
 
-      // Generating geodesic grid ids.
-      ++geodesic_grid_id_counter;
-
       // Ordering waypoints according to road direction.
       std::sort(segment_waypoints.begin(), segment_waypoints.end(), compare_s);
-      auto lane_id = segment_waypoints.front()->GetWaypoint()->GetLaneId();
+      auto lane_id = segment_waypoints.front()->GetLaneId();
       if (lane_id > 0) {
         std::reverse(segment_waypoints.begin(), segment_waypoints.end());
       }
 
       // Adding more waypoints if the angle is too tight or if they are too distant.
       for (std::size_t i = 0; i < segment_waypoints.size() - 1; ++i) {
-          double distance = std::abs(segment_waypoints.at(i)->GetWaypoint()->GetDistance() - segment_waypoints.at(i+1)->GetWaypoint()->GetDistance());
+          double distance = std::abs(segment_waypoints.at(i)->GetDistance() - segment_waypoints.at(i+1)->GetDistance());
           double angle = wpt_angle(segment_waypoints.at(i)->GetTransform().GetForwardVector(), segment_waypoints.at(i+1)->GetTransform().GetForwardVector());
           int16_t angle_splits = static_cast<int16_t>(angle/MAX_WPT_RADIANS);
           int16_t distance_splits = static_cast<int16_t>((distance*distance)/MAX_WPT_DISTANCE);
@@ -268,11 +646,11 @@ namespace traffic_manager {
           if (max_splits >= 1) {
             // Compute how many waypoints do we need to generate.
             for (uint16_t j = 0; j < max_splits; ++j) {
-              auto next_waypoints = segment_waypoints.at(i)->GetWaypoint()->GetNext(distance/(max_splits+1));
+              auto next_waypoints = segment_waypoints.at(i)->GetNext(distance/(max_splits+1));
               if (next_waypoints.size() != 0) {
                 auto new_waypoint = next_waypoints.front();
                 i++;
-                segment_waypoints.insert(segment_waypoints.begin()+static_cast<int64_t>(i), std::make_shared<SimpleWaypoint>(new_waypoint));
+                segment_waypoints.insert(segment_waypoints.begin()+static_cast<int64_t>(i), new_waypoint);
               } else {
                 // Reached end of the road.
                 break;
@@ -281,6 +659,31 @@ namespace traffic_manager {
           }
         }
 
+      total_waypoints += segment_waypoints.size();
+    }
+
+    // 4. Storing the waypoints contiguously, in segment order.
+    waypoints.reserve(total_waypoints);
+    SegmentMap segment_map;
+    for (auto &segment: raw_segment_map) {
+      auto &segment_waypoints = segment_map[segment.first];
+      segment_waypoints.reserve(segment.second.size());
+      for (auto &waypoint_ptr: segment.second) {
+        segment_waypoints.push_back(AddWaypoint(waypoint_ptr));
+      }
+    }
+    raw_segment_map.clear();
+
+    AdjacencyLists next_lists(total_waypoints);
+    AdjacencyLists previous_lists(total_waypoints);
+
+    GeoGridId geodesic_grid_id_counter = -1;
+    for (auto &segment: segment_map) {
+      auto &segment_waypoints = segment.second;
+
+      // Generating geodesic grid ids.
+      ++geodesic_grid_id_counter;
+
       // Placing intra-segment connections.
       cg::Location grid_edge_location = segment_waypoints.front()->GetLocation();
       for (std::size_t i = 0; i < segment_waypoints.size() - 1; ++i) {
@@ -294,13 +697,13 @@ namespace traffic_manager {
         }
         current_waypoint->SetGeodesicGridId(geodesic_grid_id_counter);
 
-        current_waypoint->SetNextWaypoint({next_waypoint});
-        next_waypoint->SetPreviousWaypoint({current_waypoint});
+        next_lists.at(current_waypoint->GetIndex()).push_back(next_waypoint);
+        previous_lists.at(next_waypoint->GetIndex()).push_back(current_waypoint);
 
       }
       segment_waypoints.back()->SetGeodesicGridId(geodesic_grid_id_counter);
 
-      // Adding simple waypoints to processed dense topology.
+      // Setting the junction flag of the waypoints.
       for (auto swp: segment_waypoints) {
         // Checking whether the waypoint is in a real junction.
         auto wpt = swp->GetWaypoint();
@@ -310,8 +713,6 @@ namespace traffic_manager {
         } else {
           swp->SetIsJunction(swp->GetWaypoint()->IsJunction());
         }
-
-        dense_topology.push_back(swp);
       }
     }
 
@@ -325,8 +726,10 @@ namespace traffic_manager {
       auto successors = GetSuccessors(segment_id, segment_topology, segment_map);
       auto predecessors = GetPredecessors(segment_id, segment_topology, segment_map);
 
-      segment_waypoints.front()->SetPreviousWaypoint(predecessors);
-      segment_waypoints.back()->SetNextWaypoint(successors);
+      NodeList &front_previous = previous_lists.at(segment_waypoints.front()->GetIndex());
+      front_previous.insert(front_previous.end(), predecessors.begin(), predecessors.end());
+      NodeList &back_next = next_lists.at(segment_waypoints.back()->GetIndex());
+      back_next.insert(back_next.end(), successors.begin(), successors.end());
     }
 
     // Linking lane change connections.
@@ -338,38 +741,46 @@ namespace traffic_manager {
 
     // Linking any unconnected segments.
     for (auto &swp : dense_topology) {
-      if (swp->GetNextWaypoint().empty()) {
+      NodeList &swp_next = next_lists.at(swp->GetIndex());
+      if (swp_next.empty()) {
         auto neighbour = swp->GetRightWaypoint();
         if (!neighbour) {
           neighbour = swp->GetLeftWaypoint();
         }
 
         if (neighbour) {
-          swp->SetNextWaypoint(neighbour->GetNextWaypoint());
-          for (auto next_waypoint : neighbour->GetNextWaypoint()) {
-            next_waypoint->SetPreviousWaypoint({swp});
+          swp_next = next_lists.at(neighbour->GetIndex());
+          for (auto next_waypoint : swp_next) {
+            previous_lists.at(next_waypoint->GetIndex()).push_back(swp);
           }
         }
       }
     }
 
+    SetUpAdjacency(next_lists, previous_lists);
+
     // Specifying a RoadOption for each SimpleWaypoint
     SetUpRoadOption();
   }
 
   void InMemoryMap::SetUpSpatialTree() {
+    std::vector<SpatialTreeEntry> entries;
+    entries.reserve(dense_topology.size());
     for (auto &simple_waypoint: dense_topology) {
       if (simple_waypoint != nullptr) {
         const cg::Location loc = simple_waypoint->GetLocation();
         Point3D point(loc.x, loc.y, loc.z);
-        rtree.insert(std::make_pair(point, simple_waypoint));
+        entries.emplace_back(point, simple_waypoint);
       }
     }
+    // Build the whole tree at once with the packing algorithm, which is much
+    // faster than inserting the waypoints one by one.
+    rtree = Rtree(entries.begin(), entries.end());
   }
 
   void InMemoryMap::SetUpRoadOption() {
     for (auto &swp : dense_topology) {
-      std::vector<SimpleWaypointPtr> next_waypoints = swp->GetNextWaypoint();
+      const WaypointRange next_waypoints = swp->GetNextWaypoint();
       std::size_t next_swp_size = next_waypoints.size();
 
       if (next_swp_size == 0) {
@@ -420,7 +831,7 @@ namespace traffic_manager {
 
             while (junction_end_waypoint->CheckJunction()){
               traversed_waypoints.push_back(junction_end_waypoint);
-              std::vector<SimpleWaypointPtr> temp = junction_end_waypoint->GetNextWaypoint();
+              const WaypointRange temp = junction_end_waypoint->GetNextWaypoint();
               if (temp.empty()) {
                 break;
               }
@@ -464,7 +875,7 @@ namespace traffic_manager {
     rtree.query(bgi::nearest(query_point, 1), std::back_inserter(result_1));
 
     SpatialTreeEntry &closest_entry = result_1.front();
-    SimpleWaypointPtr &closest_point = closest_entry.second;
+    SimpleWaypointPtr closest_point = closest_entry.second;
 
     return closest_point;
   }
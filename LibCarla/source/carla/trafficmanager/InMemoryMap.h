@@ -20,6 +20,7 @@
 #include "carla/geom/Location.h"
 #include "carla/geom/Math.h"
 #include "carla/Memory.h"
+#include "carla/NonCopyable.h"
 #include "carla/road/RoadTypes.h"
 
 #include "carla/trafficmanager/RandomGenerator.h"
@@ -36,8 +37,8 @@ namespace bg = boost::geometry;
 namespace bgi = boost::geometry::index;
 
   using WaypointPtr = carla::SharedPtr<cc::Waypoint>;
-  using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
   using NodeList = std::vector<SimpleWaypointPtr>;
+  using AdjacencyLists = std::vector<NodeList>;
   using GeoGridId = crd::JuncId;
   using WorldMap = carla::SharedPtr<const cc::Map>;
 
@@ -53,7 +54,11 @@ namespace bgi = boost::geometry::index;
   /// This class builds a discretized local map-cache.
   /// Instantiate the class with the world and run SetUp() to construct the
   /// local map.
-  class InMemoryMap {
+  /// The waypoints are stored contiguously and addressed by their index, and
+  /// their connections are ranges of two flat adjacency arrays. Neither is
+  /// resized once the map is built, so the waypoints can be referenced by
+  /// pointer for the lifetime of the map.
+  class InMemoryMap : private NonCopyable {
 
   private:
 
@@ -61,9 +66,17 @@ namespace bgi = boost::geometry::index;
     WorldMap _world_map;
     /// Structure to hold all custom waypoint objects after interpolation of
     /// sparse topology.
+    std::vector<SimpleWaypoint> waypoints;
+    /// Pointers to the waypoints, in the same order.
     NodeList dense_topology;
+    /// Next and previous waypoints of all the waypoints, one range after the
+    /// other in the order of the waypoints.
+    NodeList next_adjacency;
+    NodeList previous_adjacency;
     /// Spatial quadratic R-tree for indexing and querying waypoints.
     Rtree rtree;
+    /// Hash of the OpenDRIVE of the map, identifying its local cache.
+    uint64_t opendrive_hash = 0u;
 
   public:
 
@@ -75,6 +88,18 @@ namespace bgi = boost::geometry::index;
     //bool Load(const std::string& filename);
     bool Load(const std::vector<uint8_t>& content);
 
+    /// Loads the map from a local cache written by SaveCache() for the same
+    /// OpenDRIVE. Returns false, leaving the map empty, if the cache is
+    /// missing, outdated or corrupted.
+    bool LoadCache(const std::string& path);
+
+    /// Writes the map, once set up or loaded, to a local cache.
+    bool SaveCache(const std::string& path) const;
+
+    /// Returns the path of the local cache of this map in the files folder
+    /// of the client.
+    std::string GetCachePath() const;
+
     /// This method constructs the local map with a resolution of sampling_resolution.
     void SetUp();
 
@@ -94,13 +119,22 @@ namespace bgi = boost::geometry::index;
   private:
     void Save(const std::string& path);
 
+    /// Removes all the waypoints of the map.
+    void Clear();
+
     void SetUpDenseTopology();
     void SetUpSpatialTree();
+    /// Flattens the connections of each waypoint, by waypoint index, into
+    /// the adjacency arrays.
+    void SetUpAdjacency(const AdjacencyLists &next_lists, const AdjacencyLists &previous_lists);
     void SetUpRoadOption();
 
     /// This method is used to find and place lane change links.
     void FindAndLinkLaneChange(SimpleWaypointPtr reference_waypoint);
 
+    /// Adds a waypoint to the map, which must have room for it.
+    SimpleWaypointPtr AddWaypoint(WaypointPtr waypoint);
+
     NodeList GetSuccessors(const SegmentId segment_id,
                           const SegmentTopology &segment_topology,
                           const SegmentMap &segment_map);
@@ -15,6 +15,7 @@ using namespace constants::MotionPlan;
 
 LocalizationStage::LocalizationStage(
   const std::vector<ActorId> &vehicle_id_list,
+  const std::vector<StateSlot> &vehicle_slot_list,
   BufferMap &buffer_map,
   const SimulationState &simulation_state,
   TrackTraffic &track_traffic,
@@ -24,6 +25,7 @@ LocalizationStage::LocalizationStage(
   LocalizationFrame &output_array,
   RandomGenerator &random_device)
     : vehicle_id_list(vehicle_id_list),
+    vehicle_slot_list(vehicle_slot_list),
     buffer_map(buffer_map),
     simulation_state(simulation_state),
     track_traffic(track_traffic),
@@ -36,9 +38,10 @@ LocalizationStage::LocalizationStage(
 void LocalizationStage::Update(const unsigned long index) {
 
   const ActorId actor_id = vehicle_id_list.at(index);
-  const cg::Location vehicle_location = simulation_state.GetLocation(actor_id);
-  const cg::Vector3D heading_vector = simulation_state.GetHeading(actor_id);
-  const cg::Vector3D vehicle_velocity_vector = simulation_state.GetVelocity(actor_id);
+  const StateSlot slot = vehicle_slot_list.at(index);
+  const cg::Location vehicle_location = simulation_state.GetLocation(slot);
+  const cg::Vector3D heading_vector = simulation_state.GetHeading(slot);
+  const cg::Vector3D vehicle_velocity_vector = simulation_state.GetVelocity(slot);
   const float vehicle_speed = vehicle_velocity_vector.Length();
 
   // Speed dependent waypoint horizon length.
@@ -82,7 +85,7 @@ void LocalizationStage::Update(const unsigned long index) {
       bool front_waypoint_junction = front_waypoint->CheckJunction();
       is_at_junction_entrance = !front_waypoint_junction && look_ahead_point->CheckJunction();
       if (!is_at_junction_entrance) {
-        std::vector<SimpleWaypointPtr> last_passed_waypoints = front_waypoint->GetPreviousWaypoint();
+        const WaypointRange last_passed_waypoints = front_waypoint->GetPreviousWaypoint();
         if (last_passed_waypoints.size() == 1) {
           is_at_junction_entrance = !last_passed_waypoints.front()->CheckJunction() && front_waypoint_junction;
         }
@@ -191,7 +194,7 @@ void LocalizationStage::Update(const unsigned long index) {
   else {
     while (waypoint_buffer.back()->DistanceSquared(waypoint_buffer.front()) <= horizon_square) {
       SimpleWaypointPtr furthest_waypoint = waypoint_buffer.back();
-      std::vector<SimpleWaypointPtr> next_waypoints = furthest_waypoint->GetNextWaypoint();
+      const WaypointRange next_waypoints = furthest_waypoint->GetNextWaypoint();
       uint64_t selection_index = 0u;
       // Pseudo-randomized path selection if found more than one choice.
       if (next_waypoints.size() > 1) {
@@ -270,7 +273,7 @@ void LocalizationStage::ExtendAndFindSafeSpace(const ActorId actor_id,
       bool abort = false;
 
       while (!past_junction && !abort) {
-        NodeList next_waypoints = current_waypoint->GetNextWaypoint();
+        const WaypointRange next_waypoints = current_waypoint->GetNextWaypoint();
         if (!next_waypoints.empty()) {
           current_waypoint = next_waypoints.front();
           PushWaypoint(actor_id, track_traffic, waypoint_buffer, current_waypoint);
@@ -284,7 +287,7 @@ void LocalizationStage::ExtendAndFindSafeSpace(const ActorId actor_id,
       }
 
       while (!safe_point_found && !abort) {
-        std::vector<SimpleWaypointPtr> next_waypoints = current_waypoint->GetNextWaypoint();
+        const WaypointRange next_waypoints = current_waypoint->GetNextWaypoint();
         if ((junction_end_point->DistanceSquared(current_waypoint) > safe_distance_squared)
             || next_waypoints.size() > 1
             || current_waypoint->CheckJunction()) {
@@ -471,7 +474,7 @@ void LocalizationStage::ImportPath(Path &imported_path, Buffer &waypoint_buffer,
       SimpleWaypointPtr latest_waypoint = waypoint_buffer.back();
 
       // Try to link the latest_waypoint to the imported waypoint.
-      std::vector<SimpleWaypointPtr> next_waypoints = latest_waypoint->GetNextWaypoint();
+      const WaypointRange next_waypoints = latest_waypoint->GetNextWaypoint();
       uint64_t selection_index = 0u;
 
       // Choose correct path.
@@ -512,7 +515,7 @@ void LocalizationStage::ImportPath(Path &imported_path, Buffer &waypoint_buffer,
       // Remove the imported waypoint from the path if it's close to the last one.
       if (next_wp_selection->DistanceSquared(imported) < 30.0f) {
         imported_path.erase(imported_path.begin());
-        std::vector<SimpleWaypointPtr> possible_waypoints = next_wp_selection->GetNextWaypoint();
+        const WaypointRange possible_waypoints = next_wp_selection->GetNextWaypoint();
         if (std::find(possible_waypoints.begin(), possible_waypoints.end(), imported) != possible_waypoints.end()) {
           // If the lane is changing, only push the new waypoint
           PushWaypoint(actor_id, track_traffic, waypoint_buffer, next_wp_selection);
@@ -550,7 +553,7 @@ void LocalizationStage::ImportRoute(Route &imported_actions, Buffer &waypoint_bu
       SimpleWaypointPtr latest_waypoint = waypoint_buffer.back();
       RoadOption latest_road_option = latest_waypoint->GetRoadOption();
       // Try to link the latest_waypoint to the correct next RouteOption.
-      std::vector<SimpleWaypointPtr> next_waypoints = latest_waypoint->GetNextWaypoint();
+      const WaypointRange next_waypoints = latest_waypoint->GetNextWaypoint();
       uint16_t selection_index = 0u;
       if (next_waypoints.size() > 1) {
         for (uint16_t i=0; i<next_waypoints.size(); ++i) {
@@ -32,6 +32,7 @@ using Route = std::vector<uint8_t>;
 class LocalizationStage : Stage {
 private:
   const std::vector<ActorId> &vehicle_id_list;
+  const std::vector<StateSlot> &vehicle_slot_list;
   BufferMap &buffer_map;
   const SimulationState &simulation_state;
   TrackTraffic &track_traffic;
@@ -67,6 +68,7 @@ private:
 
 public:
   LocalizationStage(const std::vector<ActorId> &vehicle_id_list,
+                    const std::vector<StateSlot> &vehicle_slot_list,
                     BufferMap &buffer_map,
                     const SimulationState &simulation_state,
                     TrackTraffic &track_traffic,
@@ -36,7 +36,7 @@ float DeviationDotProduct(const cg::Location &reference_location,
 }
 
 void PushWaypoint(ActorId actor_id, TrackTraffic &track_traffic,
-                  Buffer &buffer, SimpleWaypointPtr &waypoint) {
+                  Buffer &buffer, const SimpleWaypointPtr &waypoint) {
 
   const uint64_t waypoint_id = waypoint->GetId();
   buffer.push_back(waypoint);
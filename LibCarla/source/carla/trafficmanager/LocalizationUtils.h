@@ -26,8 +26,7 @@ namespace traffic_manager {
   using Actor = carla::SharedPtr<cc::Actor>;
   using ActorId = carla::ActorId;
   using ActorIdSet = std::unordered_set<ActorId>;
-  using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
-  using Buffer = std::deque<SimpleWaypointPtr>;
+  using Buffer = RingBuffer<SimpleWaypointPtr>;
   using GeoGridId = carla::road::JuncId;
   using constants::Map::MAP_RESOLUTION;
   using constants::Map::INV_MAP_RESOLUTION;
@@ -46,7 +45,7 @@ namespace traffic_manager {
 
   // Function to add a waypoint to a path buffer and update waypoint tracking.
   void PushWaypoint(ActorId actor_id, TrackTraffic& track_traffic,
-                    Buffer& buffer, SimpleWaypointPtr& waypoint);
+                    Buffer& buffer, const SimpleWaypointPtr& waypoint);
 
   // Function to remove a waypoint from a path buffer and update waypoint tracking.
   void PopWaypoint(ActorId actor_id, TrackTraffic& track_traffic,
@@ -28,6 +28,7 @@ using constants::Collision::EPSILON;
 
 MotionPlanStage::MotionPlanStage(
   const std::vector<ActorId> &vehicle_id_list,
+  const std::vector<StateSlot> &vehicle_slot_list,
   SimulationState &simulation_state,
   const Parameters &parameters,
   const BufferMap &buffer_map,
@@ -44,6 +45,7 @@ MotionPlanStage::MotionPlanStage(
   RandomGenerator &random_device,
   const LocalMapPtr &local_map)
     : vehicle_id_list(vehicle_id_list),
+    vehicle_slot_list(vehicle_slot_list),
     simulation_state(simulation_state),
     parameters(parameters),
     buffer_map(buffer_map),
@@ -62,18 +64,20 @@ MotionPlanStage::MotionPlanStage(
 
 void MotionPlanStage::Update(const unsigned long index) {
   const ActorId actor_id = vehicle_id_list.at(index);
-  const cg::Location vehicle_location = simulation_state.GetLocation(actor_id);
-  const cg::Vector3D vehicle_velocity = simulation_state.GetVelocity(actor_id);
-  const cg::Rotation vehicle_rotation = simulation_state.GetRotation(actor_id);
+  const StateSlot slot = vehicle_slot_list.at(index);
+  const cg::Location vehicle_location = simulation_state.GetLocation(slot);
+  const cg::Vector3D vehicle_velocity = simulation_state.GetVelocity(slot);
+  const cg::Rotation vehicle_rotation = simulation_state.GetRotation(slot);
   const float vehicle_speed = vehicle_velocity.Length();
-  const cg::Vector3D vehicle_heading = simulation_state.GetHeading(actor_id);
-  const bool vehicle_physics_enabled = simulation_state.IsPhysicsEnabled(actor_id);
-  const float vehicle_speed_limit = simulation_state.GetSpeedLimit(actor_id);
+  const cg::Vector3D vehicle_heading = simulation_state.GetHeading(slot);
+  const bool vehicle_physics_enabled = simulation_state.IsPhysicsEnabled(slot);
+  const float vehicle_speed_limit = simulation_state.GetSpeedLimit(slot);
+  const bool vehicle_dormant = simulation_state.IsDormant(slot);
   const Buffer &waypoint_buffer = buffer_map.at(actor_id);
   const LocalizationData &localization = localization_frame.at(index);
   const CollisionHazardData &collision_hazard = collision_frame.at(index);
   const bool &tl_hazard = tl_frame.at(index);
-  current_timestamp = world.GetSnapshot().GetTimestamp();
+  const cc::Timestamp current_timestamp = world.GetSnapshot().GetTimestamp();
   StateEntry current_state;
 
   // Instanciating teleportation transform as current vehicle transform.
@@ -83,25 +87,20 @@ void MotionPlanStage::Update(const unsigned long index) {
   cg::Location hero_location = track_traffic.GetHeroLocation();
   bool is_hero_alive = hero_location != cg::Location(0, 0, 0);
 
-  if (simulation_state.IsDormant(actor_id) && parameters.GetRespawnDormantVehicles() && is_hero_alive) {
+  if (vehicle_dormant && parameters.GetRespawnDormantVehicles() && is_hero_alive) {
     // Flushing controller state for vehicle.
     current_state = {current_timestamp,
                     0.0f, 0.0f,
                     0.0f};
 
-    // Add entry to teleportation duration clock table if not present.
-    if (teleportation_instance.find(actor_id) == teleportation_instance.end()) {
-      teleportation_instance.insert({actor_id, current_timestamp});
-    }
+    // Measuring time elapsed since last teleportation for the vehicle.
+    const double elapsed_time = GetTimeSinceTeleportation(actor_id, current_timestamp);
 
     // Get lower and upper bound for teleporting vehicle.
     float lower_bound = parameters.GetLowerBoundaryRespawnDormantVehicles();
     float upper_bound = parameters.GetUpperBoundaryRespawnDormantVehicles();
     float dilate_factor = (upper_bound-lower_bound)/100.0f;
 
-    // Measuring time elapsed since last teleportation for the vehicle.
-    double elapsed_time = current_timestamp.elapsed_seconds - teleportation_instance.at(actor_id).elapsed_seconds;
-
     if (parameters.GetSynchronousMode() || elapsed_time > HYBRID_MODE_DT) {
       float random_sample = (static_cast<float>(random_device.next())*dilate_factor) + lower_bound;
       NodeList teleport_waypoint_list = local_map->GetWaypointsInDelta(hero_location, ATTEMPTS_TO_TELEPORT, random_sample);
@@ -123,9 +122,9 @@ void MotionPlanStage::Update(const unsigned long index) {
     KinematicState kinematic_state{teleportation_transform.location,
                                    teleportation_transform.rotation,
                                    vehicle_velocity, vehicle_speed_limit,
-                                   vehicle_physics_enabled, simulation_state.IsDormant(actor_id),
+                                   vehicle_physics_enabled, vehicle_dormant,
                                    teleportation_transform.location};
-    simulation_state.UpdateKinematicState(actor_id, kinematic_state);
+    simulation_state.UpdateKinematicState(slot, kinematic_state);
   }
 
   else {
@@ -152,7 +151,7 @@ void MotionPlanStage::Update(const unsigned long index) {
     // In case of collision or traffic light hazard.
     bool emergency_stop = tl_hazard || collision_emergency_stop || !safe_after_junction;
 
-    if (vehicle_physics_enabled && !simulation_state.IsDormant(actor_id)) {
+    if (vehicle_physics_enabled && !vehicle_dormant) {
       ActuationSignal actuation_signal{0.0f, 0.0f, 0.0f};
 
       const float target_point_distance = std::max(vehicle_speed * TARGET_WAYPOINT_TIME_HORIZON,
@@ -173,16 +172,14 @@ void MotionPlanStage::Update(const unsigned long index) {
       }
       const float angular_deviation = dot_product;
       const float velocity_deviation = (dynamic_target_velocity - vehicle_speed) / dynamic_target_velocity;
-      // If previous state for vehicle not found, initialize state entry.
-      if (pid_state_map.find(actor_id) == pid_state_map.end()) {
+      // Retrieving the previous state, initializing the entry if not found.
+      traffic_manager::StateEntry previous_state;
+      {
+        std::lock_guard<std::mutex> lock(state_mutex);
         const auto initial_state = StateEntry{current_timestamp, 0.0f, 0.0f, 0.0f};
-        pid_state_map.insert({actor_id, initial_state});
+        previous_state = pid_state_map.insert({actor_id, initial_state}).first->second;
       }
 
-      // Retrieving the previous state.
-      traffic_manager::StateEntry previous_state;
-      previous_state = pid_state_map.at(actor_id);
-
       // Select PID parameters.
       std::vector<float> longitudinal_parameters;
       std::vector<float> lateral_parameters;
@@ -218,6 +215,7 @@ void MotionPlanStage::Update(const unsigned long index) {
 
       // Updating PID state.
       current_state.steer = actuation_signal.steer;
+      std::lock_guard<std::mutex> lock(state_mutex);
       StateEntry &state = pid_state_map.at(actor_id);
       state = current_state;
     }
@@ -228,13 +226,8 @@ void MotionPlanStage::Update(const unsigned long index) {
                       0.0f, 0.0f,
                       0.0f};
 
-      // Add entry to teleportation duration clock table if not present.
-      if (teleportation_instance.find(actor_id) == teleportation_instance.end()) {
-        teleportation_instance.insert({actor_id, current_timestamp});
-      }
-
       // Measuring time elapsed since last teleportation for the vehicle.
-      double elapsed_time = current_timestamp.elapsed_seconds - teleportation_instance.at(actor_id).elapsed_seconds;
+      const double elapsed_time = GetTimeSinceTeleportation(actor_id, current_timestamp);
 
       // Find a location ahead of the vehicle for teleportation to achieve intended velocity.
       if (!emergency_stop && (parameters.GetSynchronousMode() || elapsed_time > HYBRID_MODE_DT)) {
@@ -258,15 +251,23 @@ void MotionPlanStage::Update(const unsigned long index) {
       // In case of an emergency stop, stay in the same location.
       // Also, teleport only once every dt in asynchronous mode.
       } else {
-        teleportation_transform = cg::Transform(vehicle_location, simulation_state.GetRotation(actor_id));
+        teleportation_transform = cg::Transform(vehicle_location, vehicle_rotation);
       }
       // Constructing the actuation signal.
       output_array.at(index) = carla::rpc::Command::ApplyTransform(actor_id, teleportation_transform);
-      simulation_state.UpdateKinematicHybridEndLocation(actor_id, teleportation_transform.location);
+      simulation_state.UpdateKinematicHybridEndLocation(slot, teleportation_transform.location);
     }
   }
 }
 
+double MotionPlanStage::GetTimeSinceTeleportation(const ActorId actor_id,
+                                                  const cc::Timestamp &current_timestamp) {
+  std::lock_guard<std::mutex> lock(state_mutex);
+  // Add entry to teleportation duration clock table if not present.
+  const cc::Timestamp &last_teleportation = teleportation_instance.insert({actor_id, current_timestamp}).first->second;
+  return current_timestamp.elapsed_seconds - last_teleportation.elapsed_seconds;
+}
+
 bool MotionPlanStage::SafeAfterJunction(const LocalizationData &localization,
                                         const bool tl_hazard,
                                         const bool collision_emergency_stop) {
@@ -466,11 +467,13 @@ float MotionPlanStage::GetThreePointCircleRadius(cg::Location first_location,
 }
 
 void MotionPlanStage::RemoveActor(const ActorId actor_id) {
+  std::lock_guard<std::mutex> lock(state_mutex);
   pid_state_map.erase(actor_id);
   teleportation_instance.erase(actor_id);
 }
 
 void MotionPlanStage::Reset() {
+  std::lock_guard<std::mutex> lock(state_mutex);
   pid_state_map.clear();
   teleportation_instance.clear();
 }
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <mutex>
+
 #include "carla/trafficmanager/DataStructures.h"
 #include "carla/trafficmanager/InMemoryMap.h"
 #include "carla/trafficmanager/LocalizationUtils.h"
@@ -22,6 +24,7 @@ using TLMap = std::unordered_map<std::string, SharedPtr<client::Actor>>;
 class MotionPlanStage: Stage {
 private:
   const std::vector<ActorId> &vehicle_id_list;
+  const std::vector<StateSlot> &vehicle_slot_list;
   SimulationState &simulation_state;
   const Parameters &parameters;
   const BufferMap &buffer_map;
@@ -40,8 +43,9 @@ private:
   // Structure to keep track of duration between teleportation
   // in hybrid physics mode.
   std::unordered_map<ActorId, cc::Timestamp> teleportation_instance;
+  // Guards the two maps above, vehicles can be updated in parallel.
+  std::mutex state_mutex;
   ControlFrame &output_array;
-  cc::Timestamp current_timestamp;
   RandomGenerator &random_device;
   const LocalMapPtr &local_map;
 
@@ -51,6 +55,9 @@ private:
                                            const cg::Vector3D ego_heading,
                                            const float max_target_velocity);
 
+  double GetTimeSinceTeleportation(const ActorId actor_id,
+                                   const cc::Timestamp &current_timestamp);
+
   bool SafeAfterJunction(const LocalizationData &localization,
                          const bool tl_hazard,
                          const bool collision_emergency_stop);
@@ -69,6 +76,7 @@ private:
 
 public:
   MotionPlanStage(const std::vector<ActorId> &vehicle_id_list,
+                  const std::vector<StateSlot> &vehicle_slot_list,
                   SimulationState &simulation_state,
                   const Parameters &parameters,
                   const BufferMap &buffer_map,
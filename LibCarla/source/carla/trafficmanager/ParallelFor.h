@@ -0,0 +1,103 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "carla/NonCopyable.h"
+#include "carla/ThreadPool.h"
+
+#include "carla/trafficmanager/Constants.h"
+
+namespace carla {
+namespace traffic_manager {
+
+using constants::ParallelStages::VEHICLES_PER_CHUNK;
+
+/// Runs the per-vehicle loops of the stages on several threads. The vehicles
+/// are handed out in small chunks from a shared counter, so the threads that
+/// finish their vehicles early keep taking the ones left by the slower ones.
+class ParallelFor : private NonCopyable {
+public:
+
+  /// Number of threads running the loops, including the calling one. With
+  /// one thread (or none) the loops run serially.
+  void SetNumberOfThreads(const uint64_t number_of_threads) {
+    const uint64_t threads = std::max<uint64_t>(number_of_threads, 1u);
+    if (threads == total_threads) {
+      return;
+    }
+    pool.reset();
+    if (threads > 1u) {
+      pool = std::make_unique<ThreadPool>();
+      pool->AsyncRun(threads - 1u);
+    }
+    total_threads = threads;
+  }
+
+  uint64_t GetNumberOfThreads() const {
+    return total_threads;
+  }
+
+  /// Call @a functor with every index from 0 to @a size - 1, returning once
+  /// all the calls have finished.
+  template <typename FunctorT>
+  void Run(const unsigned long size, FunctorT &&functor) {
+    if (pool == nullptr || size <= VEHICLES_PER_CHUNK) {
+      for (unsigned long index = 0u; index < size; ++index) {
+        functor(index);
+      }
+      return;
+    }
+
+    std::atomic<unsigned long> next_index{0u};
+    auto work = [&]() {
+      unsigned long begin;
+      while ((begin = next_index.fetch_add(VEHICLES_PER_CHUNK)) < size) {
+        const unsigned long end = std::min(begin + VEHICLES_PER_CHUNK, size);
+        for (unsigned long index = begin; index < end; ++index) {
+          functor(index);
+        }
+      }
+    };
+
+    const uint64_t helpers = std::min<uint64_t>(total_threads - 1u, (size - 1u) / VEHICLES_PER_CHUNK);
+    std::vector<std::future<void>> results;
+    results.reserve(helpers);
+    for (uint64_t i = 0u; i < helpers; ++i) {
+      results.emplace_back(pool->Post(work));
+    }
+    // the helpers use the variables of this scope, wait for all of them
+    // before leaving it, even on errors
+    try {
+      work();
+    } catch (...) {
+      for (auto &result : results) {
+        result.wait();
+      }
+      throw;
+    }
+    for (auto &result : results) {
+      result.wait();
+    }
+    for (auto &result : results) {
+      result.get();
+    }
+  }
+
+private:
+
+  std::unique_ptr<ThreadPool> pool;
+  uint64_t total_threads {1u};
+};
+
+} // namespace traffic_manager
+} // namespace carla
@@ -189,6 +189,10 @@ void Parameters::SetHybridPhysicsRadius(const float radius) {
   hybrid_physics_radius.store(new_radius);
 }
 
+void Parameters::SetWorkerThreads(const uint64_t threads) {
+  worker_threads.store(std::max<uint64_t>(threads, 1u));
+}
+
 void Parameters::SetOSMMode(const bool mode_switch) {
   osm_mode.store(mode_switch);
 }
@@ -242,6 +246,11 @@ float Parameters::GetHybridPhysicsRadius() const {
   return hybrid_physics_radius.load();
 }
 
+uint64_t Parameters::GetWorkerThreads() const {
+
+  return worker_threads.load();
+}
+
 bool Parameters::GetSynchronousMode() const {
   return synchronous_mode.load();
 }
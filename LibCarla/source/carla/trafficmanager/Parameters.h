@@ -89,6 +89,8 @@ private:
   float max_upper_bound;
   /// Hybrid physics radius.
   std::atomic<float> hybrid_physics_radius {70.0};
+  /// Number of threads running the per-vehicle loops of the stages.
+  std::atomic<uint64_t> worker_threads {1u};
   /// Parameter specifying Open Street Map mode.
   std::atomic<bool> osm_mode {true};
   /// Parameter specifying if importing a custom path.
@@ -181,6 +183,9 @@ public:
   /// Method to set hybrid physics radius.
   void SetHybridPhysicsRadius(const float radius);
 
+  /// Method to set the number of threads running the stages.
+  void SetWorkerThreads(const uint64_t threads);
+
   /// Method to set Open Street Map mode.
   void SetOSMMode(const bool mode_switch);
 
@@ -216,6 +221,9 @@ public:
   /// Method to retrieve hybrid physics radius.
   float GetHybridPhysicsRadius() const;
 
+  /// Method to retrieve the number of threads running the stages.
+  uint64_t GetWorkerThreads() const;
+
   /// Method to query target velocity for a vehicle.
   float GetVehicleTargetVelocity(const ActorId &actor_id, const float speed_limit) const;
 
@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include <mutex>
 #include <random>
 #include <unordered_map>
 
@@ -9,11 +10,23 @@
 namespace carla {
 namespace traffic_manager {
 
+/// Random numbers shared by all the stages. It can be used from the stages
+/// running in parallel, although then the sequence of numbers each vehicle
+/// gets depends on the scheduling of the threads.
 class RandomGenerator {
 public:
     RandomGenerator(const uint64_t seed): mt(std::mt19937(seed)), dist(0.0, 100.0) {}
-    double next() { return dist(mt); }
+    double next() {
+      std::lock_guard<std::mutex> lock(mutex);
+      return dist(mt);
+    }
+    void seed(const uint64_t seed) {
+      std::lock_guard<std::mutex> lock(mutex);
+      mt.seed(static_cast<std::mt19937::result_type>(seed));
+      dist.reset();
+    }
 private:
+    std::mutex mutex;
     std::mt19937 mt;
     std::uniform_real_distribution<double> dist;
 };
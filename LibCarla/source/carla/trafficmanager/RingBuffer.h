@@ -0,0 +1,196 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+namespace carla {
+namespace traffic_manager {
+
+  /// Double ended queue stored in a single circular array. The capacity grows
+  /// to the next power of two when full and is never released, so a buffer
+  /// that keeps a similar size does not allocate once it is warm.
+  template <typename T>
+  class RingBuffer {
+  public:
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = T &;
+    using const_reference = const T &;
+
+    template <typename BufferT, typename ValueT>
+    class Iterator {
+    public:
+
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = T;
+      using difference_type = std::ptrdiff_t;
+      using pointer = ValueT *;
+      using reference = ValueT &;
+
+      Iterator(BufferT *_buffer, size_type _position) : buffer(_buffer), position(_position) {}
+
+      reference operator*() const {
+        return (*buffer)[position];
+      }
+
+      pointer operator->() const {
+        return &(*buffer)[position];
+      }
+
+      Iterator &operator++() {
+        ++position;
+        return *this;
+      }
+
+      Iterator operator++(int) {
+        Iterator previous = *this;
+        ++position;
+        return previous;
+      }
+
+      bool operator==(const Iterator &rhs) const {
+        return buffer == rhs.buffer && position == rhs.position;
+      }
+
+      bool operator!=(const Iterator &rhs) const {
+        return !(*this == rhs);
+      }
+
+    private:
+
+      BufferT *buffer;
+      size_type position;
+    };
+
+    using iterator = Iterator<RingBuffer, T>;
+    using const_iterator = Iterator<const RingBuffer, const T>;
+
+    size_type size() const {
+      return count;
+    }
+
+    bool empty() const {
+      return count == 0u;
+    }
+
+    reference operator[](size_type position) {
+      return data[(head + position) & mask];
+    }
+
+    const_reference operator[](size_type position) const {
+      return data[(head + position) & mask];
+    }
+
+    reference at(size_type position) {
+      CheckPosition(position);
+      return (*this)[position];
+    }
+
+    const_reference at(size_type position) const {
+      CheckPosition(position);
+      return (*this)[position];
+    }
+
+    reference front() {
+      return (*this)[0u];
+    }
+
+    const_reference front() const {
+      return (*this)[0u];
+    }
+
+    reference back() {
+      return (*this)[count - 1u];
+    }
+
+    const_reference back() const {
+      return (*this)[count - 1u];
+    }
+
+    void push_back(const T &value) {
+      if (count == data.size()) {
+        Grow();
+      }
+      data[(head + count) & mask] = value;
+      ++count;
+    }
+
+    void push_front(const T &value) {
+      if (count == data.size()) {
+        Grow();
+      }
+      head = (head + mask) & mask;
+      data[head] = value;
+      ++count;
+    }
+
+    void pop_front() {
+      data[head] = T();
+      head = (head + 1u) & mask;
+      --count;
+    }
+
+    void pop_back() {
+      data[(head + count - 1u) & mask] = T();
+      --count;
+    }
+
+    void clear() {
+      for (size_type i = 0u; i < count; ++i) {
+        (*this)[i] = T();
+      }
+      head = 0u;
+      count = 0u;
+    }
+
+    iterator begin() {
+      return iterator(this, 0u);
+    }
+
+    iterator end() {
+      return iterator(this, count);
+    }
+
+    const_iterator begin() const {
+      return const_iterator(this, 0u);
+    }
+
+    const_iterator end() const {
+      return const_iterator(this, count);
+    }
+
+  private:
+
+    void CheckPosition(size_type position) const {
+      if (position >= count) {
+        throw std::out_of_range("RingBuffer::at");
+      }
+    }
+
+    void Grow() {
+      std::vector<T> grown(data.empty() ? 16u : 2u * data.size());
+      for (size_type i = 0u; i < count; ++i) {
+        grown[i] = (*this)[i];
+      }
+      data.swap(grown);
+      head = 0u;
+      mask = data.size() - 1u;
+    }
+
+    std::vector<T> data;
+    size_type head = 0u;
+    size_type count = 0u;
+    size_type mask = 0u;
+  };
+
+} // namespace traffic_manager
+} // namespace carla
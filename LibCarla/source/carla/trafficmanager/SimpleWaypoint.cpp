@@ -11,20 +11,19 @@
 namespace carla {
 namespace traffic_manager {
 
-  using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
-
-  SimpleWaypoint::SimpleWaypoint(WaypointPtr _waypoint) {
+  SimpleWaypoint::SimpleWaypoint(WaypointPtr _waypoint, uint32_t _index) {
     waypoint = _waypoint;
+    index = _index;
     next_left_waypoint = nullptr;
     next_right_waypoint = nullptr;
   }
   SimpleWaypoint::~SimpleWaypoint() {}
 
-  std::vector<SimpleWaypointPtr> SimpleWaypoint::GetNextWaypoint() const {
+  WaypointRange SimpleWaypoint::GetNextWaypoint() const {
     return next_waypoints;
   }
 
-  std::vector<SimpleWaypointPtr> SimpleWaypoint::GetPreviousWaypoint() const {
+  WaypointRange SimpleWaypoint::GetPreviousWaypoint() const {
     return previous_waypoints;
   }
 
@@ -36,6 +35,10 @@ namespace traffic_manager {
     return waypoint->GetId();
   }
 
+  uint32_t SimpleWaypoint::GetIndex() const {
+    return index;
+  }
+
   SimpleWaypointPtr SimpleWaypoint::GetLeftWaypoint() {
     return next_left_waypoint;
   }
@@ -52,21 +55,15 @@ namespace traffic_manager {
     return waypoint->GetTransform().rotation.GetForwardVector();
   }
 
-  uint64_t SimpleWaypoint::SetNextWaypoint(const std::vector<SimpleWaypointPtr> &waypoints) {
-    for (auto &simple_waypoint: waypoints) {
-      next_waypoints.push_back(simple_waypoint);
-    }
-    return static_cast<uint64_t>(waypoints.size());
+  void SimpleWaypoint::SetNextWaypoint(WaypointRange waypoints) {
+    next_waypoints = waypoints;
   }
 
-  uint64_t SimpleWaypoint::SetPreviousWaypoint(const std::vector<SimpleWaypointPtr> &waypoints) {
-    for (auto &simple_waypoint: waypoints) {
-      previous_waypoints.push_back(simple_waypoint);
-    }
-    return static_cast<uint64_t>(waypoints.size());
+  void SimpleWaypoint::SetPreviousWaypoint(WaypointRange waypoints) {
+    previous_waypoints = waypoints;
   }
 
-  void SimpleWaypoint::SetLeftWaypoint(SimpleWaypointPtr &_waypoint) {
+  void SimpleWaypoint::SetLeftWaypoint(const SimpleWaypointPtr _waypoint) {
 
     const cg::Vector3D heading_vector = waypoint->GetTransform().GetForwardVector();
     const cg::Vector3D relative_vector = GetLocation() - _waypoint->GetLocation();
@@ -75,7 +72,7 @@ namespace traffic_manager {
     }
   }
 
-  void SimpleWaypoint::SetRightWaypoint(SimpleWaypointPtr &_waypoint) {
+  void SimpleWaypoint::SetRightWaypoint(const SimpleWaypointPtr _waypoint) {
 
     const cg::Vector3D heading_vector = waypoint->GetTransform().GetForwardVector();
     const cg::Vector3D relative_vector = GetLocation() - _waypoint->GetLocation();
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <memory.h>
+#include <stdexcept>
 
 #include "carla/client/Waypoint.h"
 #include "carla/geom/Location.h"
@@ -33,20 +34,78 @@ namespace traffic_manager {
     RoadEnd = 7
   };
 
+  class SimpleWaypoint;
+
+  /// Waypoints are owned by the InMemoryMap, which keeps them alive until all
+  /// the path buffers are cleared, so they are referenced without ownership.
+  using SimpleWaypointPtr = SimpleWaypoint *;
+
+  /// Contiguous list of connecting waypoints, stored in the adjacency arrays
+  /// of the InMemoryMap.
+  class WaypointRange {
+  public:
+
+    WaypointRange() = default;
+
+    WaypointRange(const SimpleWaypointPtr *_first, const SimpleWaypointPtr *_last)
+      : first(_first),
+        last(_last) {}
+
+    const SimpleWaypointPtr *begin() const {
+      return first;
+    }
+
+    const SimpleWaypointPtr *end() const {
+      return last;
+    }
+
+    std::size_t size() const {
+      return static_cast<std::size_t>(last - first);
+    }
+
+    bool empty() const {
+      return first == last;
+    }
+
+    const SimpleWaypointPtr &operator[](std::size_t position) const {
+      return first[position];
+    }
+
+    const SimpleWaypointPtr &at(std::size_t position) const {
+      if (position >= size()) {
+        throw std::out_of_range("WaypointRange::at");
+      }
+      return first[position];
+    }
+
+    const SimpleWaypointPtr &front() const {
+      return *first;
+    }
+
+    const SimpleWaypointPtr &back() const {
+      return *(last - 1);
+    }
+
+  private:
+
+    const SimpleWaypointPtr *first = nullptr;
+    const SimpleWaypointPtr *last = nullptr;
+  };
+
   /// This is a simple wrapper class on Carla's waypoint object.
   /// The class is used to represent discrete samples of the world map.
   class SimpleWaypoint {
 
-    using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
-
   private:
 
     /// Pointer to Carla's waypoint object around which this class wraps around.
     WaypointPtr waypoint;
+    /// Position of the waypoint in the InMemoryMap.
+    uint32_t index;
     /// List of pointers to next connecting waypoints.
-    std::vector<SimpleWaypointPtr> next_waypoints;
+    WaypointRange next_waypoints;
     /// List of pointers to previous connecting waypoints.
-    std::vector<SimpleWaypointPtr> previous_waypoints;
+    WaypointRange previous_waypoints;
     /// Pointer to left lane change waypoint.
     SimpleWaypointPtr next_left_waypoint;
     /// Pointer to right lane change waypoint.
@@ -60,7 +119,7 @@ namespace traffic_manager {
 
   public:
 
-    SimpleWaypoint(WaypointPtr _waypoint);
+    SimpleWaypoint(WaypointPtr _waypoint, uint32_t _index);
     ~SimpleWaypoint();
 
     /// Returns the location object for this waypoint.
@@ -70,10 +129,10 @@ namespace traffic_manager {
     WaypointPtr GetWaypoint() const;
 
     /// Returns the list of next waypoints.
-    std::vector<SimpleWaypointPtr> GetNextWaypoint() const;
+    WaypointRange GetNextWaypoint() const;
 
     /// Returns the list of previous waypoints.
-    std::vector<SimpleWaypointPtr> GetPreviousWaypoint() const;
+    WaypointRange GetPreviousWaypoint() const;
 
     /// Returns the vector along the waypoint's direction.
     cg::Vector3D GetForwardVector() const;
@@ -81,17 +140,20 @@ namespace traffic_manager {
     /// Returns the unique id for the waypoint.
     uint64_t GetId() const;
 
+    /// Returns the position of the waypoint in the InMemoryMap.
+    uint32_t GetIndex() const;
+
     /// This method is used to set the next waypoints.
-    uint64_t SetNextWaypoint(const std::vector<SimpleWaypointPtr> &next_waypoints);
+    void SetNextWaypoint(WaypointRange next_waypoints);
 
     /// This method is used to set the previous waypoints.
-    uint64_t SetPreviousWaypoint(const std::vector<SimpleWaypointPtr> &next_waypoints);
+    void SetPreviousWaypoint(WaypointRange previous_waypoints);
 
     /// This method is used to set the closest left waypoint for a lane change.
-    void SetLeftWaypoint(SimpleWaypointPtr &waypoint);
+    void SetLeftWaypoint(const SimpleWaypointPtr waypoint);
 
     /// This method is used to set the closest right waypoint for a lane change.
-    void SetRightWaypoint(SimpleWaypointPtr &waypoint);
+    void SetRightWaypoint(const SimpleWaypointPtr waypoint);
 
     /// This method is used to get the closest left waypoint for a lane change.
     SimpleWaypointPtr GetLeftWaypoint();
@@ -10,93 +10,141 @@ void SimulationState::AddActor(ActorId actor_id,
                                KinematicState kinematic_state,
                                StaticAttributes attributes,
                                TrafficLightState tl_state) {
-  actor_set.insert(actor_id);
-  kinematic_state_map.insert({actor_id, kinematic_state});
-  static_attribute_map.insert({actor_id, attributes});
-  tl_state_map.insert({actor_id, tl_state});
+  if (ContainsActor(actor_id)) {
+    return;
+  }
+
+  std::size_t slot;
+  if (!free_slots.empty()) {
+    slot = free_slots.back();
+    free_slots.pop_back();
+  } else {
+    slot = locations.size();
+    locations.emplace_back();
+    rotations.emplace_back();
+    headings.emplace_back();
+    velocities.emplace_back();
+    speed_limits.emplace_back();
+    physics_enabled.emplace_back();
+    dormant.emplace_back();
+    hybrid_end_locations.emplace_back();
+    actor_types.emplace_back();
+    dimensions.emplace_back();
+    tl_states.emplace_back();
+  }
+  actor_slots.insert({actor_id, slot});
+
+  SetKinematicState(slot, kinematic_state);
+  actor_types[slot] = attributes.actor_type;
+  dimensions[slot] = cg::Vector3D(attributes.half_length, attributes.half_width, attributes.half_height);
+  tl_states[slot] = tl_state;
 }
 
 bool SimulationState::ContainsActor(ActorId actor_id) const {
-  return actor_set.find(actor_id) != actor_set.end();
+  return actor_slots.find(actor_id) != actor_slots.end();
 }
 
 void SimulationState::RemoveActor(ActorId actor_id) {
-  actor_set.erase(actor_id);
-  kinematic_state_map.erase(actor_id);
-  static_attribute_map.erase(actor_id);
-  tl_state_map.erase(actor_id);
+  auto actor_slot = actor_slots.find(actor_id);
+  if (actor_slot != actor_slots.end()) {
+    free_slots.push_back(actor_slot->second);
+    actor_slots.erase(actor_slot);
+  }
 }
 
 void SimulationState::Reset() {
-  actor_set.clear();
-  kinematic_state_map.clear();
-  static_attribute_map.clear();
-  tl_state_map.clear();
+  actor_slots.clear();
+  free_slots.clear();
+  locations.clear();
+  rotations.clear();
+  headings.clear();
+  velocities.clear();
+  speed_limits.clear();
+  physics_enabled.clear();
+  dormant.clear();
+  hybrid_end_locations.clear();
+  actor_types.clear();
+  dimensions.clear();
+  tl_states.clear();
+}
+
+StateSlot SimulationState::GetSlot(const ActorId actor_id) const {
+  return StateSlot{actor_slots.at(actor_id)};
+}
+
+void SimulationState::SetKinematicState(std::size_t slot, const KinematicState &state) {
+  locations[slot] = state.location;
+  rotations[slot] = state.rotation;
+  headings[slot] = state.rotation.GetForwardVector();
+  velocities[slot] = state.velocity;
+  speed_limits[slot] = state.speed_limit;
+  physics_enabled[slot] = state.physics_enabled;
+  dormant[slot] = state.is_dormant;
+  hybrid_end_locations[slot] = state.hybrid_end_location;
 }
 
 void SimulationState::UpdateKinematicState(ActorId actor_id, KinematicState state) {
-  kinematic_state_map.at(actor_id) = state;
+  SetKinematicState(actor_slots.at(actor_id), state);
 }
 
 void SimulationState::UpdateKinematicHybridEndLocation(ActorId actor_id, cg::Location location) {
-  kinematic_state_map.at(actor_id).hybrid_end_location = location;
+  UpdateKinematicHybridEndLocation(GetSlot(actor_id), location);
 }
 
 void SimulationState::UpdateTrafficLightState(ActorId actor_id, TrafficLightState state) {
   // The green-yellow state transition is not notified to the vehicle. This is done to avoid
   // having vehicles stopped very near the intersection when only the rear part of the vehicle
   // is colliding with the trigger volume of the traffic light.
-  auto previous_tl_state = GetTLS(actor_id);
+  TrafficLightState &previous_tl_state = tl_states[actor_slots.at(actor_id)];
   if (previous_tl_state.at_traffic_light && previous_tl_state.tl_state == TLS::Green) {
     state.tl_state = TLS::Green;
   }
 
-  tl_state_map.at(actor_id) = state;
+  previous_tl_state = state;
 }
 
 cg::Location SimulationState::GetLocation(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).location;
+  return GetLocation(GetSlot(actor_id));
 }
 
 cg::Location SimulationState::GetHybridEndLocation(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).hybrid_end_location;
+  return GetHybridEndLocation(GetSlot(actor_id));
 }
 
 cg::Rotation SimulationState::GetRotation(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).rotation;
+  return GetRotation(GetSlot(actor_id));
 }
 
 cg::Vector3D SimulationState::GetHeading(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).rotation.GetForwardVector();
+  return GetHeading(GetSlot(actor_id));
 }
 
 cg::Vector3D SimulationState::GetVelocity(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).velocity;
+  return GetVelocity(GetSlot(actor_id));
 }
 
 float SimulationState::GetSpeedLimit(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).speed_limit;
+  return GetSpeedLimit(GetSlot(actor_id));
 }
 
 bool SimulationState::IsPhysicsEnabled(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).physics_enabled;
+  return IsPhysicsEnabled(GetSlot(actor_id));
 }
 
 bool SimulationState::IsDormant(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).is_dormant;
+  return IsDormant(GetSlot(actor_id));
 }
 
 TrafficLightState SimulationState::GetTLS(ActorId actor_id) const {
-  return tl_state_map.at(actor_id);
+  return GetTLS(GetSlot(actor_id));
 }
 
 ActorType SimulationState::GetType(ActorId actor_id) const {
-  return static_attribute_map.at(actor_id).actor_type;
+  return GetType(GetSlot(actor_id));
 }
 
 cg::Vector3D SimulationState::GetDimensions(ActorId actor_id) const {
-  const StaticAttributes &attributes = static_attribute_map.at(actor_id);
-  return cg::Vector3D(attributes.half_length, attributes.half_width, attributes.half_height);
+  return GetDimensions(GetSlot(actor_id));
 }
 
 } // namespace  traffic_manager
@@ -1,7 +1,8 @@
 
 #pragma once
 
-#include <unordered_set>
+#include <unordered_map>
+#include <vector>
 
 #include "carla/trafficmanager/DataStructures.h"
 
@@ -39,18 +40,42 @@ struct StaticAttributes {
 };
 using StaticAttributeMap = std::unordered_map<ActorId, StaticAttributes>;
 
+/// Position of an actor in the arrays of the simulation state. It does not
+/// change while the actor stays in the simulation state, so the stages look
+/// it up once, when the list of registered vehicles changes.
+struct StateSlot {
+  std::size_t index;
+};
+
 /// This class holds the state of all the vehicles in the simlation.
+/// Each attribute is kept in its own array, indexed by the slot of the actor,
+/// so the loops over the vehicles read contiguous memory. The slots of removed
+/// actors are reused by the new ones.
 class SimulationState {
 
 private:
-  // Structure to hold ids of all actors in the simulation.
-  std::unordered_set<ActorId> actor_set;
-  // Structure containing dynamic motion related state of actors.
-  KinematicStateMap kinematic_state_map;
-  // Structure containing static attributes of actors.
-  StaticAttributeMap static_attribute_map;
-  // Structure containing dynamic traffic light related state of actors.
-  TrafficLightStateMap tl_state_map;
+  // Slot of each actor currently in the simulation state.
+  std::unordered_map<ActorId, std::size_t> actor_slots;
+  // Slots left by removed actors.
+  std::vector<std::size_t> free_slots;
+  // Dynamic motion related state of actors.
+  std::vector<cg::Location> locations;
+  std::vector<cg::Rotation> rotations;
+  std::vector<cg::Vector3D> headings;
+  std::vector<cg::Vector3D> velocities;
+  std::vector<float> speed_limits;
+  // Flags as bytes instead of std::vector<bool>, to allow updating different
+  // actors from parallel stages.
+  std::vector<uint8_t> physics_enabled;
+  std::vector<uint8_t> dormant;
+  std::vector<cg::Location> hybrid_end_locations;
+  // Static attributes of actors.
+  std::vector<ActorType> actor_types;
+  std::vector<cg::Vector3D> dimensions;
+  // Dynamic traffic light related state of actors.
+  std::vector<TrafficLightState> tl_states;
+
+  void SetKinematicState(std::size_t slot, const KinematicState &state);
 
 public :
   SimulationState();
@@ -70,6 +95,17 @@ public :
   // Method to flush all states and actors.
   void Reset();
 
+  // Method to get the slot of an actor present in the simulation state.
+  StateSlot GetSlot(const ActorId actor_id) const;
+
+  // Method to call a functor with the id and slot of every actor.
+  template <typename FunctorT>
+  void ForEachActor(FunctorT &&functor) const {
+    for (const auto &actor_slot : actor_slots) {
+      functor(actor_slot.first, StateSlot{actor_slot.second});
+    }
+  }
+
   void UpdateKinematicState(ActorId actor_id, KinematicState state);
 
   void UpdateKinematicHybridEndLocation(ActorId actor_id, cg::Location location);
@@ -100,6 +136,60 @@ public :
 
   cg::Vector3D GetDimensions(const ActorId actor_id) const;
 
+  // Same methods, for an actor already looked up.
+
+  void UpdateKinematicState(StateSlot slot, KinematicState state) {
+    SetKinematicState(slot.index, state);
+  }
+
+  void UpdateKinematicHybridEndLocation(StateSlot slot, cg::Location location) {
+    hybrid_end_locations[slot.index] = location;
+  }
+
+  cg::Location GetLocation(StateSlot slot) const {
+    return locations[slot.index];
+  }
+
+  cg::Location GetHybridEndLocation(StateSlot slot) const {
+    return hybrid_end_locations[slot.index];
+  }
+
+  cg::Rotation GetRotation(StateSlot slot) const {
+    return rotations[slot.index];
+  }
+
+  cg::Vector3D GetHeading(StateSlot slot) const {
+    return headings[slot.index];
+  }
+
+  cg::Vector3D GetVelocity(StateSlot slot) const {
+    return velocities[slot.index];
+  }
+
+  float GetSpeedLimit(StateSlot slot) const {
+    return speed_limits[slot.index];
+  }
+
+  bool IsPhysicsEnabled(StateSlot slot) const {
+    return physics_enabled[slot.index] != 0u;
+  }
+
+  bool IsDormant(StateSlot slot) const {
+    return dormant[slot.index] != 0u;
+  }
+
+  TrafficLightState GetTLS(StateSlot slot) const {
+    return tl_states[slot.index];
+  }
+
+  ActorType GetType(StateSlot slot) const {
+    return actor_types[slot.index];
+  }
+
+  cg::Vector3D GetDimensions(StateSlot slot) const {
+    return dimensions[slot.index];
+  }
+
 };
 
 } // namespace traffic_manager
@@ -114,6 +114,21 @@ ActorIdSet TrackTraffic::GetOverlappingVehicles(ActorId actor_id) const {
     return actor_id_set;
 }
 
+bool TrackTraffic::IsOverlappingVehicle(ActorId actor_id, ActorId other_actor_id) const {
+    auto actor_grids = actor_to_grids.find(actor_id);
+    if (actor_grids != actor_to_grids.end()) {
+        for (auto &grid_id : actor_grids->second) {
+            auto grid_actors = grid_to_actors.find(grid_id);
+            if (grid_actors != grid_to_actors.end()
+                && grid_actors->second.find(other_actor_id) != grid_actors->second.end()) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 void TrackTraffic::DeleteActor(ActorId actor_id) {
     if (actor_to_grids.find(actor_id) != actor_to_grids.end()) {
         std::unordered_set<GeoGridId> &grid_ids = actor_to_grids.at(actor_id);
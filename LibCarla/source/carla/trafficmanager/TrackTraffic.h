@@ -4,6 +4,7 @@
 #include "carla/road/RoadTypes.h"
 #include "carla/rpc/ActorId.h"
 
+#include "carla/trafficmanager/RingBuffer.h"
 #include "carla/trafficmanager/SimpleWaypoint.h"
 
 namespace carla {
@@ -11,11 +12,12 @@ namespace traffic_manager {
 
 using ActorId = carla::ActorId;
 using ActorIdSet = std::unordered_set<ActorId>;
-using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
-using Buffer = std::deque<SimpleWaypointPtr>;
+using Buffer = RingBuffer<SimpleWaypointPtr>;
 using GeoGridId = carla::road::JuncId;
 
 // This class is used to track the waypoint occupancy of all the actors.
+// It is only modified from the stages that run serially (localization and
+// the respawn of dormant vehicles), the parallel ones just read it.
 class TrackTraffic {
 
 private:
@@ -49,6 +51,9 @@ public:
                                         const std::vector<SimpleWaypointPtr> waypoints);
 
     ActorIdSet GetOverlappingVehicles(ActorId actor_id) const;
+    /// Same as looking for other_actor_id in GetOverlappingVehicles(actor_id),
+    /// without building the set.
+    bool IsOverlappingVehicle(ActorId actor_id, ActorId other_actor_id) const;
     bool IsGeoGridFree(const GeoGridId geogrid_id) const;
     void AddTakenGrid(const GeoGridId geogrid_id, const ActorId actor_id);
 
@@ -14,6 +14,7 @@ using constants::MotionPlan::EPSILON_RELATIVE_SPEED;
 
 TrafficLightStage::TrafficLightStage(
   const std::vector<ActorId> &vehicle_id_list,
+  const std::vector<StateSlot> &vehicle_slot_list,
   const SimulationState &simulation_state,
   const BufferMap &buffer_map,
   const Parameters &parameters,
@@ -21,6 +22,7 @@ TrafficLightStage::TrafficLightStage(
   TLFrame &output_array,
   RandomGenerator &random_device)
   : vehicle_id_list(vehicle_id_list),
+    vehicle_slot_list(vehicle_slot_list),
     simulation_state(simulation_state),
     buffer_map(buffer_map),
     parameters(parameters),
@@ -32,7 +34,8 @@ void TrafficLightStage::Update(const unsigned long index) {
   bool traffic_light_hazard = false;
 
   const ActorId ego_actor_id = vehicle_id_list.at(index);
-  if (!simulation_state.IsDormant(ego_actor_id)) {
+  const StateSlot ego_slot = vehicle_slot_list.at(index);
+  if (!simulation_state.IsDormant(ego_slot)) {
 
     JunctionID current_junction_id = -1;
     if (vehicle_last_junction.find(ego_actor_id) != vehicle_last_junction.end()) {
@@ -42,7 +45,7 @@ void TrafficLightStage::Update(const unsigned long index) {
 
     current_timestamp = world.GetSnapshot().GetTimestamp();
 
-    const TrafficLightState tl_state = simulation_state.GetTLS(ego_actor_id);
+    const TrafficLightState tl_state = simulation_state.GetTLS(ego_slot);
     const TLS traffic_light_state = tl_state.tl_state;
     const bool is_at_traffic_light = tl_state.at_traffic_light;
 
@@ -15,6 +15,7 @@ namespace traffic_manager {
 class TrafficLightStage: Stage {
 private:
   const std::vector<ActorId> &vehicle_id_list;
+  const std::vector<StateSlot> &vehicle_slot_list;
   const SimulationState &simulation_state;
   const BufferMap &buffer_map;
   const Parameters &parameters;
@@ -46,6 +47,7 @@ private:
 
 public:
   TrafficLightStage(const std::vector<ActorId> &vehicle_id_list,
+                    const std::vector<StateSlot> &vehicle_slot_list,
                     const SimulationState &Simulation_state,
                     const BufferMap &buffer_map,
                     const Parameters &parameters,
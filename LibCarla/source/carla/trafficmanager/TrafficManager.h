@@ -351,6 +351,14 @@ public:
     }
   }
 
+  /// Method to set the number of threads running the stages.
+  void SetWorkerThreads(const uint64_t threads) {
+    TrafficManagerBase* tm_ptr = GetTM(_port);
+    if(tm_ptr != nullptr){
+      tm_ptr->SetWorkerThreads(threads);
+    }
+  }
+
   void ShutDown();
 
   /// Method to get the next action.
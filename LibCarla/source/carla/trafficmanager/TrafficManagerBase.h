@@ -131,6 +131,9 @@ public:
   /// Method to set randomization seed.
   virtual void SetRandomDeviceSeed(const uint64_t seed) = 0;
 
+  /// Method to set the number of threads running the stages.
+  virtual void SetWorkerThreads(const uint64_t threads) = 0;
+
   /// Method to set Open Street Map mode.
   virtual void SetOSMMode(const bool mode_switch) = 0;
 
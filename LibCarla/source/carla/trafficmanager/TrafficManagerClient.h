@@ -231,6 +231,12 @@ public:
     _client->call("set_random_device_seed", seed);
   }
 
+  /// Method to set the number of threads running the stages.
+  void SetWorkerThreads(const uint64_t threads) {
+    DEBUG_ASSERT(_client != nullptr);
+    _client->call("set_worker_threads", threads);
+  }
+
   /// Method to set Open Street Map mode.
   void SetOSMMode(const bool mode_switch) {
     DEBUG_ASSERT(_client != nullptr);
@@ -34,54 +34,58 @@ TrafficManagerLocal::TrafficManagerLocal(
     episode_proxy(episode_proxy),
     world(cc::World(episode_proxy)),
 
-    localization_stage(LocalizationStage(vehicle_id_list,
-                                         buffer_map,
-                                         simulation_state,
-                                         track_traffic,
-                                         local_map,
-                                         parameters,
-                                         marked_for_removal,
-                                         localization_frame,
-                                         random_device)),
-
-    collision_stage(CollisionStage(vehicle_id_list,
-                                   simulation_state,
-                                   buffer_map,
-                                   track_traffic,
-                                   parameters,
-                                   collision_frame,
-                                   random_device)),
-
-    traffic_light_stage(TrafficLightStage(vehicle_id_list,
-                                          simulation_state,
-                                          buffer_map,
-                                          parameters,
-                                          world,
-                                          tl_frame,
-                                          random_device)),
-
-    motion_plan_stage(MotionPlanStage(vehicle_id_list,
-                                      simulation_state,
-                                      parameters,
-                                      buffer_map,
-                                      track_traffic,
-                                      longitudinal_PID_parameters,
-                                      longitudinal_highway_PID_parameters,
-                                      lateral_PID_parameters,
-                                      lateral_highway_PID_parameters,
-                                      localization_frame,
-                                      collision_frame,
-                                      tl_frame,
-                                      world,
-                                      control_frame,
-                                      random_device,
-                                      local_map)),
-
-    vehicle_light_stage(VehicleLightStage(vehicle_id_list,
-                                          buffer_map,
-                                          parameters,
-                                          world,
-                                          control_frame)),
+    localization_stage(vehicle_id_list,
+                       vehicle_slot_list,
+                       buffer_map,
+                       simulation_state,
+                       track_traffic,
+                       local_map,
+                       parameters,
+                       marked_for_removal,
+                       localization_frame,
+                       random_device),
+
+    collision_stage(vehicle_id_list,
+                    vehicle_slot_list,
+                    simulation_state,
+                    buffer_map,
+                    track_traffic,
+                    parameters,
+                    collision_frame,
+                    random_device),
+
+    traffic_light_stage(vehicle_id_list,
+                        vehicle_slot_list,
+                        simulation_state,
+                        buffer_map,
+                        parameters,
+                        world,
+                        tl_frame,
+                        random_device),
+
+    motion_plan_stage(vehicle_id_list,
+                      vehicle_slot_list,
+                      simulation_state,
+                      parameters,
+                      buffer_map,
+                      track_traffic,
+                      longitudinal_PID_parameters,
+                      longitudinal_highway_PID_parameters,
+                      lateral_PID_parameters,
+                      lateral_highway_PID_parameters,
+                      localization_frame,
+                      collision_frame,
+                      tl_frame,
+                      world,
+                      control_frame,
+                      random_device,
+                      local_map),
+
+    vehicle_light_stage(vehicle_id_list,
+                        buffer_map,
+                        parameters,
+                        world,
+                        control_frame),
 
     alsm(ALSM(registered_vehicles,
               buffer_map,
@@ -117,6 +121,12 @@ void TrafficManagerLocal::SetupLocalMap() {
   const carla::SharedPtr<const cc::Map> world_map = world.GetMap();
   local_map = std::make_shared<InMemoryMap>(world_map);
 
+  // Local cache written by a previous traffic manager on the same map.
+  const std::string cache_path = local_map->GetCachePath();
+  if (local_map->LoadCache(cache_path)) {
+    return;
+  }
+
   auto files = episode_proxy.Lock()->GetRequiredFiles("TM");
   if (!files.empty()) {
     auto content = episode_proxy.Lock()->GetCacheFile(files[0], true);
@@ -130,6 +140,7 @@ void TrafficManagerLocal::SetupLocalMap() {
     log_warning("No InMemoryMap cache found. Setting up local map. This may take a while...");
     local_map->SetUp();
   }
+  local_map->SaveCache(cache_path);
 }
 
 void TrafficManagerLocal::Start() {
@@ -190,6 +201,12 @@ void TrafficManagerLocal::Run() {
       vehicle_id_list = registered_vehicles.GetIDList();
       number_of_vehicles = vehicle_id_list.size();
 
+      // The slots do not change while the vehicles stay registered.
+      vehicle_slot_list.clear();
+      for (const ActorId actor_id : vehicle_id_list) {
+        vehicle_slot_list.push_back(simulation_state.GetSlot(actor_id));
+      }
+
       // Reserve more space if needed.
       uint64_t growth_factor = static_cast<uint64_t>(static_cast<float>(number_of_vehicles) * INV_GROWTH_STEP_SIZE);
       uint64_t new_frame_capacity = INITIAL_SIZE + GROWTH_STEP_SIZE * growth_factor;
@@ -219,18 +236,41 @@ void TrafficManagerLocal::Run() {
     control_frame.resize(number_of_vehicles);
 
     // Run core operation stages.
+    // Localization modifies the buffers and the traffic tracking of the
+    // vehicles around, so it always runs serially.
+    parallel_for.SetNumberOfThreads(parameters.GetWorkerThreads());
     for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
       localization_stage.Update(index);
     }
-    for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+    collision_stage.UpdateBroadPhase();
+    parallel_for.Run(vehicle_id_list.size(), [this](const unsigned long index) {
       collision_stage.Update(index);
-    }
+    });
     collision_stage.ClearCycleCache();
     vehicle_light_stage.UpdateWorldInfo();
-    for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
-      traffic_light_stage.Update(index);
-      motion_plan_stage.Update(index);
-      vehicle_light_stage.Update(index);
+    if (parallel_for.GetNumberOfThreads() > 1u) {
+      for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+        traffic_light_stage.Update(index);
+      }
+      // Dormant vehicles may be respawned, which takes grids of the traffic
+      // tracking, they are planned serially after the rest.
+      parallel_for.Run(vehicle_id_list.size(), [this](const unsigned long index) {
+        if (!simulation_state.IsDormant(vehicle_slot_list.at(index))) {
+          motion_plan_stage.Update(index);
+        }
+      });
+      for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+        if (simulation_state.IsDormant(vehicle_slot_list.at(index))) {
+          motion_plan_stage.Update(index);
+        }
+        vehicle_light_stage.Update(index);
+      }
+    } else {
+      for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+        traffic_light_stage.Update(index);
+        motion_plan_stage.Update(index);
+        vehicle_light_stage.Update(index);
+      }
     }
 
     registration_lock.unlock();
@@ -275,6 +315,7 @@ void TrafficManagerLocal::Stop() {
   }
 
   vehicle_id_list.clear();
+  vehicle_slot_list.clear();
   registered_vehicles.Clear();
   registered_vehicles_state = -1;
   track_traffic.Clear();
@@ -487,9 +528,13 @@ std::vector<ActorId> TrafficManagerLocal::GetRegisteredVehiclesIDs() {
 
 void TrafficManagerLocal::SetRandomDeviceSeed(const uint64_t _seed) {
   seed = _seed;
-  random_device = RandomGenerator(seed);
+  random_device.seed(seed);
   world.ResetAllTrafficLights();
 }
 
+void TrafficManagerLocal::SetWorkerThreads(const uint64_t threads) {
+  parameters.SetWorkerThreads(threads);
+}
+
 } // namespace traffic_manager
 } // namespace carla
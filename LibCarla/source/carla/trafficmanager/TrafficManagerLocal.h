@@ -20,6 +20,7 @@
 
 #include "carla/trafficmanager/AtomicActorSet.h"
 #include "carla/trafficmanager/InMemoryMap.h"
+#include "carla/trafficmanager/ParallelFor.h"
 #include "carla/trafficmanager/Parameters.h"
 #include "carla/trafficmanager/RandomGenerator.h"
 #include "carla/trafficmanager/SimulationState.h"
@@ -66,6 +67,8 @@ private:
   /// List of vehicles registered with the traffic manager in
   /// current update cycle.
   std::vector<ActorId> vehicle_id_list;
+  /// Slots in the simulation state of the vehicles in vehicle_id_list.
+  std::vector<StateSlot> vehicle_slot_list;
   /// Pointer to local map cache.
   LocalMapPtr local_map;
   /// Structures to hold waypoint buffers for all vehicles.
@@ -112,7 +115,9 @@ private:
   /// Randomization seed.
   uint64_t seed {static_cast<uint64_t>(time(NULL))};
   /// Structure holding random devices per vehicle.
-  RandomGenerator random_device = RandomGenerator(seed);
+  RandomGenerator random_device {seed};
+  /// Threads running the per-vehicle loops of the stages.
+  ParallelFor parallel_for;
   std::vector<ActorId> marked_for_removal;
   /// Mutex to prevent vehicle registration during frame array re-allocation.
   std::mutex registration_mutex;
@@ -242,6 +247,9 @@ public:
   /// Method to set randomization seed.
   void SetRandomDeviceSeed(const uint64_t _seed);
 
+  /// Method to set the number of threads running the stages.
+  void SetWorkerThreads(const uint64_t threads);
+
   /// Method to set Open Street Map mode.
   void SetOSMMode(const bool mode_switch);
 
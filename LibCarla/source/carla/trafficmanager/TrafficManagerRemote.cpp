@@ -297,5 +297,9 @@ void TrafficManagerRemote::SetRandomDeviceSeed(const uint64_t seed) {
   client.SetRandomDeviceSeed(seed);
 }
 
+void TrafficManagerRemote::SetWorkerThreads(const uint64_t threads) {
+  client.SetWorkerThreads(threads);
+}
+
 } // namespace traffic_manager
 } // namespace carla
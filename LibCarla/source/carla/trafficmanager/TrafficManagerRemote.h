@@ -175,6 +175,9 @@ public:
   /// Method to set randomization seed.
   void SetRandomDeviceSeed(const uint64_t seed);
 
+  /// Method to set the number of threads running the stages.
+  void SetWorkerThreads(const uint64_t threads);
+
 private:
 
   /// Remote client using the IP and port information it connects to
@@ -272,6 +272,11 @@ public:
         tm->SetRandomDeviceSeed(seed);
       });
 
+      /// Method to set the number of threads running the stages.
+      server->bind("set_worker_threads", [=](const uint64_t threads) {
+        tm->SetWorkerThreads(threads);
+      });
+
       /// Method to provide synchronous tick.
       server->bind("synchronous_tick", [=]() -> bool {
         return tm->SynchronousTick();
@@ -0,0 +1,117 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "OpenDrive.h"
+
+#include <carla/client/Map.h>
+#include <carla/client/Waypoint.h>
+#include <carla/trafficmanager/InMemoryMap.h>
+
+#include <boost/filesystem/operations.hpp>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace cc = carla::client;
+
+using carla::traffic_manager::InMemoryMap;
+using carla::traffic_manager::NodeList;
+using carla::traffic_manager::SimpleWaypointPtr;
+using carla::traffic_manager::WaypointRange;
+
+static std::vector<uint32_t> GetIndices(const WaypointRange &range) {
+  std::vector<uint32_t> indices;
+  for (const auto &swp : range) {
+    indices.emplace_back(swp->GetIndex());
+  }
+  return indices;
+}
+
+static int64_t GetIndex(SimpleWaypointPtr swp) {
+  return swp != nullptr ? static_cast<int64_t>(swp->GetIndex()) : -1;
+}
+
+static void CheckEqual(const NodeList &expected, const NodeList &result) {
+  ASSERT_EQ(result.size(), expected.size());
+  for (auto i = 0u; i < expected.size(); ++i) {
+    const auto &lhs = expected[i];
+    const auto &rhs = result[i];
+    ASSERT_EQ(rhs->GetIndex(), i);
+    ASSERT_EQ(rhs->GetWaypoint()->GetRoadId(), lhs->GetWaypoint()->GetRoadId());
+    ASSERT_EQ(rhs->GetWaypoint()->GetLaneId(), lhs->GetWaypoint()->GetLaneId());
+    ASSERT_NEAR(rhs->GetWaypoint()->GetDistance(), lhs->GetWaypoint()->GetDistance(), 1e-2);
+    ASSERT_LT(rhs->Distance(lhs->GetLocation()), 1e-2f);
+    ASSERT_EQ(rhs->GetGeodesicGridId(), lhs->GetGeodesicGridId());
+    ASSERT_EQ(rhs->CheckJunction(), lhs->CheckJunction());
+    ASSERT_EQ(rhs->GetRoadOption(), lhs->GetRoadOption());
+    ASSERT_EQ(GetIndices(rhs->GetNextWaypoint()), GetIndices(lhs->GetNextWaypoint()));
+    ASSERT_EQ(GetIndices(rhs->GetPreviousWaypoint()), GetIndices(lhs->GetPreviousWaypoint()));
+    ASSERT_EQ(GetIndex(rhs->GetLeftWaypoint()), GetIndex(lhs->GetLeftWaypoint()));
+    ASSERT_EQ(GetIndex(rhs->GetRightWaypoint()), GetIndex(lhs->GetRightWaypoint()));
+  }
+}
+
+static std::vector<char> ReadFile(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+static void WriteFile(const std::string &path, const std::vector<char> &content, size_t size) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(content.data(), static_cast<std::streamsize>(size));
+}
+
+TEST(in_memory_map, cache) {
+  namespace fs = boost::filesystem;
+  const auto folder = fs::temp_directory_path() / fs::unique_path("libcarla-test-%%%%-%%%%");
+  const std::string cache_path = (folder / "map.bin").string();
+  const std::string truncated_path = (folder / "truncated.bin").string();
+
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    carla::logging::log("Testing", file);
+    const auto xodr = util::OpenDrive::Load(file);
+    const auto world_map = carla::MakeShared<const cc::Map>(file, xodr);
+
+    InMemoryMap map(world_map);
+    map.SetUp();
+    ASSERT_TRUE(map.SaveCache(cache_path));
+
+    InMemoryMap loaded(world_map);
+    ASSERT_TRUE(loaded.LoadCache(cache_path));
+    CheckEqual(map.GetDenseTopology(), loaded.GetDenseTopology());
+
+    // An existing cache is replaced.
+    ASSERT_TRUE(loaded.SaveCache(cache_path));
+    InMemoryMap reloaded(world_map);
+    ASSERT_TRUE(reloaded.LoadCache(cache_path));
+    CheckEqual(map.GetDenseTopology(), reloaded.GetDenseTopology());
+
+    // The cache of another OpenDRIVE is rejected.
+    InMemoryMap other(carla::MakeShared<const cc::Map>(file, xodr + "\n"));
+    ASSERT_NE(other.GetCachePath(), map.GetCachePath());
+    ASSERT_FALSE(other.LoadCache(cache_path));
+    ASSERT_TRUE(other.GetDenseTopology().empty());
+
+    // So are truncated caches.
+    const auto content = ReadFile(cache_path);
+    ASSERT_FALSE(content.empty());
+    for (const size_t size : {size_t(0u), size_t(16u), content.size() / 2u, content.size() - 1u}) {
+      WriteFile(truncated_path, content, size);
+      InMemoryMap truncated(world_map);
+      ASSERT_FALSE(truncated.LoadCache(truncated_path));
+      ASSERT_TRUE(truncated.GetDenseTopology().empty());
+    }
+
+    // And missing ones.
+    InMemoryMap missing(world_map);
+    ASSERT_FALSE(missing.LoadCache((folder / "missing.bin").string()));
+  }
+
+  fs::remove_all(folder);
+}
@@ -0,0 +1,92 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/pointcloud/AsyncPointCloudWriter.h>
+#include <carla/pointcloud/PointCloudIO.h>
+#include <carla/sensor/data/LidarWithFogData.h>
+
+#include <boost/filesystem.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+using carla::pointcloud::AsyncPointCloudWriter;
+using carla::pointcloud::PointCloudIO;
+using carla::sensor::data::LidarWithFogDetection;
+
+static std::vector<LidarWithFogDetection> make_points(size_t count) {
+  std::vector<LidarWithFogDetection> points;
+  for (auto i = 0u; i < count; ++i) {
+    const auto value = static_cast<float>(i);
+    points.emplace_back(1.0f * value, 2.0f * value, 3.0f * value, 0.5f * value, i % 30u);
+  }
+  return points;
+}
+
+static std::string read_file(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+TEST(pointcloud, binary_ply) {
+  const auto points = make_points(100u);
+  std::ostringstream out;
+  PointCloudIO::DumpBinary(out, points.data(), points.data() + points.size());
+  const std::string result = out.str();
+
+  const std::string end_header = "end_header\n";
+  const auto body = result.find(end_header);
+  ASSERT_NE(body, std::string::npos);
+  ASSERT_EQ(result.compare(0u, 36u, "ply\nformat binary_little_endian 1.0\n"), 0);
+  ASSERT_NE(result.find("element vertex 100\n"), std::string::npos);
+  ASSERT_NE(result.find("property uint32 object_tag\n"), std::string::npos);
+
+  const auto offset = body + end_header.size();
+  ASSERT_EQ(result.size() - offset, sizeof(LidarWithFogDetection) * points.size());
+  ASSERT_EQ(std::memcmp(result.data() + offset, points.data(), result.size() - offset), 0);
+}
+
+TEST(pointcloud, kitti) {
+  const auto points = make_points(10u);
+  std::ostringstream out;
+  PointCloudIO::DumpKitti(out, points.begin(), points.end());
+  const std::string result = out.str();
+  ASSERT_EQ(result.size(), 4u * sizeof(float) * points.size());
+  std::vector<float> values(4u * points.size());
+  std::memcpy(values.data(), result.data(), result.size());
+  ASSERT_EQ(values[4u * 7u + 0u], points[7u].point.x);
+  ASSERT_EQ(values[4u * 7u + 2u], points[7u].point.z);
+  ASSERT_EQ(values[4u * 7u + 3u], points[7u].intensity);
+}
+
+TEST(pointcloud, async_writer) {
+  namespace fs = boost::filesystem;
+  const auto folder = fs::temp_directory_path() / fs::unique_path("carla-pointcloud-%%%%%%%%");
+  const auto points = std::make_shared<const std::vector<LidarWithFogDetection>>(make_points(1000u));
+  std::vector<std::string> paths;
+  {
+    AsyncPointCloudWriter writer{2u, 4u};
+    for (auto i = 0u; i < 16u; ++i) {
+      paths.emplace_back(writer.SaveToDisk(points, (folder / std::to_string(i)).string(), true));
+      ASSERT_LE(writer.GetPendingCount(), 4u);
+    }
+    writer.Flush();
+    ASSERT_EQ(writer.GetPendingCount(), 0u);
+  }
+  std::ostringstream expected;
+  PointCloudIO::DumpBinary(expected, points->data(), points->data() + points->size());
+  for (const auto &path : paths) {
+    ASSERT_EQ(fs::path(path).extension().string(), ".ply");
+    ASSERT_EQ(read_file(path), expected.str());
+  }
+  fs::remove_all(folder);
+}
@@ -134,3 +134,74 @@ TEST(buffer, buffer_pool) {
   // Now delete the pool to test the weak reference inside the buffers.
   pool.reset();
 }
+
+TEST(buffer, buffer_pool_size_classes) {
+  auto pool = std::make_shared<carla::BufferPool>();
+  {
+    auto small = pool->Pop(1000u);
+    small.reset(1000u);
+    auto big = pool->Pop(1u << 20);
+    big.reset(1u << 20);
+  }
+  auto stats = pool->GetStats();
+  ASSERT_EQ(stats.buffers_held, 2u);
+  ASSERT_EQ(stats.bytes_held, 1000u + (1u << 20));
+  ASSERT_EQ(stats.allocations, 2u);
+
+  auto big = pool->Pop(1u << 20);
+  ASSERT_EQ(big.capacity(), 1u << 20);
+  auto small = pool->Pop(1000u);
+  ASSERT_EQ(small.capacity(), 1000u);
+  auto other = pool->Pop(1u << 20);
+  ASSERT_EQ(other.capacity(), 0u);
+
+  stats = pool->GetStats();
+  ASSERT_EQ(stats.hits, 2u);
+  ASSERT_EQ(stats.allocations, 3u);
+  ASSERT_EQ(stats.buffers_held, 0u);
+  ASSERT_EQ(stats.bytes_held, 0u);
+  ASSERT_NEAR(stats.GetHitRate(), 0.4, 1e-9);
+}
+
+TEST(buffer, buffer_pool_high_water) {
+  carla::BufferPool::Settings settings;
+  settings.max_bytes_held = 3000u;
+  auto pool = std::make_shared<carla::BufferPool>(settings);
+  {
+    std::vector<carla::Buffer> buffers;
+    for (auto i = 0u; i < 5u; ++i) {
+      buffers.emplace_back(pool->Pop(1000u));
+      buffers.back().reset(1000u);
+    }
+  }
+  const auto stats = pool->GetStats();
+  ASSERT_EQ(stats.buffers_held, 3u);
+  ASSERT_EQ(stats.bytes_held, 3000u);
+  ASSERT_EQ(stats.buffers_released, 2u);
+  ASSERT_EQ(stats.bytes_released, 2000u);
+  pool->Clear();
+  ASSERT_EQ(pool->GetStats().bytes_held, 0u);
+  ASSERT_EQ(pool->GetStats().buffers_released, 5u);
+}
+
+TEST(buffer, buffer_pool_idle_trim) {
+  using namespace std::chrono_literals;
+  carla::BufferPool::Settings settings;
+  settings.idle_timeout = 20ms;
+  auto pool = std::make_shared<carla::BufferPool>(settings);
+  {
+    auto big = pool->Pop(1u << 20);
+    big.reset(1u << 20);
+  }
+  ASSERT_EQ(pool->GetStats().buffers_held, 1u);
+  std::this_thread::sleep_for(50ms);
+  // Keep using small buffers only, the big one is trimmed.
+  for (auto i = 0u; i < 2u; ++i) {
+    auto small = pool->Pop(100u);
+    small.reset(100u);
+  }
+  const auto stats = pool->GetStats();
+  ASSERT_EQ(stats.buffers_held, 1u);
+  ASSERT_EQ(stats.bytes_held, 100u);
+  ASSERT_EQ(stats.bytes_released, 1u << 20);
+}
@@ -0,0 +1,219 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "Random.h"
+
+#include <carla/StopWatch.h>
+#include <carla/sensor/FogIntensityGrid.h>
+#include <carla/sensor/FogIntensityKernel.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace carla::sensor;
+
+namespace {
+
+  struct Channel {
+    explicit Channel(size_t size)
+      : distance(size),
+        beta0(size),
+        noise_factor(size),
+        intensity(size),
+        scaling(size),
+        is_soft(size) {
+      for (auto i = 0u; i < size; ++i) {
+        distance[i] = static_cast<float>(util::Random::Uniform(0.5, 220.0));
+        beta0[i] = static_cast<float>(util::Random::Uniform(0.0, 0.37) / 1e5 / M_PI);
+        noise_factor[i] = static_cast<float>(util::Random::Uniform(0.9, 1.1));
+      }
+    }
+
+    FogIntensityBatch MakeBatch() {
+      FogIntensityBatch batch;
+      batch.size = distance.size();
+      batch.distance = distance.data();
+      batch.beta0 = beta0.data();
+      batch.noise_factor = noise_factor.data();
+      batch.intensity = intensity.data();
+      batch.scaling = scaling.data();
+      batch.is_soft = is_soft.data();
+      return batch;
+    }
+
+    std::vector<float> distance;
+    std::vector<float> beta0;
+    std::vector<float> noise_factor;
+    std::vector<float> intensity;
+    std::vector<float> scaling;
+    std::vector<uint8_t> is_soft;
+  };
+
+  struct Table {
+    Table() : distance(2001u), integral(2001u) {
+      for (auto i = 0u; i < distance.size(); ++i) {
+        const float d = static_cast<float>(i) / 10.0f;
+        distance[i] = d + 0.05f;
+        integral[i] = 1e-3f * std::exp(-0.05f * d) / (1.0f + d);
+      }
+    }
+
+    FogIntensityParameters MakeParameters(bool is_foggy) const {
+      FogIntensityParameters params;
+      params.is_foggy = is_foggy;
+      params.alpha = is_foggy ? std::log(20.0f) / 50.0f : 0.000229f;
+      params.beta = is_foggy ? 0.046f / 50.0f : 0.0000046f;
+      params.step_distance = distance.data();
+      params.step_integral = integral.data();
+      params.table_size = static_cast<uint32_t>(distance.size());
+      return params;
+    }
+
+    std::vector<float> distance;
+    std::vector<float> integral;
+  };
+
+} // namespace
+
+static void check_kernel(bool is_foggy) {
+  constexpr size_t size = 1003u; // not a multiple of the vector width.
+  const Table table;
+  const auto params = table.MakeParameters(is_foggy);
+  Channel scalar(size);
+  Channel vectorized = scalar;
+  FogIntensityKernel::ComputeScalar(params, scalar.MakeBatch());
+  FogIntensityKernel::Compute(params, vectorized.MakeBatch());
+  size_t soft_count = 0u;
+  for (auto i = 0u; i < size; ++i) {
+    const float tolerance = 1e-4f * std::max(1.0f, std::abs(scalar.intensity[i]));
+    if (scalar.is_soft[i] != vectorized.is_soft[i]) {
+      // Only acceptable if soft and hard returns are (almost) equal.
+      ASSERT_NEAR(scalar.intensity[i], vectorized.intensity[i], tolerance);
+      continue;
+    }
+    ASSERT_NEAR(scalar.intensity[i], vectorized.intensity[i], tolerance);
+    ASSERT_NEAR(scalar.scaling[i], vectorized.scaling[i], 1e-4f);
+    soft_count += scalar.is_soft[i];
+  }
+  if (is_foggy) {
+    ASSERT_GT(soft_count, 0u);
+  } else {
+    ASSERT_EQ(soft_count, 0u);
+  }
+}
+
+TEST(fog_intensity_kernel, clear_weather) {
+  check_kernel(false);
+}
+
+TEST(fog_intensity_kernel, fog) {
+  check_kernel(true);
+}
+
+TEST(fog_intensity_kernel, no_table) {
+  const Table table;
+  auto params = table.MakeParameters(true);
+  params.step_distance = nullptr;
+  params.step_integral = nullptr;
+  Channel channel(37u);
+  FogIntensityKernel::Compute(params, channel.MakeBatch());
+  for (auto i = 0u; i < channel.is_soft.size(); ++i) {
+    ASSERT_EQ(channel.is_soft[i], 0u);
+    ASSERT_EQ(channel.scaling[i], 1.0f);
+    ASSERT_LE(channel.intensity[i], 255.0f);
+  }
+}
+
+TEST(fog_intensity_kernel, table_interpolation) {
+  const Table table;
+  const auto params = table.MakeParameters(true);
+  float distance;
+  float integral;
+  params.SampleTable(12.3f, distance, integral);
+  ASSERT_FLOAT_EQ(distance, table.distance[123u]);
+  params.SampleTable(12.34f, distance, integral);
+  ASSERT_NEAR(distance, 0.6f * table.distance[123u] + 0.4f * table.distance[124u], 1e-4f);
+  ASSERT_NEAR(integral, 0.6f * table.integral[123u] + 0.4f * table.integral[124u], 1e-9f);
+  params.SampleTable(500.0f, distance, integral);
+  ASSERT_FLOAT_EQ(distance, table.distance.back());
+  params.SampleTable(-1.0f, distance, integral);
+  ASSERT_FLOAT_EQ(distance, table.distance.front());
+}
+
+TEST(fog_intensity_grid, interpolation) {
+  constexpr uint32_t columns = 5u;
+  FogIntensityGrid grid{columns, 10.0f, 0.4f};
+  const std::vector<float> low = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+  const std::vector<float> high = {3.0f, 4.0f, 5.0f, 6.0f, 7.0f};
+  // Rows are sorted on insertion.
+  grid.AddRow(0.2f, high.data(), high.data());
+  grid.AddRow(0.1f, low.data(), low.data());
+  ASSERT_EQ(grid.rows(), 2u);
+  ASSERT_EQ(grid.alphas().front(), 0.1f);
+
+  std::vector<float> distance(columns);
+  std::vector<float> integral(columns);
+  grid.Interpolate(0.15f, distance.data(), integral.data());
+  for (auto i = 0u; i < columns; ++i) {
+    ASSERT_NEAR(distance[i], 0.5f * (low[i] + high[i]), 1e-5f);
+    ASSERT_NEAR(integral[i], 0.5f * (low[i] + high[i]), 1e-5f);
+  }
+  grid.Interpolate(0.01f, distance.data(), integral.data());
+  ASSERT_EQ(distance, low);
+  grid.Interpolate(1.0f, distance.data(), integral.data());
+  ASSERT_EQ(distance, high);
+}
+
+TEST(fog_intensity_grid, binary_cache) {
+  const Table table;
+  FogIntensityGrid grid{static_cast<uint32_t>(table.distance.size()), 10.0f, 200.0f};
+  grid.AddRow(0.005f, table.distance.data(), table.integral.data());
+  grid.AddRow(0.2f, table.integral.data(), table.distance.data());
+  const auto buffer = grid.Serialize(42u);
+
+  FogIntensityGrid result;
+  ASSERT_FALSE(FogIntensityGrid::Deserialize(buffer.data(), buffer.size(), 43u, result));
+  ASSERT_FALSE(FogIntensityGrid::Deserialize(buffer.data(), buffer.size() - 1u, 42u, result));
+  ASSERT_TRUE(result.empty());
+  ASSERT_TRUE(FogIntensityGrid::Deserialize(buffer.data(), buffer.size(), 42u, result));
+  ASSERT_EQ(result.rows(), grid.rows());
+  ASSERT_EQ(result.columns(), grid.columns());
+  ASSERT_EQ(result.alphas(), grid.alphas());
+
+  std::vector<float> expected(grid.columns() * 2u);
+  std::vector<float> actual(grid.columns() * 2u);
+  grid.Interpolate(0.1f, expected.data(), expected.data() + grid.columns());
+  result.Interpolate(0.1f, actual.data(), actual.data() + grid.columns());
+  ASSERT_EQ(expected, actual);
+}
+
+TEST(fog_intensity_kernel, benchmark) {
+  // 128 channels, 2.6M points per second at 20 FPS.
+  constexpr size_t channels = 128u;
+  constexpr size_t points_per_channel = 2600000u / 20u / channels;
+  constexpr size_t iterations = 50u;
+  const Table table;
+  const auto params = table.MakeParameters(true);
+  std::vector<Channel> data(channels, Channel(points_per_channel));
+
+  auto run = [&](auto &&kernel) {
+    carla::StopWatch stop_watch;
+    for (auto i = 0u; i < iterations; ++i) {
+      for (auto &channel : data) {
+        kernel(params, channel.MakeBatch());
+      }
+    }
+    stop_watch.Stop();
+    return stop_watch.GetElapsedTime<std::chrono::microseconds>();
+  };
+
+  const auto scalar = run([](const auto &p, const auto &b) { FogIntensityKernel::ComputeScalar(p, b); });
+  const auto vectorized = run([](const auto &p, const auto &b) { FogIntensityKernel::Compute(p, b); });
+  carla::logging::log(
+      "fog intensity kernel:", iterations, "frames of", channels * points_per_channel, "points,",
+      "scalar", scalar, "us, vectorized", vectorized, "us");
+}
@@ -0,0 +1,93 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "Random.h"
+
+#include <carla/sensor/s11n/LidarWithFogSerializer.h>
+
+#include <vector>
+
+using namespace carla::sensor;
+using data::LidarWithFogDetection;
+using data::LidarWithFogQuantizedDetection;
+using s11n::LidarWithFogSerializer;
+
+namespace {
+
+  struct FakeSensor {};
+
+} // namespace
+
+static size_t total_size(const carla::BufferList &buffers) {
+  size_t size = 0u;
+  for (const auto &buffer : buffers) {
+    size += buffer.size();
+  }
+  return size;
+}
+
+static std::vector<LidarWithFogDetection> make_points(size_t count) {
+  std::vector<LidarWithFogDetection> points(count);
+  for (auto &point : points) {
+    point = LidarWithFogDetection{
+        static_cast<float>(util::Random::Uniform(-200.0, 200.0)),
+        static_cast<float>(util::Random::Uniform(-200.0, 200.0)),
+        static_cast<float>(util::Random::Uniform(-10.0, 10.0)),
+        static_cast<float>(util::Random::Uniform(0.0, 255.0)),
+        static_cast<uint32_t>(util::Random::Uniform(0.0, 30.0))};
+  }
+  return points;
+}
+
+TEST(lidar_with_fog_serializer, quantization) {
+  static_assert(sizeof(LidarWithFogQuantizedDetection) == 8u, "Invalid quantized size");
+  const auto points = make_points(1000u);
+  float position_scale;
+  float intensity_scale;
+  LidarWithFogSerializer::ComputeQuantizationScales(
+      points.data(), points.size(), position_scale, intensity_scale);
+
+  std::vector<LidarWithFogQuantizedDetection> quantized(points.size());
+  std::vector<LidarWithFogDetection> result(points.size());
+  LidarWithFogSerializer::Quantize(
+      points.data(), points.size(), position_scale, intensity_scale, quantized.data());
+  LidarWithFogSerializer::Dequantize(
+      quantized.data(), quantized.size(), position_scale, intensity_scale, result.data());
+
+  for (auto i = 0u; i < points.size(); ++i) {
+    ASSERT_NEAR(result[i].point.x, points[i].point.x, position_scale);
+    ASSERT_NEAR(result[i].point.y, points[i].point.y, position_scale);
+    ASSERT_NEAR(result[i].point.z, points[i].point.z, position_scale);
+    ASSERT_NEAR(result[i].intensity, points[i].intensity, intensity_scale);
+    ASSERT_EQ(result[i].object_tag, points[i].object_tag);
+  }
+}
+
+TEST(lidar_with_fog_serializer, quantized_size) {
+  constexpr uint32_t channels = 4u;
+  data::LidarWithFogData data{channels};
+  data.ResetChannelSlices(std::vector<uint32_t>(channels, 100u));
+  auto points = make_points(100u);
+  for (auto channel = 0u; channel < channels; ++channel) {
+    for (auto i = 0u; i < points.size(); ++i) {
+      data.WritePointAsync(channel, i, points[i]);
+    }
+  }
+  data.CompactChannelSlices(std::vector<uint32_t>(channels, 100u));
+
+  const auto full = total_size(LidarWithFogSerializer::Serialize(FakeSensor{}, data, carla::Buffer{}));
+  data.SetEncoding(data::LidarWithFogEncoding::Quantized);
+  const auto quantized = LidarWithFogSerializer::Serialize(FakeSensor{}, data, carla::Buffer{});
+  // The header is written to the output buffer too, ahead of the points.
+  ASSERT_EQ(quantized.size(), 1u);
+  ASSERT_LT(2u * total_size(quantized), full);
+
+  const size_t header_size = full - channels * points.size() * sizeof(LidarWithFogDetection);
+  ASSERT_EQ(
+      quantized[0u].size(),
+      header_size + channels * points.size() * sizeof(LidarWithFogQuantizedDetection));
+}
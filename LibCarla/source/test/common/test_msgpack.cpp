@@ -8,6 +8,7 @@
 
 #include <carla/MsgPackAdaptors.h>
 #include <carla/rpc/Actor.h>
+#include <carla/rpc/RayCastBatch.h>
 #include <carla/rpc/Response.h>
 
 #include <thread>
@@ -71,6 +72,38 @@ TEST(msgpack, actor) {
   ASSERT_EQ(result.bounding_box, actor.bounding_box);
 }
 
+TEST(msgpack, ray_cast_batch) {
+  namespace c = carla;
+  namespace cr = carla::rpc;
+  cr::RayCastBatch rays{50.0f};
+  for (auto i = 0; i < 10; ++i) {
+    rays.Add(cr::Location{static_cast<float>(i), 2.0f, 3.0f}, cr::Vector3D{0.0f, 0.0f, -1.0f});
+  }
+  auto buffer = c::MsgPack::Pack(rays);
+  auto result = c::MsgPack::UnPack<cr::RayCastBatch>(buffer);
+  ASSERT_TRUE(result.IsValid());
+  ASSERT_EQ(result.size(), 10u);
+  ASSERT_EQ(result.origin_x[7u], 7.0f);
+  ASSERT_EQ(result.direction_z[7u], -1.0f);
+  ASSERT_EQ(result.max_distance, 50.0f);
+
+  std::vector<cr::RayCastHit> hits(3u);
+  hits[1u].location = cr::Location{4.0f, 5.0f, 6.0f};
+  hits[1u].distance = 12.5f;
+  hits[1u].label = cr::CityObjectLabel::Roads;
+  hits[1u].hit = true;
+  std::vector<uint8_t> packed(hits.size() * sizeof(cr::RayCastHit));
+  std::memcpy(packed.data(), hits.data(), packed.size());
+  auto unpacked = c::MsgPack::UnPack<std::vector<uint8_t>>(c::MsgPack::Pack(packed));
+  auto result_hits = cr::RayCastHit::Unpack(unpacked);
+  ASSERT_EQ(result_hits.size(), 3u);
+  ASSERT_FALSE(result_hits[0u].hit);
+  ASSERT_TRUE(result_hits[1u].hit);
+  ASSERT_EQ(result_hits[1u].distance, 12.5f);
+  ASSERT_EQ(result_hits[1u].label, cr::CityObjectLabel::Roads);
+  ASSERT_EQ(result_hits[1u].location.y, 5.0f);
+}
+
 TEST(msgpack, variant) {
   using mp = carla::MsgPack;
 
@@ -0,0 +1,120 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/trafficmanager/RingBuffer.h>
+
+#include <deque>
+#include <stdexcept>
+#include <vector>
+
+using carla::traffic_manager::RingBuffer;
+
+template <typename T>
+static void CheckEqual(const RingBuffer<T> &buffer, const std::deque<T> &expected) {
+  ASSERT_EQ(buffer.size(), expected.size());
+  ASSERT_EQ(buffer.empty(), expected.empty());
+  std::vector<T> items(buffer.begin(), buffer.end());
+  ASSERT_EQ(items, std::vector<T>(expected.begin(), expected.end()));
+  for (auto i = 0u; i < expected.size(); ++i) {
+    ASSERT_EQ(buffer[i], expected[i]);
+    ASSERT_EQ(buffer.at(i), expected[i]);
+  }
+  if (!expected.empty()) {
+    ASSERT_EQ(buffer.front(), expected.front());
+    ASSERT_EQ(buffer.back(), expected.back());
+  }
+}
+
+TEST(ring_buffer, wraparound_across_grow) {
+  RingBuffer<int> buffer;
+  std::deque<int> expected;
+  // Move the head away from the start of the array, so the next growths
+  // copy a sequence that wraps around its end.
+  for (int i = 0; i < 10; ++i) {
+    buffer.push_back(i);
+    expected.push_back(i);
+  }
+  for (int i = 0; i < 7; ++i) {
+    buffer.pop_front();
+    expected.pop_front();
+  }
+  for (int i = 10; i < 100; ++i) {
+    buffer.push_back(i);
+    expected.push_back(i);
+    CheckEqual(buffer, expected);
+  }
+}
+
+TEST(ring_buffer, push_front_pop_back) {
+  RingBuffer<int> buffer;
+  std::deque<int> expected;
+  for (int i = 0; i < 40; ++i) {
+    if (i % 3 == 0) {
+      buffer.push_back(i);
+      expected.push_back(i);
+    } else {
+      buffer.push_front(i);
+      expected.push_front(i);
+    }
+    CheckEqual(buffer, expected);
+  }
+  while (!expected.empty()) {
+    if (expected.size() % 2u == 0u) {
+      buffer.pop_back();
+      expected.pop_back();
+    } else {
+      buffer.pop_front();
+      expected.pop_front();
+    }
+    CheckEqual(buffer, expected);
+  }
+  buffer.push_front(42);
+  expected.push_front(42);
+  CheckEqual(buffer, expected);
+}
+
+TEST(ring_buffer, at_out_of_range) {
+  RingBuffer<int> buffer;
+  ASSERT_THROW(buffer.at(0u), std::out_of_range);
+  buffer.push_back(1);
+  buffer.push_back(2);
+  ASSERT_EQ(buffer.at(1u), 2);
+  ASSERT_THROW(buffer.at(2u), std::out_of_range);
+  buffer.pop_front();
+  ASSERT_THROW(buffer.at(1u), std::out_of_range);
+  const auto &const_buffer = buffer;
+  ASSERT_EQ(const_buffer.at(0u), 2);
+  ASSERT_THROW(const_buffer.at(1u), std::out_of_range);
+}
+
+TEST(ring_buffer, iteration) {
+  RingBuffer<int> buffer;
+  ASSERT_TRUE(buffer.begin() == buffer.end());
+  for (int i = 0; i < 20; ++i) {
+    buffer.push_front(i);
+  }
+  int expected = 19;
+  for (auto it = buffer.begin(); it != buffer.end(); ++it) {
+    ASSERT_EQ(*it, expected);
+    --expected;
+  }
+  ASSERT_EQ(expected, -1);
+  // Modify the items through the iterator.
+  for (auto &item : buffer) {
+    item *= 2;
+  }
+  const auto &const_buffer = buffer;
+  expected = 19;
+  for (const auto &item : const_buffer) {
+    ASSERT_EQ(item, 2 * expected);
+    --expected;
+  }
+  buffer.clear();
+  ASSERT_TRUE(buffer.empty());
+  ASSERT_TRUE(buffer.begin() == buffer.end());
+}
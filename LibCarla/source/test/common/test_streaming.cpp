@@ -10,8 +10,10 @@
 #include <carla/streaming/Client.h>
 #include <carla/streaming/Server.h>
 #include <carla/streaming/detail/Dispatcher.h>
+#include <carla/streaming/detail/shm/SharedMemoryRing.h>
 #include <carla/streaming/detail/tcp/Client.h>
 #include <carla/streaming/detail/tcp/Server.h>
+#include <carla/streaming/detail/tcp/SessionQueue.h>
 #include <carla/streaming/low_level/Client.h>
 #include <carla/streaming/low_level/Server.h>
 
@@ -259,3 +261,280 @@ TEST(streaming, multi_stream) {
     }
   }
 }
+
+TEST(streaming, shared_memory_ring) {
+  using namespace carla::streaming::detail::shm;
+  using namespace util::buffer;
+  if (!SharedMemoryRing::IsSupported()) {
+    return;
+  }
+  constexpr size_t number_of_messages = 200u;
+  const std::string name = "/carla-test-ring-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+  auto producer = SharedMemoryRing::Create(name, SharedMemoryRing::min_capacity);
+  ASSERT_NE(producer, nullptr);
+  auto consumer = SharedMemoryRing::Open(name);
+  ASSERT_NE(consumer, nullptr);
+  ASSERT_EQ(consumer->GetCapacity(), SharedMemoryRing::min_capacity);
+
+  // Sizes chosen so the records wrap around the end of the ring.
+  std::vector<const_shared_buffer> messages;
+  for (auto i = 0u; i < number_of_messages; ++i) {
+    auto message = make_empty(1u + (i * 7919u) % 100000u);
+    for (auto j = 0u; j < message->size(); ++j) {
+      message->data()[j] = static_cast<unsigned char>((i + j) % 251u);
+    }
+    messages.emplace_back(std::move(message));
+  }
+
+  auto next = SharedMemoryRing::Create(name + "-next", SharedMemoryRing::CapacityFor(1u << 20));
+  ASSERT_NE(next, nullptr);
+
+  carla::ThreadGroup writer;
+  writer.CreateThread([&]() {
+    for (auto i = 0u; i < number_of_messages / 2u; ++i) {
+      const carla::streaming::detail::message_size_type size = messages[i]->size();
+      const std::array<boost::asio::const_buffer, 2u> buffers = {
+          boost::asio::buffer(&size, sizeof(size)),
+          messages[i]->cbuffer()};
+      ASSERT_TRUE(producer->Write(buffers, true));
+    }
+    ASSERT_TRUE(producer->WriteRedirect(next->GetName(), true));
+    for (auto i = number_of_messages / 2u; i < number_of_messages; ++i) {
+      const carla::streaming::detail::message_size_type size = messages[i]->size();
+      const std::array<boost::asio::const_buffer, 2u> buffers = {
+          boost::asio::buffer(&size, sizeof(size)),
+          messages[i]->cbuffer()};
+      ASSERT_TRUE(next->Write(buffers, true));
+    }
+  });
+
+  std::string redirect;
+  for (auto i = 0u; i < number_of_messages; ++i) {
+    carla::Buffer received;
+    auto result = consumer->Read(received, redirect, 1s);
+    if (result == SharedMemoryRing::ReadResult::Redirect) {
+      ASSERT_EQ(i, number_of_messages / 2u);
+      ASSERT_EQ(redirect, name + "-next");
+      consumer = SharedMemoryRing::Open(redirect);
+      ASSERT_NE(consumer, nullptr);
+      result = consumer->Read(received, redirect, 1s);
+    }
+    ASSERT_EQ(result, SharedMemoryRing::ReadResult::Message);
+    ASSERT_EQ(received, *messages[i]);
+  }
+  writer.JoinAll();
+
+  carla::Buffer received;
+  ASSERT_EQ(consumer->Read(received, redirect, 10ms), SharedMemoryRing::ReadResult::Timeout);
+  next->Close();
+  ASSERT_EQ(consumer->Read(received, redirect, 1s), SharedMemoryRing::ReadResult::Closed);
+}
+
+TEST(streaming, shared_memory_large_messages) {
+  using namespace carla::streaming;
+  using namespace util::buffer;
+  constexpr size_t number_of_messages = 20u;
+  // Bigger than the initial ring, so the session has to grow it.
+  const auto message = make_empty(3u * detail::shm::SharedMemoryRing::min_capacity);
+  for (auto i = 0u; i < message->size(); ++i) {
+    message->data()[i] = static_cast<unsigned char>(i % 251u);
+  }
+
+  Server srv(TESTING_PORT);
+  srv.SetSynchronousMode(true);
+  srv.AsyncRun(2u);
+  auto stream = srv.MakeStream();
+
+  std::atomic_size_t message_count{0u};
+  Client c;
+  c.AsyncRun(2u);
+  c.Subscribe(stream.token(), [&](auto buffer) {
+    ASSERT_EQ(buffer, *message);
+    ++message_count;
+  });
+
+  std::this_thread::sleep_for(20ms);
+  for (auto i = 0u; i < number_of_messages; ++i) {
+    stream.Write(carla::Buffer(message->cbuffer()));
+    std::this_thread::sleep_for(10ms);
+  }
+  std::this_thread::sleep_for(100ms);
+  ASSERT_EQ(message_count, number_of_messages);
+}
+
+TEST(streaming, session_queue_policies) {
+  using namespace carla::streaming::detail;
+  using namespace carla::streaming::detail::tcp;
+  using PushResult = SessionQueue::PushResult;
+
+  auto make_message = [](unsigned char value) {
+    carla::Buffer buffer(4u);
+    std::fill(buffer.begin(), buffer.end(), value);
+    return std::make_shared<const Message>(std::move(buffer));
+  };
+  auto pop_value = [](SessionQueue &queue) {
+    SessionQueue::Entry entry;
+    EXPECT_TRUE(queue.Pop(entry));
+    // Skip the header.
+    auto view = std::next(entry.message->GetBufferSequence().begin());
+    return static_cast<const unsigned char *>(view->data())[0u];
+  };
+  constexpr size_t message_bytes = sizeof(message_size_type) + 4u;
+
+  QueueLimits limits = {OverflowPolicy::DropNewest, 2u, 0u};
+
+  {
+    SessionQueue queue;
+    limits.policy = OverflowPolicy::DropNewest;
+    ASSERT_EQ(queue.Push(make_message(1u), limits, 0ms), PushResult::StartSending);
+    ASSERT_EQ(queue.Push(make_message(2u), limits, 0ms), PushResult::Queued);
+    ASSERT_EQ(queue.Push(make_message(3u), limits, 0ms), PushResult::Dropped);
+    auto stats = queue.GetStats();
+    ASSERT_EQ(stats.queued_messages, 2u);
+    ASSERT_EQ(stats.queued_bytes, 2u * message_bytes);
+    ASSERT_EQ(stats.dropped_messages, 1u);
+    ASSERT_EQ(pop_value(queue), 1u);
+    ASSERT_EQ(pop_value(queue), 2u);
+    SessionQueue::Entry entry;
+    ASSERT_FALSE(queue.Pop(entry));
+    ASSERT_EQ(queue.Push(make_message(4u), limits, 0ms), PushResult::StartSending);
+  }
+
+  {
+    SessionQueue queue;
+    limits.policy = OverflowPolicy::DropOldest;
+    for (unsigned char i = 1u; i <= 5u; ++i) {
+      ASSERT_NE(queue.Push(make_message(i), limits, 0ms), PushResult::Dropped);
+    }
+    ASSERT_EQ(queue.GetStats().dropped_messages, 3u);
+    ASSERT_EQ(pop_value(queue), 4u);
+    ASSERT_EQ(pop_value(queue), 5u);
+  }
+
+  {
+    SessionQueue queue;
+    limits.policy = OverflowPolicy::CoalesceLatest;
+    for (unsigned char i = 1u; i <= 5u; ++i) {
+      ASSERT_NE(queue.Push(make_message(i), limits, 0ms), PushResult::Dropped);
+    }
+    ASSERT_EQ(queue.GetStats().queued_messages, 1u);
+    ASSERT_EQ(queue.GetStats().dropped_messages, 4u);
+    ASSERT_EQ(pop_value(queue), 5u);
+  }
+
+  {
+    SessionQueue queue;
+    limits.max_queued_messages = 8u;
+    limits.max_queued_bytes = 2u * message_bytes;
+    limits.policy = OverflowPolicy::DropNewest;
+    ASSERT_EQ(queue.Push(make_message(1u), limits, 0ms), PushResult::StartSending);
+    ASSERT_EQ(queue.Push(make_message(2u), limits, 0ms), PushResult::Queued);
+    ASSERT_EQ(queue.Push(make_message(3u), limits, 0ms), PushResult::Dropped);
+    limits.max_queued_messages = 2u;
+    limits.max_queued_bytes = 0u;
+  }
+
+  {
+    SessionQueue queue;
+    limits.policy = OverflowPolicy::Block;
+    ASSERT_EQ(queue.Push(make_message(1u), limits, 0ms), PushResult::StartSending);
+    ASSERT_EQ(queue.Push(make_message(2u), limits, 0ms), PushResult::Queued);
+    // Times out while full.
+    ASSERT_EQ(queue.Push(make_message(3u), limits, 10ms), PushResult::Dropped);
+    // Unblocked as soon as a message is taken.
+    std::thread consumer([&]() {
+      std::this_thread::sleep_for(20ms);
+      SessionQueue::Entry entry;
+      ASSERT_TRUE(queue.Pop(entry));
+      queue.RecordSent(message_bytes, entry.queued_at);
+    });
+    ASSERT_EQ(queue.Push(make_message(4u), limits, 10s), PushResult::Queued);
+    consumer.join();
+    auto stats = queue.GetStats();
+    ASSERT_EQ(stats.sent_messages, 1u);
+    ASSERT_EQ(stats.sent_bytes, message_bytes);
+    ASSERT_GE(stats.max_latency_us, 20000u);
+    // Closing wakes up blocked writers.
+    std::thread closer([&]() {
+      std::this_thread::sleep_for(20ms);
+      queue.Close();
+    });
+    ASSERT_EQ(queue.Push(make_message(5u), limits, 10s), PushResult::Closed);
+    closer.join();
+    ASSERT_EQ(queue.GetStats().queued_messages, 0u);
+  }
+}
+
+TEST(streaming, synchronous_backpressure) {
+  using namespace carla::streaming;
+  using namespace util::buffer;
+  constexpr size_t number_of_messages = 200u;
+  const std::string message(1u << 16, 'x');
+
+  Server srv(TESTING_PORT);
+  srv.SetSynchronousMode(true);
+  auto settings = srv.GetQueueSettings();
+  ASSERT_EQ(settings.synchronous.policy, detail::OverflowPolicy::Block);
+  settings.synchronous.max_queued_messages = 2u;
+  srv.SetQueueSettings(settings);
+  srv.AsyncRun(2u);
+  auto stream = srv.MakeStream();
+
+  std::atomic_size_t message_count{0u};
+  Client c;
+  c.AsyncRun(1u);
+  c.Subscribe(stream.token(), [&](auto buffer) {
+    ASSERT_EQ(buffer.size(), message.size());
+    // Slow client.
+    if (message_count++ % 10u == 0u) {
+      std::this_thread::sleep_for(1ms);
+    }
+  });
+
+  std::this_thread::sleep_for(20ms);
+  for (auto i = 0u; i < number_of_messages; ++i) {
+    stream << message;
+  }
+  for (auto i = 0u; (i < 100u) && (message_count < number_of_messages); ++i) {
+    std::this_thread::sleep_for(10ms);
+  }
+  ASSERT_EQ(message_count, number_of_messages);
+
+  const auto stats = srv.GetStreamStats(detail::token_type(stream.token()).get_stream_id());
+  ASSERT_EQ(stats.sent_messages, number_of_messages);
+  ASSERT_EQ(stats.dropped_messages, 0u);
+  ASSERT_EQ(stats.queued_messages, 0u);
+  ASSERT_GE(stats.max_latency_us, stats.GetAverageLatency());
+}
+
+TEST(streaming, scatter_gather_message) {
+  using namespace carla::streaming;
+  using namespace util::buffer;
+  constexpr size_t number_of_messages = 20u;
+
+  Server srv(TESTING_PORT);
+  srv.AsyncRun(2u);
+  auto stream = srv.MakeStream();
+
+  std::atomic_size_t message_count{0u};
+  Client c;
+  c.AsyncRun(1u);
+  c.Subscribe(stream.token(), [&](auto buffer) {
+    ASSERT_EQ(as_string(buffer), "header|first|second|third");
+    ++message_count;
+  });
+
+  std::this_thread::sleep_for(20ms);
+  for (auto i = 0u; i < number_of_messages; ++i) {
+    carla::BufferList list;
+    list.emplace_back(std::string("first|"));
+    list.emplace_back();
+    list.emplace_back(std::string("second|"));
+    list.emplace_back(std::string("third"));
+    stream.Write(carla::Buffer(std::string("header|")), std::move(list));
+  }
+  for (auto i = 0u; (i < 100u) && (message_count < number_of_messages); ++i) {
+    std::this_thread::sleep_for(10ms);
+  }
+  ASSERT_EQ(message_count, number_of_messages);
+}
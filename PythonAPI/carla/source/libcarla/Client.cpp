@@ -9,6 +9,8 @@
 #include "carla/client/World.h"
 #include "carla/Logging.h"
 #include "carla/rpc/ActorId.h"
+#include "carla/rpc/BufferPoolStats.h"
+#include "carla/rpc/StreamStats.h"
 #include "carla/trafficmanager/TrafficManager.h"
 
 #include <thread>
@@ -17,6 +19,30 @@
 
 namespace ctm = carla::traffic_manager;
 
+namespace carla {
+namespace rpc {
+
+  std::ostream &operator<<(std::ostream &out, const BufferPoolStats &stats) {
+    out << "BufferPoolStats(bytes_held=" << stats.bytes_held
+        << ", buffers_held=" << stats.buffers_held
+        << ", hits=" << stats.hits
+        << ", allocations=" << stats.allocations
+        << ", buffers_released=" << stats.buffers_released
+        << ", bytes_released=" << stats.bytes_released << ')';
+    return out;
+  }
+
+  std::ostream &operator<<(std::ostream &out, const StreamStats &stats) {
+    out << "StreamStats(queued_messages=" << stats.queued_messages
+        << ", sent_messages=" << stats.sent_messages
+        << ", dropped_messages=" << stats.dropped_messages
+        << ", average_latency_us=" << stats.average_latency_us << ')';
+    return out;
+  }
+
+} // namespace rpc
+} // namespace carla
+
 static void SetTimeout(carla::client::Client &client, double seconds) {
   client.SetTimeout(TimeDurationFromSeconds(seconds));
 }
@@ -186,6 +212,30 @@ void export_client() {
     .def_readwrite("enable_pedestrian_navigation", &rpc::OpendriveGenerationParameters::enable_pedestrian_navigation)
   ;
 
+  class_<rpc::BufferPoolStats>("BufferPoolStats")
+    .def_readonly("bytes_held", &rpc::BufferPoolStats::bytes_held)
+    .def_readonly("buffers_held", &rpc::BufferPoolStats::buffers_held)
+    .def_readonly("hits", &rpc::BufferPoolStats::hits)
+    .def_readonly("allocations", &rpc::BufferPoolStats::allocations)
+    .def_readonly("buffers_released", &rpc::BufferPoolStats::buffers_released)
+    .def_readonly("bytes_released", &rpc::BufferPoolStats::bytes_released)
+    .add_property("hit_rate", &rpc::BufferPoolStats::GetHitRate)
+    .def(self_ns::str(self_ns::self))
+  ;
+
+  class_<rpc::StreamStats>("StreamStats")
+    .def_readonly("queued_messages", &rpc::StreamStats::queued_messages)
+    .def_readonly("queued_bytes", &rpc::StreamStats::queued_bytes)
+    .def_readonly("sent_messages", &rpc::StreamStats::sent_messages)
+    .def_readonly("sent_bytes", &rpc::StreamStats::sent_bytes)
+    .def_readonly("dropped_messages", &rpc::StreamStats::dropped_messages)
+    .def_readonly("dropped_bytes", &rpc::StreamStats::dropped_bytes)
+    .def_readonly("last_latency_us", &rpc::StreamStats::last_latency_us)
+    .def_readonly("max_latency_us", &rpc::StreamStats::max_latency_us)
+    .def_readonly("average_latency_us", &rpc::StreamStats::average_latency_us)
+    .def(self_ns::str(self_ns::self))
+  ;
+
   class_<cc::Client>("Client",
       init<std::string, uint16_t, size_t>((arg("host"), arg("port"), arg("worker_threads")=0u)))
     .def("set_timeout", &::SetTimeout, (arg("seconds")))
@@ -193,6 +243,8 @@ void export_client() {
     .def("get_server_version", CONST_CALL_WITHOUT_GIL(cc::Client, GetServerVersion))
     .def("get_world", &cc::Client::GetWorld)
     .def("get_available_maps", &GetAvailableMaps)
+    .def("get_buffer_pool_stats", CONST_CALL_WITHOUT_GIL(cc::Client, GetBufferPoolStats))
+    .def("get_stream_stats", CONST_CALL_WITHOUT_GIL_1(cc::Client, GetStreamStats, rpc::ActorId), (arg("sensor_id")))
     .def("set_files_base_folder", &cc::Client::SetFilesBaseFolder, (arg("path")))
     .def("get_required_files", &GetRequiredFiles, (arg("folder")="", arg("download")=true))
     .def("request_file", &cc::Client::RequestFile, (arg("name")))
@@ -8,6 +8,7 @@
 #include <carla/image/ImageConverter.h>
 #include <carla/image/ImageIO.h>
 #include <carla/image/ImageView.h>
+#include <carla/pointcloud/AsyncPointCloudWriter.h>
 #include <carla/pointcloud/PointCloudIO.h>
 #include <carla/sensor/SensorData.h>
 #include <carla/sensor/data/CollisionEvent.h>
@@ -31,6 +32,8 @@
 #include <cmath>
 #include <vector>
 #include <algorithm>
+#include <memory>
+#include <mutex>
 #include <thread>
 
 namespace carla {
@@ -207,6 +210,35 @@ static auto GetRawDataAsBuffer(T &self) {
   return boost::python::object(boost::python::handle<>(ptr));
 }
 
+/// NumPy array interface of the fog LiDAR points, as a structured array over
+/// the measurement's own memory. NumPy keeps the measurement alive as the
+/// base of the array, so no copy is ever made.
+static boost::python::dict GetLidarWithFogArrayInterface(
+    carla::sensor::data::LidarWithFogMeasurement &self) {
+  namespace bp = boost::python;
+  using Detection = carla::sensor::data::LidarWithFogDetection;
+  static_assert(sizeof(Detection) == 20u, "Invalid LidarWithFogDetection size");
+  bp::list descr;
+  descr.append(bp::make_tuple("x", "<f4"));
+  descr.append(bp::make_tuple("y", "<f4"));
+  descr.append(bp::make_tuple("z", "<f4"));
+  descr.append(bp::make_tuple("intensity", "<f4"));
+  descr.append(bp::make_tuple("object_tag", "<u4"));
+  bp::dict array_interface;
+  array_interface["version"] = 3;
+  array_interface["shape"] = bp::make_tuple(self.size());
+  array_interface["typestr"] = "|V" + std::to_string(sizeof(Detection));
+  array_interface["descr"] = descr;
+  // Read-only, the measurement is shared with every other callback.
+  array_interface["data"] = bp::make_tuple(reinterpret_cast<uintptr_t>(self.data()), true);
+  return array_interface;
+}
+
+static boost::python::object GetLidarWithFogPoints(boost::python::object self) {
+  namespace bp = boost::python;
+  return bp::import("numpy").attr("asarray")(self);
+}
+
 template <typename T>
 static void ConvertImage(T &self, EColorConverter cc) {
   carla::PythonUtil::ReleaseGIL unlock;
@@ -368,10 +400,46 @@ static std::string SaveImageToDisk(T &self, std::string path, EColorConverter cc
   }
 }
 
+/// Shared by every point cloud saved with blocking=False. Created on first
+/// use and destroyed by ShutdownPointCloudWriter, registered with atexit, so
+/// the worker threads are joined before the interpreter finalizes.
+static std::mutex PointCloudWriterMutex;
+static std::unique_ptr<carla::pointcloud::AsyncPointCloudWriter> PointCloudWriter;
+
 template <typename T>
-static std::string SavePointCloudToDisk(T &self, std::string path) {
+static std::string SavePointCloudToDisk(
+    const boost::shared_ptr<T> &self,
+    std::string path,
+    bool binary,
+    bool blocking) {
   carla::PythonUtil::ReleaseGIL unlock;
-  return carla::pointcloud::PointCloudIO::SaveToDisk(std::move(path), self.begin(), self.end());
+  if (!blocking) {
+    // The pointer given by boost.python holds a reference to the Python
+    // object, take the one owned by LibCarla instead so the workers never
+    // touch the interpreter.
+    auto cloud = boost::static_pointer_cast<const T>(self->shared_from_this());
+    std::lock_guard<std::mutex> lock(PointCloudWriterMutex);
+    if (PointCloudWriter == nullptr) {
+      PointCloudWriter = std::make_unique<carla::pointcloud::AsyncPointCloudWriter>();
+    }
+    return PointCloudWriter->SaveToDisk(std::move(cloud), std::move(path), binary);
+  }
+  return carla::pointcloud::PointCloudIO::SaveToDisk(std::move(path), self->begin(), self->end(), binary);
+}
+
+static void FlushPointCloudWrites() {
+  carla::PythonUtil::ReleaseGIL unlock;
+  std::lock_guard<std::mutex> lock(PointCloudWriterMutex);
+  if (PointCloudWriter != nullptr) {
+    PointCloudWriter->Flush();
+  }
+}
+
+static void ShutdownPointCloudWriter() {
+  carla::PythonUtil::ReleaseGIL unlock;
+  std::lock_guard<std::mutex> lock(PointCloudWriterMutex);
+  // The destructor writes every pending cloud and joins the workers.
+  PointCloudWriter.reset();
 }
 
 void export_sensor_data() {
@@ -463,7 +531,7 @@ void export_sensor_data() {
     .add_property("channels", &csd::LidarMeasurement::GetChannelCount)
     .add_property("raw_data", &GetRawDataAsBuffer<csd::LidarMeasurement>)
     .def("get_point_count", &csd::LidarMeasurement::GetPointCount, (arg("channel")))
-    .def("save_to_disk", &SavePointCloudToDisk<csd::LidarMeasurement>, (arg("path")))
+    .def("save_to_disk", &SavePointCloudToDisk<csd::LidarMeasurement>, (arg("path"), arg("binary")=false, arg("blocking")=true))
     .def("__len__", &csd::LidarMeasurement::size)
     .def("__iter__", iterator<csd::LidarMeasurement>())
     .def("__getitem__", +[](const csd::LidarMeasurement &self, size_t pos) -> csd::LidarDetection {
@@ -479,8 +547,10 @@ void export_sensor_data() {
     .add_property("horizontal_angle", &csd::LidarWithFogMeasurement::GetHorizontalAngle)
     .add_property("channels", &csd::LidarWithFogMeasurement::GetChannelCount)
     .add_property("raw_data", &GetRawDataAsBuffer<csd::LidarWithFogMeasurement>)
+    .add_property("__array_interface__", &GetLidarWithFogArrayInterface)
+    .add_property("points", &GetLidarWithFogPoints)
     .def("get_point_count", &csd::LidarWithFogMeasurement::GetPointCount, (arg("channel")))
-    .def("save_to_disk", &SavePointCloudToDisk<csd::LidarWithFogMeasurement>, (arg("path")))
+    .def("save_to_disk", &SavePointCloudToDisk<csd::LidarWithFogMeasurement>, (arg("path"), arg("binary")=false, arg("blocking")=true))
     .def("__len__", &csd::LidarWithFogMeasurement::size)
     .def("__iter__", iterator<csd::LidarWithFogMeasurement>())
     .def("__getitem__", +[](const csd::LidarWithFogMeasurement &self, size_t pos) -> csd::LidarWithFogDetection {
@@ -497,7 +567,7 @@ void export_sensor_data() {
     .add_property("channels", &csd::SemanticLidarMeasurement::GetChannelCount)
     .add_property("raw_data", &GetRawDataAsBuffer<csd::SemanticLidarMeasurement>)
     .def("get_point_count", &csd::SemanticLidarMeasurement::GetPointCount, (arg("channel")))
-    .def("save_to_disk", &SavePointCloudToDisk<csd::SemanticLidarMeasurement>, (arg("path")))
+    .def("save_to_disk", &SavePointCloudToDisk<csd::SemanticLidarMeasurement>, (arg("path"), arg("binary")=false, arg("blocking")=true))
     .def("__len__", &csd::SemanticLidarMeasurement::size)
     .def("__iter__", iterator<csd::SemanticLidarMeasurement>())
     .def("__getitem__", +[](const csd::SemanticLidarMeasurement &self, size_t pos) -> csd::SemanticLidarDetection {
@@ -614,4 +684,8 @@ void export_sensor_data() {
     .def("to_array_pol", CALL_RETURNING_LIST(csd::DVSEventArray, ToArrayPol))
     .def(self_ns::str(self_ns::self))
   ;
+
+  // Wait until every point cloud saved with blocking=False is on disk.
+  def("flush_point_cloud_writes", &FlushPointCloudWrites);
+  import("atexit").attr("register")(make_function(&ShutdownPointCloudWriter));
 }
@@ -108,6 +108,7 @@ void export_trafficmanager() {
     .def("set_hybrid_physics_mode", &ctm::TrafficManager::SetHybridPhysicsMode)
     .def("set_hybrid_physics_radius", &ctm::TrafficManager::SetHybridPhysicsRadius)
     .def("set_random_device_seed", &ctm::TrafficManager::SetRandomDeviceSeed)
+    .def("set_worker_threads", &ctm::TrafficManager::SetWorkerThreads)
     .def("set_osm_mode", &carla::traffic_manager::TrafficManager::SetOSMMode)
     .def("set_path", &InterSetCustomPath, (arg("empty_buffer") = true))
     .def("set_route", &InterSetImportedRoute, (arg("empty_buffer") = true))
@@ -82,6 +82,42 @@ static auto GetActorsById(carla::client::World &self, const boost::python::list
   return self.GetActors(ids);
 }
 
+static boost::python::list CastRays(
+    const carla::client::World &self,
+    const boost::python::object &origins,
+    const boost::python::object &directions,
+    float max_distance) {
+  namespace py = boost::python;
+  carla::rpc::RayCastBatch rays{max_distance};
+  const auto count = py::len(origins);
+  if (py::len(directions) != count) {
+    PyErr_SetString(PyExc_ValueError, "origins and directions must have the same length");
+    py::throw_error_already_set();
+  }
+  rays.reserve(count);
+  for (auto i = 0; i < count; ++i) {
+    rays.Add(
+        py::extract<carla::geom::Location>(origins[i]),
+        py::extract<carla::geom::Vector3D>(directions[i]));
+  }
+  std::vector<carla::rpc::RayCastHit> hits;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    hits = self.CastRays(rays);
+  }
+  py::list result;
+  for (const auto &hit : hits) {
+    if (hit.hit) {
+      result.append(py::make_tuple(
+          carla::rpc::LabelledPoint(hit.location, hit.label),
+          hit.distance));
+    } else {
+      result.append(py::object());
+    }
+  }
+  return result;
+}
+
 static auto GetVehiclesLightStates(carla::client::World &self) {
   boost::python::dict dict;
   auto list = self.GetVehiclesLightStates();
@@ -339,6 +375,7 @@ void export_world() {
     .def("get_environment_objects", &GetEnvironmentObjects, (arg("object_type")=cr::CityObjectLabel::Any))
     .def("enable_environment_objects", &EnableEnvironmentObjects, (arg("env_objects_ids"), arg("enable")))
     .def("cast_ray", CALL_RETURNING_LIST_2(cc::World, CastRay, cg::Location, cg::Location), (arg("initial_location"), arg("final_location")))
+    .def("cast_rays", &CastRays, (arg("origins"), arg("directions"), arg("max_distance")=10000.f))
     .def("project_point", CALL_RETURNING_OPTIONAL_3(cc::World, ProjectPoint, cg::Location, cg::Vector3D, float), (arg("location"), arg("direction"), arg("search_distance")=10000.f))
     .def("ground_projection", CALL_RETURNING_OPTIONAL_2(cc::World, GroundProjection, cg::Location, float), (arg("location"), arg("search_distance")=10000.f))
     .def("get_names_of_all_objects", CALL_RETURNING_LIST(cc::World, GetNamesOfAllObjects))
@@ -0,0 +1,107 @@
+#!/usr/bin/env python
+
+# Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma de
+# Barcelona (UAB).
+#
+# This work is licensed under the terms of the MIT license.
+# For a copy, see <https://opensource.org/licenses/MIT>.
+
+"""
+Measures the latency of apply_batch_sync with one ApplyVehicleControl command
+per vehicle, for an increasing number of vehicles. The simulator runs in
+synchronous mode and the world is ticked between batches, mirroring the way
+the Traffic Manager sends its commands.
+"""
+
+import glob
+import os
+import sys
+import argparse
+import random
+import time
+
+try:
+    sys.path.append(glob.glob('../carla/dist/carla-*%d.%d-%s.egg' % (
+        sys.version_info.major,
+        sys.version_info.minor,
+        'win-amd64' if os.name == 'nt' else 'linux-x86_64'))[0])
+except IndexError:
+    pass
+
+import carla
+
+
+def spawn_vehicles(client, world, count):
+    blueprints = [bp for bp in world.get_blueprint_library().filter('vehicle.*')
+                  if int(bp.get_attribute('number_of_wheels')) == 4]
+    spawn_points = world.get_map().get_spawn_points()
+    random.shuffle(spawn_points)
+    if count > len(spawn_points):
+        print('warning: the map only has %d spawn points' % len(spawn_points))
+    batch = [carla.command.SpawnActor(random.choice(blueprints), transform)
+             for transform in spawn_points[:count]]
+    return [r.actor_id for r in client.apply_batch_sync(batch, True) if not r.error]
+
+
+def measure(client, world, vehicles, iterations):
+    latencies = []
+    for _ in range(iterations):
+        control = carla.VehicleControl(throttle=random.random(), steer=random.uniform(-1.0, 1.0))
+        batch = [carla.command.ApplyVehicleControl(actor_id, control) for actor_id in vehicles]
+        start = time.perf_counter()
+        client.apply_batch_sync(batch)
+        latencies.append(time.perf_counter() - start)
+        world.tick()
+    latencies.sort()
+    mean = sum(latencies) / len(latencies)
+    return mean, latencies[len(latencies) // 2], latencies[int(0.95 * (len(latencies) - 1))]
+
+
+def main():
+    argparser = argparse.ArgumentParser(description=__doc__)
+    argparser.add_argument(
+        '--host', default='127.0.0.1', help='IP of the host server (default: 127.0.0.1)')
+    argparser.add_argument(
+        '-p', '--port', default=2000, type=int, help='TCP port to listen to (default: 2000)')
+    argparser.add_argument(
+        '-n', '--vehicles', default=[50, 100, 200, 300, 400], type=int, nargs='+',
+        help='Number of vehicles of each run (default: 50 100 200 300 400)')
+    argparser.add_argument(
+        '-i', '--iterations', default=200, type=int,
+        help='Batches sent on each run (default: 200)')
+    argparser.add_argument(
+        '-s', '--seed', default=42, type=int, help='Random seed (default: 42)')
+    args = argparser.parse_args()
+
+    random.seed(args.seed)
+    client = carla.Client(args.host, args.port)
+    client.set_timeout(20.0)
+    world = client.get_world()
+
+    original_settings = world.get_settings()
+    settings = world.get_settings()
+    settings.synchronous_mode = True
+    settings.fixed_delta_seconds = 0.05
+    world.apply_settings(settings)
+
+    print('| vehicles | mean (ms) | median (ms) | p95 (ms) |')
+    print('|---------:|----------:|------------:|---------:|')
+    try:
+        for count in args.vehicles:
+            vehicles = spawn_vehicles(client, world, count)
+            try:
+                world.tick()
+                mean, median, p95 = measure(client, world, vehicles, args.iterations)
+                print('| %8d | %9.3f | %11.3f | %8.3f |' % (
+                    len(vehicles), 1e3 * mean, 1e3 * median, 1e3 * p95))
+            finally:
+                client.apply_batch_sync([carla.command.DestroyActor(x) for x in vehicles], True)
+    finally:
+        world.apply_settings(original_settings)
+
+
+if __name__ == '__main__':
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
@@ -0,0 +1,123 @@
+#!/usr/bin/env python
+
+# Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma de
+# Barcelona (UAB).
+#
+# This work is licensed under the terms of the MIT license.
+# For a copy, see <https://opensource.org/licenses/MIT>.
+
+"""
+Measures the step time of the Traffic Manager for an increasing number of
+vehicles in autopilot, running its stages with different numbers of worker
+threads. The simulator runs in synchronous mode, so every world tick waits for
+the Traffic Manager to send the commands of all the vehicles.
+"""
+
+import glob
+import os
+import sys
+import argparse
+import random
+import time
+
+try:
+    sys.path.append(glob.glob('../carla/dist/carla-*%d.%d-%s.egg' % (
+        sys.version_info.major,
+        sys.version_info.minor,
+        'win-amd64' if os.name == 'nt' else 'linux-x86_64'))[0])
+except IndexError:
+    pass
+
+import carla
+
+
+def spawn_vehicles(client, world, count, tm_port):
+    blueprints = [bp for bp in world.get_blueprint_library().filter('vehicle.*')
+                  if int(bp.get_attribute('number_of_wheels')) == 4]
+    spawn_points = world.get_map().get_spawn_points()
+    random.shuffle(spawn_points)
+    if count > len(spawn_points):
+        print('warning: the map only has %d spawn points' % len(spawn_points))
+    batch = [carla.command.SpawnActor(random.choice(blueprints), transform)
+             .then(carla.command.SetAutopilot(carla.command.FutureActor, True, tm_port))
+             for transform in spawn_points[:count]]
+    return [r.actor_id for r in client.apply_batch_sync(batch, True) if not r.error]
+
+
+def measure(world, warmup, iterations):
+    for _ in range(warmup):
+        world.tick()
+    steps = []
+    for _ in range(iterations):
+        start = time.perf_counter()
+        world.tick()
+        steps.append(time.perf_counter() - start)
+    steps.sort()
+    mean = sum(steps) / len(steps)
+    return mean, steps[len(steps) // 2], steps[int(0.95 * (len(steps) - 1))]
+
+
+def main():
+    argparser = argparse.ArgumentParser(description=__doc__)
+    argparser.add_argument(
+        '--host', default='127.0.0.1', help='IP of the host server (default: 127.0.0.1)')
+    argparser.add_argument(
+        '-p', '--port', default=2000, type=int, help='TCP port to listen to (default: 2000)')
+    argparser.add_argument(
+        '--tm-port', default=8000, type=int, help='Port of the Traffic Manager (default: 8000)')
+    argparser.add_argument(
+        '-n', '--vehicles', default=[50, 100, 200, 300], type=int, nargs='+',
+        help='Number of vehicles of each run (default: 50 100 200 300)')
+    argparser.add_argument(
+        '-t', '--threads', default=[1, 2, 4, 8], type=int, nargs='+',
+        help='Worker threads of the Traffic Manager on each run (default: 1 2 4 8)')
+    argparser.add_argument(
+        '-w', '--warmup', default=50, type=int,
+        help='Ticks before measuring, while the vehicles start moving (default: 50)')
+    argparser.add_argument(
+        '-i', '--iterations', default=200, type=int,
+        help='Ticks measured on each run (default: 200)')
+    argparser.add_argument(
+        '-s', '--seed', default=42, type=int, help='Random seed (default: 42)')
+    args = argparser.parse_args()
+
+    random.seed(args.seed)
+    client = carla.Client(args.host, args.port)
+    client.set_timeout(20.0)
+    world = client.get_world()
+
+    original_settings = world.get_settings()
+    settings = world.get_settings()
+    settings.synchronous_mode = True
+    settings.fixed_delta_seconds = 0.05
+    world.apply_settings(settings)
+
+    traffic_manager = client.get_trafficmanager(args.tm_port)
+    traffic_manager.set_synchronous_mode(True)
+    traffic_manager.set_random_device_seed(args.seed)
+
+    print('| vehicles | threads | mean (ms) | median (ms) | p95 (ms) |')
+    print('|---------:|--------:|----------:|------------:|---------:|')
+    try:
+        for count in args.vehicles:
+            vehicles = spawn_vehicles(client, world, count, args.tm_port)
+            try:
+                world.tick()
+                for threads in args.threads:
+                    traffic_manager.set_worker_threads(threads)
+                    mean, median, p95 = measure(world, args.warmup, args.iterations)
+                    print('| %8d | %7d | %9.3f | %11.3f | %8.3f |' % (
+                        len(vehicles), threads, 1e3 * mean, 1e3 * median, 1e3 * p95))
+            finally:
+                client.apply_batch_sync([carla.command.DestroyActor(x) for x in vehicles], True)
+    finally:
+        traffic_manager.set_worker_threads(1)
+        traffic_manager.set_synchronous_mode(False)
+        world.apply_settings(original_settings)
+
+
+if __name__ == '__main__':
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
@@ -971,8 +971,26 @@ void UActorBlueprintFunctionLibrary::MakeLidarDefinition(
   StdDevLidar.Id = TEXT("noise_stddev");
   StdDevLidar.Type = EActorAttributeType::Float;
   StdDevLidar.RecommendedValues = { TEXT("0.0") };
-
-  if (Id == "ray_cast" || Id == "ray_cast_with_fog") {
+  // Reflectivity overrides per semantic tag.
+  FActorVariation Reflectivity;
+  Reflectivity.Id = TEXT("reflectivity");
+  Reflectivity.Type = EActorAttributeType::String;
+  Reflectivity.RecommendedValues = { TEXT("") };
+  Reflectivity.bRestrictToRecommended = false;
+  // File with reflectivity overrides per semantic tag.
+  FActorVariation ReflectivityFile;
+  ReflectivityFile.Id = TEXT("reflectivity_file");
+  ReflectivityFile.Type = EActorAttributeType::String;
+  ReflectivityFile.RecommendedValues = { TEXT("") };
+  ReflectivityFile.bRestrictToRecommended = false;
+  // Quantized wire format of the points.
+  FActorVariation QuantizePoints;
+  QuantizePoints.Id = TEXT("quantize_points");
+  QuantizePoints.Type = EActorAttributeType::Bool;
+  QuantizePoints.RecommendedValues = { TEXT("false") };
+  QuantizePoints.bRestrictToRecommended = false;
+
+  if (Id == "ray_cast") {
     Definition.Variations.Append({
       Channels,
       Range,
@@ -988,6 +1006,25 @@ void UActorBlueprintFunctionLibrary::MakeLidarDefinition(
       StdDevLidar,
       HorizontalFOV});
   }
+  else if (Id == "ray_cast_with_fog") {
+    Definition.Variations.Append({
+      Channels,
+      Range,
+      PointsPerSecond,
+      Frequency,
+      UpperFOV,
+      LowerFOV,
+      AtmospAttenRate,
+      NoiseSeed,
+      DropOffGenRate,
+      DropOffIntensityLimit,
+      DropOffAtZeroIntensity,
+      StdDevLidar,
+      HorizontalFOV,
+      Reflectivity,
+      ReflectivityFile,
+      QuantizePoints});
+  }
   else if (Id == "ray_cast_semantic") {
     Definition.Variations.Append({
       Channels,
@@ -1665,6 +1702,12 @@ void UActorBlueprintFunctionLibrary::SetLidar(
       RetrieveActorAttributeToFloat("dropoff_zero_intensity", Description.Variations, Lidar.DropOffAtZeroIntensity);
   Lidar.NoiseStdDev =
       RetrieveActorAttributeToFloat("noise_stddev", Description.Variations, Lidar.NoiseStdDev);
+  Lidar.Reflectivity =
+      RetrieveActorAttributeToString("reflectivity", Description.Variations, Lidar.Reflectivity);
+  Lidar.ReflectivityFile =
+      RetrieveActorAttributeToString("reflectivity_file", Description.Variations, Lidar.ReflectivityFile);
+  Lidar.QuantizePoints =
+      RetrieveActorAttributeToBool("quantize_points", Description.Variations, Lidar.QuantizePoints);
 }
 
 void UActorBlueprintFunctionLibrary::SetGnss(
@@ -53,6 +53,21 @@ static void FCarlaEngine_SetFixedDeltaSeconds(TOptional<double> FixedDeltaSecond
   FApp::SetFixedDeltaTime(FixedDeltaSeconds.Get(0.0));
 }
 
+// frames sent to the secondary servers between two logs of the traffic stats
+static constexpr uint64_t FCarlaEngine_MultiGPUStatsInterval = 1000u;
+
+static void FCarlaEngine_LogMultiGPUStats(carla::multigpu::Router &Router)
+{
+  const auto Stats = Router.GetStats();
+  UE_LOG(LogCarla, Log,
+      TEXT("Secondary servers: %llu frames sent, %llu acknowledged, %llu ack timeouts, %llu messages (%llu bytes) received"),
+      static_cast<uint64>(Stats.frames_sent),
+      static_cast<uint64>(Stats.frames_acknowledged),
+      static_cast<uint64>(Stats.ack_timeouts),
+      static_cast<uint64>(Stats.messages_received),
+      static_cast<uint64>(Stats.bytes_received));
+}
+
 // =============================================================================
 // -- FCarlaEngine -------------------------------------------------------------
 // =============================================================================
@@ -119,7 +134,29 @@ void FCarlaEngine::NotifyInitGame(const UCarlaSettings &Settings)
               {
                 TRACE_CPUPROFILER_EVENT_SCOPE_STR("FramesToProcess.emplace_back");
                 std::lock_guard<std::mutex> Lock(FrameToProcessMutex);
-                FramesToProcess.emplace_back(GetCurrentEpisode()->GetFrameData());
+                FramesToProcess.emplace_back(0u, GetCurrentEpisode()->GetFrameData());
+              }
+            }
+            // forces a tick
+            Server.Tick();
+            break;
+          }
+          case carla::multigpu::MultiGPUCommand::SEND_FRAME_DELTA:
+          {
+            if(GetCurrentEpisode())
+            {
+              TRACE_CPUPROFILER_EVENT_SCOPE_STR("MultiGPUCommand::SEND_FRAME_DELTA");
+              // the version was checked when receiving the command
+              auto *Header = reinterpret_cast<const carla::multigpu::FrameHeader *>(Data.data());
+              CarlaStreamBuffer TempStream(
+                  (char *) Data.data() + sizeof(*Header),
+                  Data.size() - sizeof(*Header));
+              std::istream InStream(&TempStream);
+              GetCurrentEpisode()->GetFrameData().Read(InStream, FrameDelta);
+              {
+                TRACE_CPUPROFILER_EVENT_SCOPE_STR("FramesToProcess.emplace_back");
+                std::lock_guard<std::mutex> Lock(FrameToProcessMutex);
+                FramesToProcess.emplace_back(Header->frame, GetCurrentEpisode()->GetFrameData());
               }
             }
             // forces a tick
@@ -152,6 +189,10 @@ void FCarlaEngine::NotifyInitGame(const UCarlaSettings &Settings)
             Secondary->Write(std::move(buf));
             break;
           }
+
+          // only sent by secondary servers
+          case carla::multigpu::MultiGPUCommand::FRAME_ACK:
+            break;
         }
       };
 
@@ -272,7 +313,8 @@ void FCarlaEngine::OnPreTick(UWorld *, ELevelTick TickType, float DeltaSeconds)
         {
           TRACE_CPUPROFILER_EVENT_SCOPE_STR("FramesToProcess.PlayFrameData");
           std::lock_guard<std::mutex> Lock(FrameToProcessMutex);
-          FramesToProcess.front().PlayFrameData(CurrentEpisode, MappedId);
+          FramesToProcess.front().second.PlayFrameData(CurrentEpisode, MappedId);
+          FrameToAcknowledge = FramesToProcess.front().first;
           FramesToProcess.erase(FramesToProcess.begin()); // remove first element
         }
       }
@@ -290,18 +332,37 @@ void FCarlaEngine::OnPostTick(UWorld *World, ELevelTick TickType, float DeltaSec
     if (bIsPrimaryServer)
     {
       if (SecondaryServer->HasClientsConnected()) {
+        const bool bKeyframe = bNewConnection;
         GetCurrentEpisode()->GetFrameData().GetFrameData(GetCurrentEpisode(), true, bNewConnection);
         bNewConnection = false;
+        // a new secondary needs all the actors, not only the ones that changed
+        if (bKeyframe)
+        {
+          FrameDelta.Reset();
+        }
         std::ostringstream OutStream;
-        GetCurrentEpisode()->GetFrameData().Write(OutStream);
+        GetCurrentEpisode()->GetFrameData().Write(OutStream, FrameDelta);
 
         // send frame data to secondary
         std::string Tmp(OutStream.str());
-        SecondaryServer->GetCommander().SendFrameData(carla::Buffer(std::move((unsigned char *) Tmp.c_str()), (size_t) Tmp.size()));
+        SecondaryServer->GetCommander().SendFrame(
+            ++LastFrameSent,
+            bKeyframe,
+            carla::Buffer(std::move((unsigned char *) Tmp.c_str()), (size_t) Tmp.size()));
+        if (LastFrameSent % FCarlaEngine_MultiGPUStatsInterval == 0u)
+        {
+          FCarlaEngine_LogMultiGPUStats(*SecondaryServer);
+        }
 
         GetCurrentEpisode()->GetFrameData().Clear();
       }
     }
+    else if (FrameToAcknowledge != 0u)
+    {
+      // let the primary send the frame after the next one
+      Secondary->GetCommander().SendFrameAck(FrameToAcknowledge);
+      FrameToAcknowledge = 0u;
+    }
 
     auto* EpisodeRecorder = GetCurrentEpisode()->GetRecorder();
     if (EpisodeRecorder)
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "Carla/Game/FrameData.h"
 #include "Carla/Recorder/CarlaRecorder.h"
 #include "Carla/Sensor/WorldObserver.h"
 #include "Carla/Server/CarlaServer.h"
@@ -24,7 +25,6 @@
 #include <mutex>
 
 class UCarlaSettings;
-class FFrameData;
 struct FEpisodeSettings;
 
 class FCarlaEngine : private NonCopyable
@@ -122,6 +122,15 @@ private:
   std::shared_ptr<carla::multigpu::Router>    SecondaryServer;
   std::shared_ptr<carla::multigpu::Secondary> Secondary;
  
-  std::vector<FFrameData> FramesToProcess;
+  // frames received by a secondary server, with their number in the frame
+  // protocol (0 if they do not need to be acknowledged)
+  std::vector<std::pair<uint64_t, FFrameData>> FramesToProcess;
   std::mutex FrameToProcessMutex;
+
+  // actors already sent to (or received from) the secondary servers
+  FFrameDataDelta FrameDelta;
+  // last frame sent by the primary server
+  uint64_t LastFrameSent = 0u;
+  // frame played by the secondary server in this tick, to acknowledge
+  uint64_t FrameToAcknowledge = 0u;
 };
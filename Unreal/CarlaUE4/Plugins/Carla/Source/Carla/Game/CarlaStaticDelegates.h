@@ -7,6 +7,7 @@
 #pragma once
 
 #include "Carla/Settings/EpisodeSettings.h"
+#include "Carla/Weather/WeatherParameters.h"
 
 class CARLA_API FCarlaStaticDelegates
 {
@@ -14,4 +15,7 @@ public:
 
   DECLARE_MULTICAST_DELEGATE_OneParam(FOnEpisodeSettingsChange, const FEpisodeSettings &);
   static FOnEpisodeSettingsChange OnEpisodeSettingsChange;
+
+  DECLARE_MULTICAST_DELEGATE_OneParam(FOnWeatherChange, const FWeatherParameters &);
+  static FOnWeatherChange OnWeatherChange;
 };
@@ -192,7 +192,78 @@ void FFrameData::Write(std::ostream& OutStream)
   TrafficLightTimes.Write(OutStream);
   FrameCounter.Write(OutStream);
 }
+// records are compared field by field, so the result does not depend on
+// their layout or on the value of any padding bytes
+static bool IsSameRecord(const CarlaRecorderAnimVehicle& A, const CarlaRecorderAnimVehicle& B)
+{
+  return
+      A.Steering == B.Steering &&
+      A.Throttle == B.Throttle &&
+      A.Brake == B.Brake &&
+      A.bHandbrake == B.bHandbrake &&
+      A.Gear == B.Gear;
+}
+
+static bool IsSameRecord(const CarlaRecorderAnimWalker& A, const CarlaRecorderAnimWalker& B)
+{
+  return A.Speed == B.Speed;
+}
+
+static bool IsSameRecord(const CarlaRecorderLightVehicle& A, const CarlaRecorderLightVehicle& B)
+{
+  return A.State == B.State;
+}
+
+// write only the records that changed since they were last sent
+template <typename TCollection, typename TRecord>
+static void WriteChanged(
+    std::ostream& OutStream,
+    const std::vector<TRecord>& Records,
+    std::unordered_map<uint32_t, TRecord>& Sent)
+{
+  TCollection Changed;
+  for (const TRecord& Record : Records)
+  {
+    auto It = Sent.find(Record.DatabaseId);
+    if (It == Sent.end() || !IsSameRecord(It->second, Record))
+    {
+      Sent[Record.DatabaseId] = Record;
+      Changed.Add(Record);
+    }
+  }
+  Changed.Write(OutStream);
+}
+
+void FFrameData::Write(std::ostream& OutStream, FFrameDataDelta& Delta)
+{
+  // forget the actors destroyed, their ids can be reused
+  for (const CarlaRecorderEventDel &EventDel : EventsDel.GetEvents())
+  {
+    Delta.Vehicles.erase(EventDel.DatabaseId);
+    Delta.Walkers.erase(EventDel.DatabaseId);
+    Delta.LightVehicles.erase(EventDel.DatabaseId);
+  }
+
+  EventsAdd.Write(OutStream);
+  EventsDel.Write(OutStream);
+  EventsParent.Write(OutStream);
+  Positions.Write(OutStream, Delta.PositionCodec);
+  States.Write(OutStream);
+  WriteChanged<CarlaRecorderAnimVehicles>(OutStream, Vehicles.GetVehicles(), Delta.Vehicles);
+  WriteChanged<CarlaRecorderAnimWalkers>(OutStream, Walkers.GetWalkers(), Delta.Walkers);
+  WriteChanged<CarlaRecorderLightVehicles>(OutStream, LightVehicles.GetLightVehicles(), Delta.LightVehicles);
+  LightScenes.Write(OutStream);
+  TrafficLightTimes.Write(OutStream);
+  FrameCounter.Write(OutStream);
+}
+
 void FFrameData::Read(std::istream& InStream)
+{
+  FFrameDataDelta Delta;
+  Read(InStream, Delta);
+}
+
+void FFrameData::Read(std::istream& InStream, FFrameDataDelta& Delta)
 {
   Clear();
   while(!InStream.eof())
@@ -220,6 +291,15 @@ void FFrameData::Read(std::istream& InStream)
       // positions
       case static_cast<char>(CarlaRecorderPacketId::Position):
         Positions.Read(InStream);
+        Delta.PositionCodec.SetKeyframe(Positions.GetPositions());
+        break;
+
+      // changes of positions
+      case static_cast<char>(CarlaRecorderPacketId::PositionDelta):
+        if (!Positions.ReadDelta(InStream, Delta.PositionCodec))
+        {
+          UE_LOG(LogCarla, Warning, TEXT("Frame data: positions changed without the previous ones, waiting for the next keyframe"));
+        }
         break;
 
       // states
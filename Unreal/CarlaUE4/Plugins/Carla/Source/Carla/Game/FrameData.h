@@ -25,10 +25,32 @@
 #include "Carla/Recorder/CarlaRecorderFrameCounter.h"
 
 #include <sstream>
+#include <unordered_map>
 
 class UCarlaEpisode;
 class FCarlaActor;
 
+// What the secondary servers already have from the previous frames, so each
+// frame only carries the actors that changed. The primary and the secondaries
+// keep their own copy; resetting it on the primary sends a keyframe.
+struct FFrameDataDelta
+{
+  CarlaRecorderPositionCodec PositionCodec;
+
+  // last record sent of each actor (only used by the primary)
+  std::unordered_map<uint32_t, CarlaRecorderAnimVehicle> Vehicles;
+  std::unordered_map<uint32_t, CarlaRecorderAnimWalker> Walkers;
+  std::unordered_map<uint32_t, CarlaRecorderLightVehicle> LightVehicles;
+
+  void Reset()
+  {
+    PositionCodec.Reset();
+    Vehicles.clear();
+    Walkers.clear();
+    LightVehicles.clear();
+  }
+};
+
 class FFrameData
 {
   // structures
@@ -73,6 +95,11 @@ public:
   void Write(std::ostream& OutStream);
   void Read(std::istream& InStream);
 
+  // write only the actors that changed since the previous frame, and read
+  // them back rebuilding the rest from the previous frames
+  void Write(std::ostream& OutStream, FFrameDataDelta& Delta);
+  void Read(std::istream& InStream, FFrameDataDelta& Delta);
+
   // record functions
   void CreateRecorderEventAdd(
       uint32_t DatabaseId,
@@ -358,23 +358,36 @@ std::string ACarlaRecorder::Start(std::string Name, FString MapName, bool Additi
   // get the final path + filename
   std::string Filename = GetRecorderFilename(Name);
 
+  // compression of the file blocks (none, lz4 or zlib)
+  auto Compression = CarlaRecorderWriter::ECompression::None;
+  FString CompressionName;
+  if (FParse::Value(FCommandLine::Get(), TEXT("-recorder-compression="), CompressionName))
+  {
+    if (!CarlaRecorderWriter::ParseCompression(TCHAR_TO_UTF8(*CompressionName.ToLower()), Compression))
+    {
+      UE_LOG(LogCarla, Warning, TEXT("Unknown recorder compression '%s', recording uncompressed"), *CompressionName);
+    }
+  }
+
   // binary file
-  File.open(Filename, std::ios::binary);
-  if (!File.is_open())
+  if (!Writer.Open(Filename, Compression))
   {
     return "";
   }
 
   // save info
-  Info.Version = 1;
+  Info.Version = 2;
   Info.Magic = TEXT("CARLA_RECORDER");
   Info.Date = std::time(0);
   Info.Mapfile = MapName;
 
   // write general info
-  Info.Write(File);
+  Info.Write(Writer.GetStream());
 
   Frames.Reset();
+  FrameIndex.Clear();
+  PositionCodec.Reset();
+  KinematicsCodec.Reset();
   PlatformTime.SetStartTime();
 
   Enable();
@@ -391,9 +404,15 @@ void ACarlaRecorder::Stop(void)
 {
   Disable();
 
-  if (File)
+  if (Writer.IsOpen())
   {
-    File.close();
+    // index of frames at the end, to let the replayer and queries seek
+    if (!FrameIndex.IsEmpty())
+    {
+      FrameIndex.Write(Writer.GetStream());
+      FrameIndex.Clear();
+    }
+    Writer.Close();
   }
 
   Clear();
@@ -421,9 +440,27 @@ void ACarlaRecorder::Clear(void)
 
 void ACarlaRecorder::Write(double DeltaSeconds)
 {
+  // packets are serialized in memory, the writer saves them to disk
+  std::ostream &File = Writer.GetStream();
+
   // update this frame data
   Frames.SetFrame(DeltaSeconds);
 
+  // entry of this frame in the index
+  CarlaRecorderFrameIndexEntry Entry;
+  Entry.Id = Frames.GetFrame().Id;
+  Entry.Elapsed = Frames.GetFrame().Elapsed;
+  Entry.Offset = File.tellp();
+  Entry.Actors = Positions.GetPositions().size();
+  Entry.Collisions = Collisions.GetCollisions().size();
+  Entry.Flags = 0;
+  if (!EventsAdd.GetEvents().empty() ||
+      !EventsDel.GetEvents().empty() ||
+      !EventsParent.GetEvents().empty())
+    Entry.Flags |= CarlaRecorderFrameIndexEntry::HasEvents;
+  if (Entry.Collisions > 0)
+    Entry.Flags |= CarlaRecorderFrameIndexEntry::HasCollisions;
+
   // start
   Frames.WriteStart(File);
   VisualTime.Write(File);
@@ -434,8 +471,10 @@ void ACarlaRecorder::Write(double DeltaSeconds)
   EventsParent.Write(File);
   Collisions.Write(File);
 
-  // positions and states
-  Positions.Write(File);
+  // positions and states (only the changes if the actors are the same as in
+  // the previous frame)
+  if (Positions.Write(File, PositionCodec))
+    Entry.Flags |= CarlaRecorderFrameIndexEntry::HasKeyframe;
   States.Write(File);
 
   // animations
@@ -447,7 +486,7 @@ void ACarlaRecorder::Write(double DeltaSeconds)
   // additional info
   if (bAdditionalData)
   {
-    Kinematics.Write(File);
+    Kinematics.Write(File, KinematicsCodec);
     BoundingBoxes.Write(File);
     TriggerVolumes.Write(File);
     PlatformTime.Write(File);
@@ -458,6 +497,11 @@ void ACarlaRecorder::Write(double DeltaSeconds)
 
   // end
   Frames.WriteEnd(File);
+  FrameIndex.Add(Entry);
+
+  // the duration of this frame is written with the next one, so only the
+  // previous frames can be flushed
+  Writer.Commit(Entry.Offset);
 
   Clear();
 }
@@ -24,6 +24,7 @@
 #include "CarlaRecorderEventAdd.h"
 #include "CarlaRecorderEventDel.h"
 #include "CarlaRecorderEventParent.h"
+#include "CarlaRecorderFrameIndex.h"
 #include "CarlaRecorderFrames.h"
 #include "CarlaRecorderInfo.h"
 #include "CarlaRecorderPosition.h"
@@ -31,6 +32,7 @@
 #include "CarlaRecorderState.h"
 #include "CarlaRecorderVisualTime.h"
 #include "CarlaRecorderWalkerBones.h"
+#include "CarlaRecorderWriter.h"
 #include "CarlaReplayer.h"
 
 #include "CarlaRecorder.generated.h"
@@ -64,7 +66,10 @@ enum class CarlaRecorderPacketId : uint8_t
   TriggerVolume,
   FrameCounter,
   WalkerBones,
-  VisualTime
+  VisualTime,
+  FrameIndex,
+  PositionDelta,
+  KinematicsDelta
 };
 
 /// Recorder for the simulation
@@ -171,14 +176,15 @@ private:
 
   uint32_t NextCollisionId = 0;
 
-  // files
-  std::ofstream File;
+  // file, written from a background thread
+  CarlaRecorderWriter Writer;
 
   UCarlaEpisode *Episode = nullptr;
 
   // structures
   CarlaRecorderInfo Info;
   CarlaRecorderFrames Frames;
+  CarlaRecorderFrameIndex FrameIndex;
   CarlaRecorderEventsAdd EventsAdd;
   CarlaRecorderEventsDel EventsDel;
   CarlaRecorderEventsParent EventsParent;
@@ -197,6 +203,8 @@ private:
   CarlaRecorderTrafficLightTimes TrafficLightTimes;
   CarlaRecorderWalkersBones WalkersBones;
   CarlaRecorderVisualTime VisualTime;
+  CarlaRecorderPositionCodec PositionCodec;
+  CarlaRecorderKinematicsCodec KinematicsCodec;
 
   // replayer
   CarlaReplayer Replayer;
@@ -66,3 +66,8 @@ void CarlaRecorderCollisions::Write(std::ostream &OutFile)
         Coll.Write(OutFile);
     }
 }
+
+const std::unordered_set<CarlaRecorderCollision>& CarlaRecorderCollisions::GetCollisions()
+{
+    return Collisions;
+}
@@ -48,6 +48,7 @@ class CarlaRecorderCollisions{
     void Add(const CarlaRecorderCollision &Collision);
     void Clear(void);
     void Write(std::ostream &OutFile);
+    const std::unordered_set<CarlaRecorderCollision>& GetCollisions();
 
     private:
     std::unordered_set<CarlaRecorderCollision> Collisions;
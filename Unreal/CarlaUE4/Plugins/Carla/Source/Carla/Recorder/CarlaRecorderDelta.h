@@ -0,0 +1,215 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+// Delta encoding of the records of an actor id and two vectors (positions and
+// kinematics). A keyframe stores the records in full, with the usual packet,
+// and the next frames with the same actors (in the same order) only store the
+// quantized difference with the previous frame, skipping with a bitmap the
+// actors that did not change. A keyframe is forced every 'KeyframeInterval'
+// packets, so seeking never needs to decode more than that.
+//
+// A delta packet contains:
+//   uint16 total records
+//   bitmap of (total + 7) / 8 bytes, a bit set for each record changed
+//   for each record changed, the six deltas as zigzag varints
+template <typename T, FVector T::*First, FVector T::*Second>
+class CarlaRecorderDeltaCodec
+{
+
+public:
+
+  static constexpr uint32_t KeyframeInterval = 100;
+
+  // 'FirstFactor' and 'SecondFactor' are the steps per unit of each vector
+  CarlaRecorderDeltaCodec(float FirstFactor, float SecondFactor)
+    : Factors { FirstFactor, FirstFactor, FirstFactor, SecondFactor, SecondFactor, SecondFactor }
+  {
+  }
+
+  void Reset(void)
+  {
+    State.clear();
+    PacketsSinceKeyframe = 0;
+  }
+
+  // recorder: encode the records as a delta packet in 'Data', or return false
+  // if they need to be written in full as a keyframe
+  bool Encode(const std::vector<T> &Records, std::vector<char> &Data)
+  {
+    Data.clear();
+    // the count of a delta packet is 16 bits, bigger frames are keyframes
+    if (++PacketsSinceKeyframe >= KeyframeInterval ||
+        Records.size() > std::numeric_limits<uint16_t>::max() ||
+        !HasSameActors(Records))
+    {
+      SetKeyframe(Records);
+      return false;
+    }
+
+    uint16_t Total = static_cast<uint16_t>(Records.size());
+    Append(Data, &Total, sizeof(Total));
+    size_t Bitmap = Data.size();
+    Data.resize(Bitmap + (Total + 7) / 8, 0);
+
+    int32_t Values[6];
+    int64_t Deltas[6];
+    for (size_t i = 0; i < Records.size(); ++i)
+    {
+      Quantize(Records[i], Values);
+      bool bChanged = false;
+      for (int j = 0; j < 6; ++j)
+      {
+        Deltas[j] = static_cast<int64_t>(Values[j]) - State[i].Values[j];
+        bChanged |= (Deltas[j] != 0);
+      }
+      if (bChanged)
+      {
+        Data[Bitmap + i / 8] |= (1 << (i % 8));
+        for (int j = 0; j < 6; ++j)
+        {
+          WriteVarint(Data, Deltas[j]);
+          State[i].Values[j] = Values[j];
+        }
+      }
+    }
+    return true;
+  }
+
+  // replayer: the records of a keyframe just read
+  void SetKeyframe(const std::vector<T> &Records)
+  {
+    State.resize(Records.size());
+    for (size_t i = 0; i < Records.size(); ++i)
+    {
+      State[i].DatabaseId = Records[i].DatabaseId;
+      Quantize(Records[i], State[i].Values);
+    }
+    PacketsSinceKeyframe = 0;
+  }
+
+  // replayer: read a delta packet and rebuild its records, returns false if
+  // the packet does not follow the previous one decoded
+  bool Decode(std::istream &InFile, std::vector<T> &Records)
+  {
+    uint16_t Total;
+    InFile.read(reinterpret_cast<char *>(&Total), sizeof(Total));
+    Records.clear();
+    if (!InFile || Total != State.size())
+    {
+      State.clear();
+      return false;
+    }
+
+    std::vector<uint8_t> Bitmap((Total + 7) / 8);
+    InFile.read(reinterpret_cast<char *>(Bitmap.data()), Bitmap.size());
+    Records.resize(Total);
+    for (size_t i = 0; i < Total; ++i)
+    {
+      if (Bitmap[i / 8] & (1 << (i % 8)))
+      {
+        for (int j = 0; j < 6; ++j)
+        {
+          State[i].Values[j] += static_cast<int32_t>(ReadVarint(InFile));
+        }
+      }
+      Records[i].DatabaseId = State[i].DatabaseId;
+      Dequantize(State[i].Values, Records[i]);
+    }
+    return static_cast<bool>(InFile);
+  }
+
+private:
+
+  struct FActorState
+  {
+    uint32_t DatabaseId;
+    int32_t Values[6];
+  };
+
+  bool HasSameActors(const std::vector<T> &Records) const
+  {
+    if (Records.size() != State.size())
+      return false;
+    for (size_t i = 0; i < Records.size(); ++i)
+    {
+      if (Records[i].DatabaseId != State[i].DatabaseId)
+        return false;
+    }
+    return true;
+  }
+
+  void Quantize(const T &Record, int32_t (&Values)[6]) const
+  {
+    const FVector &A = Record.*First;
+    const FVector &B = Record.*Second;
+    const float Components[6] = { A.X, A.Y, A.Z, B.X, B.Y, B.Z };
+    for (int j = 0; j < 6; ++j)
+    {
+      // clamp to keep the difference between two values in an int64
+      double Value = std::round(static_cast<double>(Components[j]) * Factors[j]);
+      Values[j] = static_cast<int32_t>(std::max(-2e9, std::min(2e9, std::isnan(Value) ? 0.0 : Value)));
+    }
+  }
+
+  void Dequantize(const int32_t (&Values)[6], T &Record) const
+  {
+    FVector &A = Record.*First;
+    FVector &B = Record.*Second;
+    A.X = Values[0] / Factors[0];
+    A.Y = Values[1] / Factors[1];
+    A.Z = Values[2] / Factors[2];
+    B.X = Values[3] / Factors[3];
+    B.Y = Values[4] / Factors[4];
+    B.Z = Values[5] / Factors[5];
+  }
+
+  static void Append(std::vector<char> &Data, const void *Value, size_t Size)
+  {
+    const char *Bytes = reinterpret_cast<const char *>(Value);
+    Data.insert(Data.end(), Bytes, Bytes + Size);
+  }
+
+  static void WriteVarint(std::vector<char> &Data, int64_t Value)
+  {
+    // zigzag, to keep small negative values short
+    uint64_t Unsigned = (static_cast<uint64_t>(Value) << 1) ^ static_cast<uint64_t>(Value >> 63);
+    while (Unsigned >= 0x80)
+    {
+      Data.push_back(static_cast<char>((Unsigned & 0x7F) | 0x80));
+      Unsigned >>= 7;
+    }
+    Data.push_back(static_cast<char>(Unsigned));
+  }
+
+  static int64_t ReadVarint(std::istream &InFile)
+  {
+    uint64_t Unsigned = 0;
+    for (int Shift = 0; Shift < 64; Shift += 7)
+    {
+      int Byte = InFile.get();
+      if (Byte == std::char_traits<char>::eof())
+        break;
+      Unsigned |= static_cast<uint64_t>(Byte & 0x7F) << Shift;
+      if ((Byte & 0x80) == 0)
+        break;
+    }
+    return static_cast<int64_t>(Unsigned >> 1) ^ -static_cast<int64_t>(Unsigned & 1);
+  }
+
+  const float Factors[6];
+
+  std::vector<FActorState> State;
+
+  uint32_t PacketsSinceKeyframe = 0;
+};
@@ -0,0 +1,133 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "CarlaRecorder.h"
+#include "CarlaRecorderFrameIndex.h"
+#include "CarlaRecorderHelpers.h"
+
+#include <algorithm>
+
+constexpr uint32_t CarlaRecorderFrameIndex::Magic;
+
+void CarlaRecorderFrameIndex::Clear(void)
+{
+  Entries.clear();
+  Offset = 0;
+}
+
+void CarlaRecorderFrameIndex::Add(const CarlaRecorderFrameIndexEntry &Entry)
+{
+  Entries.push_back(Entry);
+}
+
+void CarlaRecorderFrameIndex::Write(std::ostream &OutFile)
+{
+  Offset = OutFile.tellp();
+
+  // write the packet id
+  WriteValue<char>(OutFile, static_cast<char>(CarlaRecorderPacketId::FrameIndex));
+
+  // write the packet size (total, entries, offset and magic)
+  uint32_t Total = 4 + Entries.size() * sizeof(CarlaRecorderFrameIndexEntry) + 8 + 4;
+  WriteValue<uint32_t>(OutFile, Total);
+
+  // write total records
+  Total = Entries.size();
+  WriteValue<uint32_t>(OutFile, Total);
+  OutFile.write(reinterpret_cast<const char *>(Entries.data()),
+      Entries.size() * sizeof(CarlaRecorderFrameIndexEntry));
+
+  // write where the packet starts, to find it from the end of the file
+  WriteValue<uint64_t>(OutFile, Offset);
+  WriteValue<uint32_t>(OutFile, Magic);
+}
+
+bool CarlaRecorderFrameIndex::Read(std::istream &InFile)
+{
+  // header (id and size) plus total records, and the trailing offset and magic
+  const uint64_t HeaderSize = 1 + 4 + 4;
+  const uint64_t TrailerSize = 8 + 4;
+
+  std::streampos Current = InFile.tellg();
+  Clear();
+
+  InFile.clear();
+  InFile.seekg(0, std::ios::end);
+  uint64_t End = InFile.tellg();
+  if (End >= HeaderSize + TrailerSize)
+  {
+    uint64_t IndexOffset;
+    uint32_t FileMagic;
+    InFile.seekg(End - TrailerSize, std::ios::beg);
+    ReadValue<uint64_t>(InFile, IndexOffset);
+    ReadValue<uint32_t>(InFile, FileMagic);
+
+    if (InFile && FileMagic == Magic && IndexOffset + HeaderSize + TrailerSize <= End)
+    {
+      char Id;
+      uint32_t Size, Total;
+      InFile.seekg(IndexOffset, std::ios::beg);
+      ReadValue<char>(InFile, Id);
+      ReadValue<uint32_t>(InFile, Size);
+      ReadValue<uint32_t>(InFile, Total);
+
+      // the packet must fill the rest of the file exactly
+      if (InFile &&
+          Id == static_cast<char>(CarlaRecorderPacketId::FrameIndex) &&
+          Size == End - IndexOffset - 5 &&
+          Size == 4 + Total * sizeof(CarlaRecorderFrameIndexEntry) + TrailerSize)
+      {
+        Entries.resize(Total);
+        InFile.read(reinterpret_cast<char *>(Entries.data()),
+            Total * sizeof(CarlaRecorderFrameIndexEntry));
+        if (InFile)
+          Offset = IndexOffset;
+        else
+          Entries.clear();
+      }
+    }
+  }
+
+  InFile.clear();
+  InFile.seekg(Current, std::ios::beg);
+
+  return !IsEmpty();
+}
+
+double CarlaRecorderFrameIndex::GetTotalTime(void) const
+{
+  return (Entries.empty() ? 0.0 : Entries.back().Elapsed);
+}
+
+size_t CarlaRecorderFrameIndex::FindFrame(double Time) const
+{
+  auto It = std::upper_bound(Entries.begin(), Entries.end(), Time,
+      [](double Value, const CarlaRecorderFrameIndexEntry &Entry)
+      {
+        return Value < Entry.Elapsed;
+      });
+  return (It == Entries.begin() ? 0 : std::distance(Entries.begin(), It) - 1);
+}
+
+size_t CarlaRecorderFrameIndex::FindOffset(uint64_t FileOffset) const
+{
+  auto It = std::lower_bound(Entries.begin(), Entries.end(), FileOffset,
+      [](const CarlaRecorderFrameIndexEntry &Entry, uint64_t Value)
+      {
+        return Entry.Offset < Value;
+      });
+  return std::distance(Entries.begin(), It);
+}
+
+size_t CarlaRecorderFrameIndex::FindNext(size_t Start, uint8_t Mask) const
+{
+  size_t i = Start;
+  while (i < Entries.size() && (Entries[i].Flags & Mask) == 0)
+  {
+    ++i;
+  }
+  return i;
+}
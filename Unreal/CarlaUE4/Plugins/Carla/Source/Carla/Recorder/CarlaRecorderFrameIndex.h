@@ -0,0 +1,89 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <sstream>
+#include <vector>
+
+#pragma pack(push, 1)
+struct CarlaRecorderFrameIndexEntry
+{
+  // packets found in the frame
+  enum Flags : uint8_t
+  {
+    HasEvents     = 1 << 0,  // creation, destruction or parenting of actors
+    HasCollisions = 1 << 1,
+    HasKeyframe   = 1 << 2   // positions written in full, not as a delta
+  };
+
+  uint64_t Id;
+  double Elapsed;
+  // position of the frame start packet in the file
+  uint64_t Offset;
+  // number of actor positions recorded in the frame
+  uint16_t Actors;
+  uint16_t Collisions;
+  uint8_t Flags;
+};
+#pragma pack(pop)
+
+// Index of all the frames in a recording, written as the last packet of the
+// file when the recorder stops. The packet ends with its own offset and a
+// magic number, so it can be found by reading the end of the file, while
+// older versions just skip it as an unknown packet. Recordings without index
+// (old ones, or not stopped properly) are still parsed sequentially.
+class CarlaRecorderFrameIndex
+{
+
+public:
+
+  void Clear(void);
+
+  void Add(const CarlaRecorderFrameIndexEntry &Entry);
+
+  void Write(std::ostream &OutFile);
+
+  // load the index from the end of the file, keeping the current position;
+  // returns false (and leaves the index empty) if the file has no index
+  bool Read(std::istream &InFile);
+
+  bool IsEmpty(void) const
+  {
+    return Entries.empty();
+  }
+
+  const std::vector<CarlaRecorderFrameIndexEntry> &GetEntries(void) const
+  {
+    return Entries;
+  }
+
+  // position of the index packet, where the frames end
+  uint64_t GetOffset(void) const
+  {
+    return Offset;
+  }
+
+  double GetTotalTime(void) const;
+
+  // position of the frame being played at 'Time' (the last one starting
+  // before or at that time)
+  size_t FindFrame(double Time) const;
+
+  // position of the first frame starting at or after the file offset
+  size_t FindOffset(uint64_t FileOffset) const;
+
+  // position of the first frame from 'Start' with any of the flags in 'Mask',
+  // or the number of entries if there is none
+  size_t FindNext(size_t Start, uint8_t Mask) const;
+
+private:
+
+  static constexpr uint32_t Magic = 0x58444946; // "FIDX"
+
+  std::vector<CarlaRecorderFrameIndexEntry> Entries;
+  uint64_t Offset = 0;
+};
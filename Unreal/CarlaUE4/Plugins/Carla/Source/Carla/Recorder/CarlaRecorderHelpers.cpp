@@ -7,7 +7,9 @@
 #include <vector>
 
 #include "UnrealString.h"
+#include "HAL/FileManager.h"
 #include "CarlaRecorderHelpers.h"
+#include "CarlaRecorderWriter.h"
 
 // create a temporal buffer to convert from and to FString and bytes
 static std::vector<uint8_t> CarlaRecorderHelperBuffer;
@@ -29,6 +31,26 @@ std::string GetRecorderFilename(std::string Filename)
   return Filename2;
 }
 
+// get the file to read a recording from, decompressing it first if needed
+std::string GetReadableRecorderFilename(std::string Filename)
+{
+  if (!CarlaRecorderWriter::IsCompressed(Filename))
+    return Filename;
+
+  // reuse the previous decompression while the recording does not change
+  std::string Uncompressed = Filename + ".uncompressed";
+  IFileManager &FileManager = IFileManager::Get();
+  FDateTime Time = FileManager.GetTimeStamp(UTF8_TO_TCHAR(Filename.c_str()));
+  FDateTime UncompressedTime = FileManager.GetTimeStamp(UTF8_TO_TCHAR(Uncompressed.c_str()));
+  if (UncompressedTime != FDateTime::MinValue() && UncompressedTime >= Time)
+    return Uncompressed;
+
+  if (!CarlaRecorderWriter::Decompress(Filename, Uncompressed))
+    return Filename;
+
+  return Uncompressed;
+}
+
 // ------
 // write
 // ------
@@ -42,7 +64,7 @@ void WriteFVector(std::ostream &OutFile, const FVector &InObj)
 }
 
 // write binary data from FTransform
-void WriteFTransform(std::ofstream &OutFile, const FTransform &InObj)
+void WriteFTransform(std::ostream &OutFile, const FTransform &InObj)
 {
   WriteFVector(OutFile, InObj.GetTranslation());
   WriteFVector(OutFile, InObj.GetRotation().Euler());
@@ -12,6 +12,9 @@
 // get the final path + filename
 std::string GetRecorderFilename(std::string Filename);
 
+// get the file to read a recording from, decompressing it first if needed
+std::string GetReadableRecorderFilename(std::string Filename);
+
 // ---------
 // recorder
 // ---------
@@ -47,7 +50,7 @@ void WriteTArray(std::ostream &OutFile, const TArray<T> &InVec)
 void WriteFVector(std::ostream &OutFile, const FVector &InObj);
 
 // write binary data from FTransform
-void WriteFTransform(std::ofstream &OutFile, const FTransform &InObj);
+void WriteFTransform(std::ostream &OutFile, const FTransform &InObj);
 // write binary data from FString (length + text)
 void WriteFString(std::ostream &OutFile, const FString &InObj);
 
@@ -57,3 +57,26 @@ void CarlaRecorderActorsKinematics::Write(std::ostream &OutFile)
     Kinematic.Write(OutFile);
   }
 }
+
+void CarlaRecorderActorsKinematics::Write(std::ostream &OutFile, CarlaRecorderKinematicsCodec &Codec)
+{
+  if (Kinematics.size() == 0)
+  {
+    return;
+  }
+  if (!Codec.Encode(Kinematics, Delta))
+  {
+    Write(OutFile);
+    return;
+  }
+
+  // write the packet id
+  WriteValue<char>(OutFile, static_cast<char>(CarlaRecorderPacketId::KinematicsDelta));
+
+  // write the packet size
+  uint32_t Total = Delta.size();
+  WriteValue<uint32_t>(OutFile, Total);
+
+  // write the changes
+  OutFile.write(Delta.data(), Delta.size());
+}
@@ -9,6 +9,8 @@
 #include <sstream>
 #include <vector>
 
+#include "CarlaRecorderDelta.h"
+
 #pragma pack(push, 1)
 struct CarlaRecorderKinematics
 {
@@ -22,6 +24,15 @@ struct CarlaRecorderKinematics
 };
 #pragma pack(pop)
 
+// delta encoding of velocities, with a resolution of 0.01 cm/s and 0.01 deg/s
+class CarlaRecorderKinematicsCodec
+  : public CarlaRecorderDeltaCodec<CarlaRecorderKinematics, &CarlaRecorderKinematics::LinearVelocity, &CarlaRecorderKinematics::AngularVelocity>
+{
+public:
+
+  CarlaRecorderKinematicsCodec(void) : CarlaRecorderDeltaCodec(100.0f, 100.0f) {}
+};
+
 class CarlaRecorderActorsKinematics
 {
   public:
@@ -32,7 +43,11 @@ class CarlaRecorderActorsKinematics
 
   void Write(std::ostream &OutFile);
 
+  // write only the changes from the previous packet if possible
+  void Write(std::ostream &OutFile, CarlaRecorderKinematicsCodec &Codec);
+
 private:
 
   std::vector<CarlaRecorderKinematics> Kinematics;
+  std::vector<char> Delta;
 };
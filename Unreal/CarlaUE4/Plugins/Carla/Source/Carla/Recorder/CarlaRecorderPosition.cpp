@@ -58,6 +58,27 @@ void CarlaRecorderPositions::Write(std::ostream &OutFile)
   }
 }
 
+bool CarlaRecorderPositions::Write(std::ostream &OutFile, CarlaRecorderPositionCodec &Codec)
+{
+  if (!Codec.Encode(Positions, Delta))
+  {
+    Write(OutFile);
+    return true;
+  }
+
+  // write the packet id
+  WriteValue<char>(OutFile, static_cast<char>(CarlaRecorderPacketId::PositionDelta));
+
+  // write the packet size
+  uint32_t Total = Delta.size();
+  WriteValue<uint32_t>(OutFile, Total);
+
+  // write the changes
+  OutFile.write(Delta.data(), Delta.size());
+
+  return false;
+}
+
 void CarlaRecorderPositions::Read(std::istream &InFile)
 {
   uint16_t i, Total;
@@ -72,6 +93,11 @@ void CarlaRecorderPositions::Read(std::istream &InFile)
   }
 }
 
+bool CarlaRecorderPositions::ReadDelta(std::istream &InFile, CarlaRecorderPositionCodec &Codec)
+{
+  return Codec.Decode(InFile, Positions);
+}
+
 const std::vector<CarlaRecorderPosition>& CarlaRecorderPositions::GetPositions()
 {
   return Positions;
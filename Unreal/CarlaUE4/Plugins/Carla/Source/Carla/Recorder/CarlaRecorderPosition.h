@@ -9,6 +9,8 @@
 #include <sstream>
 #include <vector>
 
+#include "CarlaRecorderDelta.h"
+
 #pragma pack(push, 1)
 struct CarlaRecorderPosition
 {
@@ -23,6 +25,15 @@ struct CarlaRecorderPosition
 };
 #pragma pack(pop)
 
+// delta encoding of positions, with a resolution of 0.1 mm and 0.001 degrees
+class CarlaRecorderPositionCodec
+  : public CarlaRecorderDeltaCodec<CarlaRecorderPosition, &CarlaRecorderPosition::Location, &CarlaRecorderPosition::Rotation>
+{
+public:
+
+  CarlaRecorderPositionCodec(void) : CarlaRecorderDeltaCodec(100.0f, 1000.0f) {}
+};
+
 class CarlaRecorderPositions
 {
 public:
@@ -33,11 +44,20 @@ public:
 
   void Write(std::ostream &OutFile);
 
+  // write only the changes from the previous packet if possible, returns true
+  // if the positions were written in full (keyframe)
+  bool Write(std::ostream &OutFile, CarlaRecorderPositionCodec &Codec);
+
   void Read(std::istream &InFile);
 
+  // read a packet with the changes from the previous positions, returns false
+  // if it does not follow the previous packet decoded
+  bool ReadDelta(std::istream &InFile, CarlaRecorderPositionCodec &Codec);
+
   const std::vector<CarlaRecorderPosition>& GetPositions();
 
 private:
 
   std::vector<CarlaRecorderPosition> Positions;
+  std::vector<char> Delta;
 };
@@ -53,9 +53,75 @@ inline bool CarlaRecorderQuery::CheckFileInfo(std::stringstream &Info)
   strftime(DateStr, sizeof(DateStr), "%x %X", TimeInfo);
   Info << "Date: " << DateStr << std::endl << std::endl;
 
+  // load the index of frames, if any
+  FrameIndex.Read(File);
+
+  PositionCodec.Reset();
+  KinematicsCodec.Reset();
+
   return true;
 }
 
+void CarlaRecorderQuery::ReadPositions(void)
+{
+  if (Header.Id == static_cast<char>(CarlaRecorderPacketId::PositionDelta))
+  {
+    PositionCodec.Decode(File, Positions);
+    return;
+  }
+
+  uint16_t i, Total;
+  ReadValue<uint16_t>(File, Total);
+  Positions.resize(Total);
+  for (i = 0; i < Total; ++i)
+  {
+    Positions[i].Read(File);
+  }
+  PositionCodec.SetKeyframe(Positions);
+}
+
+void CarlaRecorderQuery::ReadKinematics(void)
+{
+  if (Header.Id == static_cast<char>(CarlaRecorderPacketId::KinematicsDelta))
+  {
+    KinematicsCodec.Decode(File, ActorsKinematics);
+    return;
+  }
+
+  uint16_t i, Total;
+  ReadValue<uint16_t>(File, Total);
+  ActorsKinematics.resize(Total);
+  for (i = 0; i < Total; ++i)
+  {
+    ActorsKinematics[i].Read(File);
+  }
+  KinematicsCodec.SetKeyframe(ActorsKinematics);
+}
+
+inline void CarlaRecorderQuery::SkipToNextFrame(uint8_t Mask)
+{
+  if (FrameIndex.IsEmpty())
+  {
+    return;
+  }
+
+  const auto &Entries = FrameIndex.GetEntries();
+  size_t Next = FrameIndex.FindNext(FrameIndex.FindOffset(File.tellg()), Mask);
+  if (Next < Entries.size())
+    File.seekg(Entries[Next].Offset, std::ios::beg);
+  else
+    File.seekg(FrameIndex.GetOffset(), std::ios::beg);
+}
+
+inline void CarlaRecorderQuery::SetLastFrame(void)
+{
+  if (!FrameIndex.IsEmpty())
+  {
+    Frame.Id = FrameIndex.GetEntries().back().Id;
+    Frame.Elapsed = FrameIndex.GetTotalTime();
+  }
+}
+
 std::string CarlaRecorderQuery::QueryInfo(std::string Filename, bool bShowAll)
 {
   std::stringstream Info;
@@ -64,7 +130,7 @@ std::string CarlaRecorderQuery::QueryInfo(std::string Filename, bool bShowAll)
   std::string Filename2 = GetRecorderFilename(Filename);
 
   // try to open
-  File.open(Filename2, std::ios::binary);
+  File.open(GetReadableRecorderFilename(Filename2), std::ios::binary);
   if (!File.is_open())
   {
     Info << "File " << Filename2 << " not found on server\n";
@@ -83,6 +149,11 @@ std::string CarlaRecorderQuery::QueryInfo(std::string Filename, bool bShowAll)
   if (!CheckFileInfo(Info))
     return Info.str();
 
+  // without showing all, only frames with events or collisions print anything
+  const uint8_t Mask = CarlaRecorderFrameIndexEntry::HasEvents | CarlaRecorderFrameIndexEntry::HasCollisions;
+  if (!bShowAll)
+    SkipToNextFrame(Mask);
+
   // parse only frames
   while (File)
   {
@@ -184,18 +255,18 @@ std::string CarlaRecorderQuery::QueryInfo(std::string Filename, bool bShowAll)
 
       // positions
       case static_cast<char>(CarlaRecorderPacketId::Position):
+      case static_cast<char>(CarlaRecorderPacketId::PositionDelta):
         if (bShowAll)
         {
-          ReadValue<uint16_t>(File, Total);
-          if (Total > 0 && !bFramePrinted)
+          ReadPositions();
+          if (Positions.size() > 0 && !bFramePrinted)
           {
             PrintFrame(Info);
             bFramePrinted = true;
           }
-          Info << " Positions: " << Total << std::endl;
-          for (i = 0; i < Total; ++i)
+          Info << " Positions: " << Positions.size() << std::endl;
+          for (const auto &Position : Positions)
           {
-            Position.Read(File);
             Info << "  Id: " << Position.DatabaseId << " Location: (" << Position.Location.X << ", " << Position.Location.Y << ", " << Position.Location.Z << ") Rotation (" <<  Position.Rotation.X << ", " << Position.Rotation.Y << ", " << Position.Rotation.Z << ")" << std::endl;
           }
         }
@@ -349,18 +420,18 @@ std::string CarlaRecorderQuery::QueryInfo(std::string Filename, bool bShowAll)
 
       // dynamic actor kinematics
       case static_cast<char>(CarlaRecorderPacketId::Kinematics):
+      case static_cast<char>(CarlaRecorderPacketId::KinematicsDelta):
         if (bShowAll)
         {
-          ReadValue<uint16_t>(File, Total);
-          if (Total > 0 && !bFramePrinted)
+          ReadKinematics();
+          if (ActorsKinematics.size() > 0 && !bFramePrinted)
           {
             PrintFrame(Info);
             bFramePrinted = true;
           }
-          Info << " Dynamic actors: " << Total << std::endl;
-          for (i = 0; i < Total; ++i)
+          Info << " Dynamic actors: " << ActorsKinematics.size() << std::endl;
+          for (const auto &Kinematics : ActorsKinematics)
           {
-            Kinematics.Read(File);
             Info << "  Id: " << Kinematics.DatabaseId << " linear_velocity: ("
                 << Kinematics.LinearVelocity.X << ", " << Kinematics.LinearVelocity.Y << ", " << Kinematics.LinearVelocity.Z << ")"
                 << " angular_velocity: ("
@@ -572,7 +643,8 @@ std::string CarlaRecorderQuery::QueryInfo(std::string Filename, bool bShowAll)
 
         // frame end
       case static_cast<char>(CarlaRecorderPacketId::FrameEnd):
-        // do nothing, it is empty
+        if (!bShowAll)
+          SkipToNextFrame(Mask);
         break;
 
       default:
@@ -581,6 +653,8 @@ std::string CarlaRecorderQuery::QueryInfo(std::string Filename, bool bShowAll)
     }
   }
 
+  SetLastFrame();
+
   Info << "\nFrames: " << Frame.Id << "\n";
   Info << "Duration: " << Frame.Elapsed << " seconds\n";
 
@@ -597,7 +671,7 @@ std::string CarlaRecorderQuery::QueryCollisions(std::string Filename, char Categ
   std::string Filename2 = GetRecorderFilename(Filename);
 
   // try to open
-  File.open(Filename2, std::ios::binary);
+  File.open(GetReadableRecorderFilename(Filename2), std::ios::binary);
   if (!File.is_open())
   {
     Info << "File " << Filename2 << " not found on server\n";
@@ -627,6 +701,10 @@ std::string CarlaRecorderQuery::QueryCollisions(std::string Filename, char Categ
     }
   };
   std::unordered_set<std::pair<uint32_t, uint32_t>, PairHash > oldCollisions, newCollisions;
+  uint64_t PreviousFrameId = 0;
+
+  // only frames with events (to know the actors) or collisions are needed
+  const uint8_t Mask = CarlaRecorderFrameIndexEntry::HasEvents | CarlaRecorderFrameIndexEntry::HasCollisions;
 
   // header
   Info << std::setw(8) << "Time";
@@ -637,6 +715,8 @@ std::string CarlaRecorderQuery::QueryCollisions(std::string Filename, char Categ
   Info << " " << std::setw(35) << std::left << "Actor 2";
   Info << std::endl;
 
+  SkipToNextFrame(Mask);
+
   // parse only frames
   while (File)
   {
@@ -654,8 +734,12 @@ std::string CarlaRecorderQuery::QueryCollisions(std::string Filename, char Categ
       case static_cast<char>(CarlaRecorderPacketId::FrameStart):
         Frame.Read(File);
         // exchange sets of collisions (to know when a collision is new or continue from previous frame)
-        oldCollisions = std::move(newCollisions);
+        if (Frame.Id == PreviousFrameId + 1)
+          oldCollisions = std::move(newCollisions);
+        else
+          oldCollisions.clear(); // frames skipped had no collisions
         newCollisions.clear();
+        PreviousFrameId = Frame.Id;
         break;
 
       // events add
@@ -752,7 +836,7 @@ std::string CarlaRecorderQuery::QueryCollisions(std::string Filename, char Categ
 
       // frame end
       case static_cast<char>(CarlaRecorderPacketId::FrameEnd):
-        // do nothing, it is empty
+        SkipToNextFrame(Mask);
         break;
 
       default:
@@ -761,6 +845,8 @@ std::string CarlaRecorderQuery::QueryCollisions(std::string Filename, char Categ
     }
   }
 
+  SetLastFrame();
+
   Info << "\nFrames: " << Frame.Id << "\n";
   Info << "Duration: " << Frame.Elapsed << " seconds\n";
 
@@ -777,7 +863,7 @@ std::string CarlaRecorderQuery::QueryBlocked(std::string Filename, double MinTim
   std::string Filename2 = GetRecorderFilename(Filename);
 
   // try to open
-  File.open(Filename2, std::ios::binary);
+  File.open(GetReadableRecorderFilename(Filename2), std::ios::binary);
   if (!File.is_open())
   {
     Info << "File " << Filename2 << " not found on server\n";
@@ -859,11 +945,11 @@ std::string CarlaRecorderQuery::QueryBlocked(std::string Filename, double MinTim
 
       // positions
       case static_cast<char>(CarlaRecorderPacketId::Position):
+      case static_cast<char>(CarlaRecorderPacketId::PositionDelta):
         // read all positions
-        ReadValue<uint16_t>(File, Total);
-        for (i=0; i<Total; ++i)
+        ReadPositions();
+        for (const auto &Position : Positions)
         {
-          Position.Read(File);
           // check if actor moved less than a distance
           if (FVector::Distance(Actors[Position.DatabaseId].LastPosition, Position.Location) < MinDistance)
           {
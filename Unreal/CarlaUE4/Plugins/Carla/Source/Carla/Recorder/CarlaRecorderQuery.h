@@ -20,6 +20,7 @@
 #include "CarlaRecorderEventAdd.h"
 #include "CarlaRecorderEventDel.h"
 #include "CarlaRecorderEventParent.h"
+#include "CarlaRecorderFrameIndex.h"
 #include "CarlaRecorderFrames.h"
 #include "CarlaRecorderInfo.h"
 #include "CarlaRecorderPosition.h"
@@ -52,17 +53,20 @@ private:
   Header Header;
   CarlaRecorderInfo RecInfo;
   CarlaRecorderFrame Frame;
+  CarlaRecorderFrameIndex FrameIndex;
   CarlaRecorderEventAdd EventAdd;
   CarlaRecorderEventDel EventDel;
   CarlaRecorderEventParent EventParent;
-  CarlaRecorderPosition Position;
+  std::vector<CarlaRecorderPosition> Positions;
+  CarlaRecorderPositionCodec PositionCodec;
   CarlaRecorderCollision Collision;
   CarlaRecorderStateTrafficLight StateTraffic;
   CarlaRecorderAnimVehicle Vehicle;
   CarlaRecorderAnimWalker Walker;
   CarlaRecorderLightVehicle LightVehicle;
   CarlaRecorderLightScene LightScene;
-  CarlaRecorderKinematics Kinematics;
+  std::vector<CarlaRecorderKinematics> ActorsKinematics;
+  CarlaRecorderKinematicsCodec KinematicsCodec;
   CarlaRecorderActorBoundingBox ActorBoundingBox;
   CarlaRecorderPlatformTime PlatformTime;
   CarlaRecorderPhysicsControl PhysicsControl;
@@ -75,6 +79,18 @@ private:
   // skip current packet
   void SkipPacket(void);
 
-  // read the start info structure and check the magic string
+  // read the positions or kinematics of the current packet, full or delta
+  void ReadPositions(void);
+  void ReadKinematics(void);
+
+  // read the start info structure and check the magic string, and load the
+  // index of frames if the file has one
   bool CheckFileInfo(std::stringstream &Info);
+
+  // with an index of frames, jump to the next frame having any of the packets
+  // in 'Mask' (or to the end if there is none)
+  void SkipToNextFrame(uint8_t Mask);
+
+  // take the last frame from the index, in case the last ones were skipped
+  void SetLastFrame(void);
 };
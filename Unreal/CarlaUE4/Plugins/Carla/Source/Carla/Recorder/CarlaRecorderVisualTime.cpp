@@ -18,7 +18,7 @@ void CarlaRecorderVisualTime::Read(std::ifstream &InFile)
   ReadValue<double>(InFile, this->Time);
 }
 
-void CarlaRecorderVisualTime::Write(std::ofstream &OutFile)
+void CarlaRecorderVisualTime::Write(std::ostream &OutFile)
 {
   // write the packet id
   WriteValue<char>(OutFile, static_cast<char>(CarlaRecorderPacketId::VisualTime));
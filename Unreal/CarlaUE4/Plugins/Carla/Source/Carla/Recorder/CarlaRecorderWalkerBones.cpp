@@ -8,7 +8,7 @@
 #include "CarlaRecorderWalkerBones.h"
 #include "CarlaRecorderHelpers.h"
 
-void CarlaRecorderWalkerBones::Write(std::ofstream &OutFile)
+void CarlaRecorderWalkerBones::Write(std::ostream &OutFile)
 {
   // database id
   WriteValue<uint32_t>(OutFile, this->DatabaseId);
@@ -63,7 +63,7 @@ void CarlaRecorderWalkersBones::Add(const CarlaRecorderWalkerBones &Walker)
   Walkers.push_back(Walker);
 }
 
-void CarlaRecorderWalkersBones::Write(std::ofstream &OutFile)
+void CarlaRecorderWalkersBones::Write(std::ostream &OutFile)
 {
   // write the packet id
   WriteValue<char>(OutFile, static_cast<char>(CarlaRecorderPacketId::WalkerBones));
@@ -0,0 +1,300 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "Carla.h"
+#include "CarlaRecorderWriter.h"
+#include "CarlaRecorderHelpers.h"
+
+#include "Misc/Compression.h"
+
+#include <algorithm>
+#include <cstring>
+
+constexpr size_t CarlaRecorderWriter::FlushSize;
+constexpr uint32_t CarlaRecorderWriter::CompressedMagic;
+
+static FName GetCompressionFormat(CarlaRecorderWriter::ECompression Compression)
+{
+  return (Compression == CarlaRecorderWriter::ECompression::LZ4 ? NAME_LZ4 : NAME_Zlib);
+}
+
+// ---------------------------------------------
+
+std::streamsize CarlaRecorderWriter::FBuffer::xsputn(const char *Data, std::streamsize Count)
+{
+  auto &Active = Writer.Active;
+  size_t &Pos = Writer.Pos;
+
+  // overwrite what is already there, and append the rest
+  size_t Overwrite = std::min<size_t>(Count, Active.size() - Pos);
+  std::memcpy(Active.data() + Pos, Data, Overwrite);
+  Active.insert(Active.end(), Data + Overwrite, Data + Count);
+  Pos += Count;
+
+  return Count;
+}
+
+CarlaRecorderWriter::FBuffer::int_type CarlaRecorderWriter::FBuffer::overflow(int_type Char)
+{
+  if (traits_type::eq_int_type(Char, traits_type::eof()))
+  {
+    return traits_type::not_eof(Char);
+  }
+  char Value = traits_type::to_char_type(Char);
+  xsputn(&Value, 1);
+  return Char;
+}
+
+CarlaRecorderWriter::FBuffer::pos_type CarlaRecorderWriter::FBuffer::seekoff(
+    off_type Offset,
+    std::ios_base::seekdir Dir,
+    std::ios_base::openmode Which)
+{
+  if ((Which & std::ios_base::out) == 0)
+  {
+    return pos_type(off_type(-1));
+  }
+
+  uint64_t Current = Writer.Base + Writer.Pos;
+  uint64_t End = Writer.Base + Writer.Active.size();
+  int64_t Target = Offset;
+  if (Dir == std::ios_base::cur)
+    Target += Current;
+  else if (Dir == std::ios_base::end)
+    Target += End;
+
+  // only the data still in memory can be modified
+  if (Target < static_cast<int64_t>(Writer.Base) || Target > static_cast<int64_t>(End))
+  {
+    return pos_type(off_type(-1));
+  }
+
+  Writer.Pos = Target - Writer.Base;
+  return pos_type(Target);
+}
+
+CarlaRecorderWriter::FBuffer::pos_type CarlaRecorderWriter::FBuffer::seekpos(
+    pos_type Position,
+    std::ios_base::openmode Which)
+{
+  return seekoff(off_type(Position), std::ios_base::beg, Which);
+}
+
+// ---------------------------------------------
+
+CarlaRecorderWriter::CarlaRecorderWriter(void)
+  : Buffer(*this),
+    Stream(&Buffer)
+{
+}
+
+CarlaRecorderWriter::~CarlaRecorderWriter(void)
+{
+  Close();
+}
+
+bool CarlaRecorderWriter::Open(const std::string &Filename, ECompression InCompression)
+{
+  Close();
+
+  File.open(Filename, std::ios::binary);
+  if (!File.is_open())
+  {
+    return false;
+  }
+
+  Compression = InCompression;
+  if (Compression != ECompression::None)
+  {
+    WriteValue<uint32_t>(File, CompressedMagic);
+    WriteValue<uint8_t>(File, static_cast<uint8_t>(Compression));
+  }
+
+  Active.clear();
+  Active.reserve(FlushSize);
+  Pending.clear();
+  Base = 0;
+  Pos = 0;
+  bStop = false;
+  bFailed = false;
+  Stream.clear();
+  bIsOpen = true;
+
+  Thread = std::thread([this]() { Run(); });
+
+  return true;
+}
+
+void CarlaRecorderWriter::Commit(uint64_t Position)
+{
+  if (!bIsOpen || Active.size() < FlushSize)
+  {
+    return;
+  }
+
+  size_t Keep = std::min<size_t>(Position - Base, Active.size());
+  std::unique_lock<std::mutex> Lock(Mutex);
+  // wait until the previous buffer is written
+  Condition.wait(Lock, [this]() { return Pending.empty(); });
+
+  // swap buffers, moving the data to keep to the empty one
+  Pending.swap(Active);
+  Active.assign(Pending.begin() + Keep, Pending.end());
+  Pending.resize(Keep);
+  Base += Keep;
+  Pos -= std::min(Pos, Keep);
+
+  Condition.notify_all();
+}
+
+void CarlaRecorderWriter::Close(void)
+{
+  if (!bIsOpen)
+  {
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> Lock(Mutex);
+    Condition.wait(Lock, [this]() { return Pending.empty(); });
+    Pending.swap(Active);
+    bStop = true;
+    Condition.notify_all();
+  }
+  Thread.join();
+
+  File.close();
+  Active.clear();
+  Pending.clear();
+  Compressed.clear();
+  Compressed.shrink_to_fit();
+  bIsOpen = false;
+}
+
+void CarlaRecorderWriter::Run(void)
+{
+  std::unique_lock<std::mutex> Lock(Mutex);
+  while (true)
+  {
+    Condition.wait(Lock, [this]() { return bStop || !Pending.empty(); });
+    if (!Pending.empty())
+    {
+      // the game thread does not touch the pending buffer until it is empty
+      Lock.unlock();
+      WriteBlock(Pending);
+      Lock.lock();
+      Pending.clear();
+      Condition.notify_all();
+    }
+    else if (bStop)
+    {
+      break;
+    }
+  }
+}
+
+void CarlaRecorderWriter::WriteBlock(const std::vector<char> &Block)
+{
+  if (bFailed)
+  {
+    return;
+  }
+
+  if (Compression == ECompression::None)
+  {
+    File.write(Block.data(), Block.size());
+  }
+  else
+  {
+    // each block is its uncompressed and compressed sizes, and the data
+    FName Format = GetCompressionFormat(Compression);
+    int32 Size = Block.size();
+    int32 CompressedSize = FCompression::CompressMemoryBound(Format, Size);
+    Compressed.resize(CompressedSize);
+    if (!FCompression::CompressMemory(Format, Compressed.data(), CompressedSize, Block.data(), Size))
+    {
+      UE_LOG(LogCarla, Error, TEXT("Recorder: could not compress a block of %d bytes"), Size);
+      bFailed = true;
+      return;
+    }
+    WriteValue<uint32_t>(File, Size);
+    WriteValue<uint32_t>(File, CompressedSize);
+    File.write(Compressed.data(), CompressedSize);
+  }
+
+  if (!File)
+  {
+    UE_LOG(LogCarla, Error, TEXT("Recorder: error writing to the file, the recording is incomplete"));
+    bFailed = true;
+  }
+}
+
+bool CarlaRecorderWriter::ParseCompression(const std::string &Name, ECompression &OutCompression)
+{
+  if (Name == "none")
+    OutCompression = ECompression::None;
+  else if (Name == "lz4")
+    OutCompression = ECompression::LZ4;
+  else if (Name == "zlib")
+    OutCompression = ECompression::Zlib;
+  else
+    return false;
+  return true;
+}
+
+bool CarlaRecorderWriter::IsCompressed(const std::string &Filename)
+{
+  std::ifstream InFile(Filename, std::ios::binary);
+  uint32_t Magic = 0;
+  ReadValue<uint32_t>(InFile, Magic);
+  return (InFile && Magic == CompressedMagic);
+}
+
+bool CarlaRecorderWriter::Decompress(const std::string &Filename, const std::string &OutFilename)
+{
+  std::ifstream InFile(Filename, std::ios::binary);
+  uint32_t Magic = 0;
+  uint8_t Method = 0;
+  ReadValue<uint32_t>(InFile, Magic);
+  ReadValue<uint8_t>(InFile, Method);
+  if (!InFile || Magic != CompressedMagic ||
+      (Method != static_cast<uint8_t>(ECompression::LZ4) && Method != static_cast<uint8_t>(ECompression::Zlib)))
+  {
+    return false;
+  }
+
+  std::ofstream OutFile(OutFilename, std::ios::binary);
+  if (!OutFile.is_open())
+  {
+    return false;
+  }
+
+  FName Format = GetCompressionFormat(static_cast<ECompression>(Method));
+  std::vector<char> In, Out;
+  uint32_t Size, CompressedSize;
+  while (true)
+  {
+    ReadValue<uint32_t>(InFile, Size);
+    ReadValue<uint32_t>(InFile, CompressedSize);
+    if (!InFile)
+    {
+      // end of the blocks
+      break;
+    }
+    In.resize(CompressedSize);
+    Out.resize(Size);
+    InFile.read(In.data(), CompressedSize);
+    if (!InFile ||
+        !FCompression::UncompressMemory(Format, Out.data(), Size, In.data(), CompressedSize))
+    {
+      UE_LOG(LogCarla, Error, TEXT("Recorder: corrupted block in %s"), UTF8_TO_TCHAR(Filename.c_str()));
+      return false;
+    }
+    OutFile.write(Out.data(), Size);
+  }
+
+  return static_cast<bool>(OutFile);
+}
@@ -0,0 +1,122 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Writes the recorder file from a background thread. The packets of each frame
+// are serialized in the game thread into an in-memory buffer, and when it is
+// full it is swapped with a second buffer that the I/O thread writes to disk,
+// optionally compressed in blocks. The game thread only waits if the disk
+// falls behind a whole buffer.
+//
+// Positions in the stream (tellp, seekp) are offsets in the uncompressed file,
+// and the data not yet handed to the I/O thread can still be overwritten.
+class CarlaRecorderWriter
+{
+
+public:
+
+  enum class ECompression : uint8_t
+  {
+    None = 0,
+    LZ4  = 1,
+    Zlib = 2
+  };
+
+  CarlaRecorderWriter(void);
+  ~CarlaRecorderWriter(void);
+
+  bool Open(const std::string &Filename, ECompression Compression = ECompression::None);
+
+  bool IsOpen(void) const
+  {
+    return bIsOpen;
+  }
+
+  // stream to serialize the packets
+  std::ostream &GetStream(void)
+  {
+    return Stream;
+  }
+
+  // hand the data before 'Position' to the I/O thread if the buffer is full,
+  // the data after it stays in memory to be completed later
+  void Commit(uint64_t Position);
+
+  // write all the data left and close the file
+  void Close(void);
+
+  // parse the compression from its name (none, lz4 or zlib)
+  static bool ParseCompression(const std::string &Name, ECompression &Compression);
+
+  static bool IsCompressed(const std::string &Filename);
+
+  // write the uncompressed recording of 'Filename' into 'OutFilename'
+  static bool Decompress(const std::string &Filename, const std::string &OutFilename);
+
+private:
+
+  // memory buffer with absolute positions, writes into the active buffer of
+  // the writer
+  class FBuffer : public std::streambuf
+  {
+  public:
+
+    explicit FBuffer(CarlaRecorderWriter &InWriter) : Writer(InWriter) {}
+
+  protected:
+
+    std::streamsize xsputn(const char *Data, std::streamsize Count) override;
+
+    int_type overflow(int_type Char) override;
+
+    pos_type seekoff(off_type Offset, std::ios_base::seekdir Dir, std::ios_base::openmode Which) override;
+
+    pos_type seekpos(pos_type Position, std::ios_base::openmode Which) override;
+
+  private:
+
+    CarlaRecorderWriter &Writer;
+  };
+
+  void Run(void);
+
+  void WriteBlock(const std::vector<char> &Block);
+
+  static constexpr size_t FlushSize = 8u << 20;
+
+  static constexpr uint32_t CompressedMagic = 0x5A524143; // "CARZ"
+
+  FBuffer Buffer;
+  std::ostream Stream;
+
+  std::ofstream File;
+  ECompression Compression = ECompression::None;
+  bool bIsOpen = false;
+
+  // game thread side: serialized data, its position in the file and the
+  // current write position inside it
+  std::vector<char> Active;
+  uint64_t Base = 0;
+  size_t Pos = 0;
+
+  // I/O thread side: data being written, empty when the thread is idle
+  std::vector<char> Pending;
+  std::vector<char> Compressed;
+  bool bStop = false;
+  bool bFailed = false;
+  std::mutex Mutex;
+  std::condition_variable Condition;
+  std::thread Thread;
+};
@@ -66,14 +66,23 @@ void CarlaReplayer::Rewind(void)
 
   MappedId.clear();
   IsHeroMap.clear();
+  PositionCodec.Reset();
 
   // read geneal Info
   RecInfo.Read(File);
+
+  // load the index of frames, if any
+  FrameIndex.Read(File);
 }
 
 // read last frame in File and return the Total time recorded
 double CarlaReplayer::GetTotalTime(void)
 {
+  if (!FrameIndex.IsEmpty())
+  {
+    return FrameIndex.GetTotalTime();
+  }
+
   std::streampos Current = File.tellg();
 
   // parse only frames
@@ -120,7 +129,7 @@ std::string CarlaReplayer::ReplayFile(std::string Filename, double TimeStart, do
   Info << "Replaying File: " << Filename2 << std::endl;
 
   // try to open
-  File.open(Filename2, std::ios::binary);
+  File.open(GetReadableRecorderFilename(Filename2), std::ios::binary);
   if (!File.is_open())
   {
     Info << "File " << Filename2 << " not found on server\n";
@@ -209,7 +218,7 @@ void CarlaReplayer::CheckPlayAfterMapLoaded(void)
   }
 
   // try to open
-  File.open(Autoplay.Filename, std::ios::binary);
+  File.open(GetReadableRecorderFilename(Autoplay.Filename), std::ios::binary);
   if (!File.is_open())
   {
     return;
@@ -268,6 +277,10 @@ void CarlaReplayer::ProcessToTime(double Time, bool IsFirstTime)
     bFrameFound = true;
     bExitLoop = true;
   }
+  else
+  {
+    SkipToFrame(NewTime);
+  }
 
   // process all frames until time we want or end
   while (!File.eof() && !bExitLoop)
@@ -319,10 +332,20 @@ void CarlaReplayer::ProcessToTime(double Time, bool IsFirstTime)
       case static_cast<char>(CarlaRecorderPacketId::Position):
         if (bFrameFound)
           ProcessPositions(IsFirstTime);
+        else if (RecInfo.Version >= 2)
+          ReadPositions(false, SkippedPos); // deltas may follow
         else
           SkipPacket();
         break;
 
+      // changes of positions
+      case static_cast<char>(CarlaRecorderPacketId::PositionDelta):
+        if (bFrameFound)
+          ProcessPositions(IsFirstTime, true);
+        else
+          ReadPositions(true, SkippedPos);
+        break;
+
       // states
       case static_cast<char>(CarlaRecorderPacketId::State):
         if (bFrameFound)
@@ -403,6 +426,103 @@ void CarlaReplayer::ProcessToTime(double Time, bool IsFirstTime)
   }
 }
 
+void CarlaReplayer::SkipToFrame(double Time)
+{
+  if (FrameIndex.IsEmpty())
+  {
+    return;
+  }
+
+  const auto &Entries = FrameIndex.GetEntries();
+  size_t Target = FrameIndex.FindFrame(Time);
+  size_t Next = FrameIndex.FindOffset(File.tellg());
+
+  // only forward, the current frame is already processed
+  if (Next >= Target)
+  {
+    return;
+  }
+
+  // the positions of the target frame may be a delta, so they need to be
+  // decoded from the last keyframe (or from the current frame if it is later)
+  size_t Decode = Next;
+  for (size_t i = Target + 1; i-- > Next; )
+  {
+    if (Entries[i].Flags & CarlaRecorderFrameIndexEntry::HasKeyframe)
+    {
+      Decode = i;
+      break;
+    }
+  }
+  if (RecInfo.Version < 2)
+  {
+    // all positions are written in full
+    Decode = Target;
+  }
+
+  // actors created or destroyed in the frames skipped
+  for (size_t i = FrameIndex.FindNext(Next, CarlaRecorderFrameIndexEntry::HasEvents);
+       i < Decode;
+       i = FrameIndex.FindNext(i + 1, CarlaRecorderFrameIndexEntry::HasEvents))
+  {
+    File.seekg(Entries[i].Offset, std::ios::beg);
+    ProcessFrameEvents(false);
+  }
+
+  // and all the frames from the keyframe
+  for (size_t i = Decode; i < Target; ++i)
+  {
+    File.seekg(Entries[i].Offset, std::ios::beg);
+    ProcessFrameEvents(true);
+  }
+
+  File.seekg(Entries[Target].Offset, std::ios::beg);
+}
+
+void CarlaReplayer::ProcessFrameEvents(bool bDecodePositions)
+{
+  while (!File.eof())
+  {
+    ReadHeader();
+
+    switch (Header.Id)
+    {
+      case static_cast<char>(CarlaRecorderPacketId::EventAdd):
+        ProcessEventsAdd();
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::EventDel):
+        ProcessEventsDel();
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::EventParent):
+        ProcessEventsParent();
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::Position):
+        if (bDecodePositions)
+          ReadPositions(false, SkippedPos);
+        else
+          SkipPacket();
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::PositionDelta):
+        if (bDecodePositions)
+          ReadPositions(true, SkippedPos);
+        else
+          SkipPacket();
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::FrameEnd):
+        return;
+
+      default:
+        SkipPacket();
+        break;
+    }
+  }
+}
+
 void CarlaReplayer::ProcessVisualTime(void)
 {
   CarlaRecorderVisualTime VisualTime;
@@ -596,21 +716,44 @@ void CarlaReplayer::ProcessLightScene(void)
   }
 }
 
-void CarlaReplayer::ProcessPositions(bool IsFirstTime)
+void CarlaReplayer::ReadPositions(bool bIsDelta, std::vector<CarlaRecorderPosition> &Positions)
 {
-  uint16_t i, Total;
+  if (bIsDelta)
+  {
+    // rebuild the positions from the previous ones
+    if (!PositionCodec.Decode(File, Positions))
+    {
+      UE_LOG(LogCarla, Warning, TEXT("Replayer: positions changed without the previous ones, waiting for the next keyframe"));
+    }
+    return;
+  }
 
-  // save current as previous
-  PrevPos = std::move(CurrPos);
+  uint16_t i, Total;
 
   // read all positions
   ReadValue<uint16_t>(File, Total);
-  CurrPos.clear();
-  CurrPos.reserve(Total);
+  Positions.clear();
+  Positions.reserve(Total);
   for (i = 0; i < Total; ++i)
   {
     CarlaRecorderPosition Pos;
     Pos.Read(File);
+    Positions.push_back(std::move(Pos));
+  }
+
+  // keyframe for the next deltas
+  PositionCodec.SetKeyframe(Positions);
+}
+
+void CarlaReplayer::ProcessPositions(bool IsFirstTime, bool bIsDelta)
+{
+  // save current as previous
+  PrevPos = std::move(CurrPos);
+
+  // read all positions
+  ReadPositions(bIsDelta, CurrPos);
+  for (auto &Pos : CurrPos)
+  {
     // assign mapped Id
     auto NewId = MappedId.find(Pos.DatabaseId);
     if (NewId != MappedId.end())
@@ -619,7 +762,6 @@ void CarlaReplayer::ProcessPositions(bool IsFirstTime)
     }
     else
       UE_LOG(LogCarla, Log, TEXT("Actor not found when trying to move from replayer (id. %d)"), Pos.DatabaseId);
-    CurrPos.push_back(std::move(Pos));
   }
 
   // check to copy positions the first time
@@ -12,6 +12,7 @@
 
 #include <functional>
 #include "CarlaRecorderInfo.h"
+#include "CarlaRecorderFrameIndex.h"
 #include "CarlaRecorderFrames.h"
 #include "CarlaRecorderEventAdd.h"
 #include "CarlaRecorderEventDel.h"
@@ -102,9 +103,14 @@ private:
   Header Header;
   CarlaRecorderInfo RecInfo;
   CarlaRecorderFrame Frame;
+  // index of frames (empty if the file has none)
+  CarlaRecorderFrameIndex FrameIndex;
   // positions (to be able to interpolate)
   std::vector<CarlaRecorderPosition> CurrPos;
   std::vector<CarlaRecorderPosition> PrevPos;
+  // positions of the frames not played, decoded to follow the deltas
+  std::vector<CarlaRecorderPosition> SkippedPos;
+  CarlaRecorderPositionCodec PositionCodec;
   // mapping id
   std::unordered_map<uint32_t, uint32_t> MappedId;
   // times
@@ -130,6 +136,11 @@ private:
 
   void Rewind(void);
 
+  // use the frame index to jump to the frame being played at 'Time',
+  // applying only the events of the frames skipped (and decoding the
+  // positions since the last keyframe)
+  void SkipToFrame(double Time);
+
   // processing packets
   void ProcessToTime(double Time, bool IsFirstTime = false);
 
@@ -139,7 +150,14 @@ private:
   void ProcessEventsDel(void);
   void ProcessEventsParent(void);
 
-  void ProcessPositions(bool IsFirstTime = false);
+  // process the events of the frame starting at the current position, and
+  // decode its positions if needed
+  void ProcessFrameEvents(bool bDecodePositions);
+
+  void ProcessPositions(bool IsFirstTime = false, bool bIsDelta = false);
+
+  // read a full or delta packet of positions, with the recorded ids
+  void ReadPositions(bool bIsDelta, std::vector<CarlaRecorderPosition> &Positions);
 
   void ProcessStates(void);
 
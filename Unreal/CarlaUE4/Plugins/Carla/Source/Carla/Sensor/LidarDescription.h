@@ -69,4 +69,19 @@ struct CARLA_API FLidarDescription
 
   UPROPERTY(EditAnywhere)
   float NoiseStdDev = 0.0f;
+
+  /// Reflectivity overrides per semantic tag, as "tag:value" pairs separated
+  /// by commas.
+  UPROPERTY(EditAnywhere)
+  FString Reflectivity;
+
+  /// File with reflectivity overrides per semantic tag, one "tag:value" pair
+  /// per line. Relative paths are resolved against the Content folder.
+  UPROPERTY(EditAnywhere)
+  FString ReflectivityFile;
+
+  /// Send the points with 16-bit positions, 8-bit intensities and 8-bit tags
+  /// instead of floats, to save bandwidth.
+  UPROPERTY(EditAnywhere)
+  bool QuantizePoints = false;
 };
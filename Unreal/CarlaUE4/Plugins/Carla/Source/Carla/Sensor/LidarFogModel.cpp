@@ -0,0 +1,275 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "Carla.h"
+#include "Carla/Sensor/LidarFogModel.h"
+#include "Carla/Game/CarlaStaticDelegates.h"
+
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+
+constexpr float FFogStepSizeTable::MaxDistance;
+constexpr float FFogStepSizeTable::StepsPerMeter;
+constexpr uint32_t FFogStepSizeTable::Size;
+
+struct FogDensityDataPoint {
+  float x;
+  float y;
+};
+
+FLidarFogModel::FLidarFogModel(const FWeatherParameters &InitialWeather)
+  : Shared(std::make_shared<FShared>())
+{
+  OnWeatherChangeHandle = FCarlaStaticDelegates::OnWeatherChange.AddLambda(
+      [this](const FWeatherParameters &Weather) { SetFogDensity(Weather.FogDensity); });
+  if (FindGrid() == nullptr)
+  {
+    // Load the fog data up front, even in clear weather.
+    Async(EAsyncExecution::ThreadPool, []() { LoadGrid(); });
+  }
+  SetFogDensity(InitialWeather.FogDensity);
+}
+
+FLidarFogModel::~FLidarFogModel()
+{
+  FCarlaStaticDelegates::OnWeatherChange.Remove(OnWeatherChangeHandle);
+  // Discard any pending load.
+  ++Shared->Generation;
+}
+
+void FLidarFogModel::SetFogDensity(float FogDensity)
+{
+  FogDensity = std::min(std::max(FogDensity, 0.0f), 100.0f);
+  if (FogDensity == RequestedFogDensity)
+  {
+    return;
+  }
+  RequestedFogDensity = FogDensity;
+  const uint32_t Generation = ++Shared->Generation;
+
+  auto State = std::make_shared<FLidarFogState>();
+  State->FogDensity = FogDensity;
+  if (FogDensity == 0.0f)
+  {
+    // Clear weather, no soft return.
+    Publish(*Shared, Generation, std::move(State));
+    return;
+  }
+  State->Mor = CalculateMOR(FogDensity);
+  State->Alpha = std::log(20.0f) / State->Mor;
+  State->Beta = 0.046f / State->Mor;
+
+  if (auto Grid = FindGrid())
+  {
+    State->StepSizeData = MakeStepSizeTable(*Grid, State->Alpha);
+    Publish(*Shared, Generation, std::move(State));
+    return;
+  }
+
+  // Keep the current state until the grid is loaded.
+  Async(EAsyncExecution::ThreadPool, [Shared=Shared, Generation, State=std::move(State)]() mutable {
+    State->StepSizeData = MakeStepSizeTable(*LoadGrid(), State->Alpha);
+    Publish(*Shared, Generation, std::move(State));
+  });
+}
+
+void FLidarFogModel::Publish(FShared &Shared, uint32_t Generation, std::shared_ptr<FLidarFogState> State)
+{
+  if (Shared.Generation == Generation)
+  {
+    Shared.State.store(std::move(State));
+  }
+}
+
+float FLidarFogModel::CalculateMOR(const float FogDensity)
+{
+  static constexpr FogDensityDataPoint FogDensityData[] = {
+    {2, 600},
+    {10, 300},
+    {15, 200},
+    {25, 150},
+    {40, 100},
+    {50, 50},
+    {80, 30},
+    {90, 25},
+    {95, 20},
+    {100, 15}
+  };
+  // Piecewise linear regression.
+  float NewMOR = 0.0f;
+  for (size_t i = 1u; i < UE_ARRAY_COUNT(FogDensityData); ++i)
+  {
+    const auto &Previous = FogDensityData[i - 1u];
+    const auto &Next = FogDensityData[i];
+    if (FogDensity >= Previous.x && FogDensity < Next.x)
+    {
+      const float Slope = (Next.y - Previous.y) / (Next.x - Previous.x);
+      NewMOR = Previous.y + Slope * (FogDensity - Previous.x);
+      break;
+    }
+  }
+  if (NewMOR <= 0)
+  {
+    NewMOR = 10000;
+  }
+  return NewMOR;
+}
+
+static const TCHAR *FogDataFilePrefix = TEXT("integral_0m_to_200m_stepsize_0.1m_tau_h_20ns_alpha_");
+
+/// Grid of every fog data file, shared by every fog LiDAR.
+static carla::AtomicSharedPtr<const carla::sensor::FogIntensityGrid> FogGrid;
+
+static FCriticalSection FogGridLoadMutex;
+
+std::shared_ptr<const FLidarFogModel::FFogGrid> FLidarFogModel::FindGrid()
+{
+  return FogGrid.load();
+}
+
+std::shared_ptr<const FLidarFogModel::FFogGrid> FLidarFogModel::LoadGrid()
+{
+  FScopeLock Lock(&FogGridLoadMutex);
+  if (auto Grid = FogGrid.load())
+  {
+    return Grid;
+  }
+
+  const FString FogDataPath = FPaths::Combine(FPaths::ProjectContentDir(), TEXT("Weather/FogData"));
+  const FString CachePath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("FogData/FogIntensityGrid.bin"));
+  TArray<FString> FileNames;
+  IFileManager::Get().FindFiles(FileNames, *FPaths::Combine(FogDataPath, FString(FogDataFilePrefix) + TEXT("*.txt")), true, false);
+  FileNames.Sort();
+
+  // The cache is only valid for the same set of files, unmodified.
+  uint32 SourceCrc = 0u;
+  for (const FString &FileName : FileNames)
+  {
+    const FString FullPath = FPaths::Combine(FogDataPath, FileName);
+    const int64 FileSize = IFileManager::Get().FileSize(*FullPath);
+    const int64 TimeStamp = IFileManager::Get().GetTimeStamp(*FullPath).GetTicks();
+    SourceCrc = FCrc::StrCrc32(*FileName, SourceCrc);
+    SourceCrc = FCrc::MemCrc32(&FileSize, sizeof(FileSize), SourceCrc);
+    SourceCrc = FCrc::MemCrc32(&TimeStamp, sizeof(TimeStamp), SourceCrc);
+  }
+  const uint64_t SourceKey = (static_cast<uint64_t>(FileNames.Num()) << 32u) | SourceCrc;
+
+  auto Grid = std::make_shared<FFogGrid>();
+  TArray<uint8> Cache;
+  if (FFileHelper::LoadFileToArray(Cache, *CachePath, FILEREAD_Silent) &&
+      FFogGrid::Deserialize(Cache.GetData(), Cache.Num(), SourceKey, *Grid))
+  {
+    UE_LOG(LogCarla, Log, TEXT("Fog data loaded from %s"), *CachePath);
+  }
+  else
+  {
+    *Grid = BuildGrid(FileNames, FogDataPath);
+    const auto Buffer = Grid->Serialize(SourceKey);
+    if (!Grid->empty() &&
+        !FFileHelper::SaveArrayToFile(TArrayView<const uint8>(Buffer.data(), Buffer.size()), *CachePath))
+    {
+      UE_LOG(LogCarla, Warning, TEXT("Failed to write the fog data cache %s"), *CachePath);
+    }
+  }
+  if (Grid->empty())
+  {
+    UE_LOG(LogCarla, Warning, TEXT("No fog data found in %s"), *FogDataPath);
+  }
+
+  FogGrid.store(Grid);
+  return Grid;
+}
+
+FLidarFogModel::FFogGrid FLidarFogModel::BuildGrid(const TArray<FString> &FileNames, const FString &FogDataPath)
+{
+  FFogGrid Grid{FFogStepSizeTable::Size, FFogStepSizeTable::StepsPerMeter, FFogStepSizeTable::MaxDistance};
+  for (const FString &FileName : FileNames)
+  {
+    // The alpha of each table is in its file name.
+    const FString Alpha = FPaths::GetBaseFilename(FileName).RightChop(FCString::Strlen(FogDataFilePrefix));
+    if (!Alpha.IsNumeric())
+    {
+      UE_LOG(LogCarla, Warning, TEXT("Ignoring fog data file %s"), *FileName);
+      continue;
+    }
+    const FFogStepSizeTable Table = ReadStepSizeTable(TCHAR_TO_UTF8(*FPaths::Combine(FogDataPath, FileName)));
+    if (!Table.IsEmpty())
+    {
+      Grid.AddRow(FCString::Atof(*Alpha), Table.Distance.data(), Table.Integral.data());
+    }
+  }
+  return Grid;
+}
+
+std::shared_ptr<const FFogStepSizeTable> FLidarFogModel::MakeStepSizeTable(const FFogGrid &Grid, float Alpha)
+{
+  if (Grid.empty() || Grid.columns() != FFogStepSizeTable::Size)
+  {
+    return nullptr;
+  }
+  auto Table = std::make_shared<FFogStepSizeTable>();
+  Table->Distance.resize(FFogStepSizeTable::Size);
+  Table->Integral.resize(FFogStepSizeTable::Size);
+  Grid.Interpolate(Alpha, Table->Distance.data(), Table->Integral.data());
+  return Table;
+}
+
+FFogStepSizeTable FLidarFogModel::ReadStepSizeTable(const std::string &FullPath)
+{
+  // Each line has the form "<distance>:<R_tmp>,<i_tmp>".
+  FFogStepSizeTable Table;
+  std::ifstream InputFile(FullPath);
+  if (!InputFile.is_open())
+  {
+    UE_LOG(LogCarla, Warning, TEXT("Fog data file not found: %s"), UTF8_TO_TCHAR(FullPath.c_str()));
+    return Table;
+  }
+
+  Table.Distance.resize(FFogStepSizeTable::Size);
+  Table.Integral.resize(FFogStepSizeTable::Size, 0.0f);
+  for (uint32_t i = 0u; i < FFogStepSizeTable::Size; ++i)
+  {
+    Table.Distance[i] = static_cast<float>(i) / FFogStepSizeTable::StepsPerMeter;
+  }
+
+  std::string Line;
+  while (getline(InputFile, Line))
+  {
+    const char *Begin = Line.c_str();
+    char *End = nullptr;
+    const float Key = std::strtof(Begin, &End);
+    if (End == Begin || *End != ':')
+    {
+      continue;
+    }
+    Begin = End + 1;
+    const float StepDistance = std::strtof(Begin, &End);
+    if (End == Begin || *End != ',')
+    {
+      continue;
+    }
+    Begin = End + 1;
+    const double Integral = std::strtod(Begin, &End);
+    if (End == Begin)
+    {
+      continue;
+    }
+    const uint32_t Index = static_cast<uint32_t>(std::lround(
+        std::min(std::max(Key, 0.0f), FFogStepSizeTable::MaxDistance) * FFogStepSizeTable::StepsPerMeter));
+    Table.Distance[Index] = StepDistance;
+    Table.Integral[Index] = static_cast<float>(Integral);
+  }
+
+  return Table;
+}
@@ -0,0 +1,121 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "Carla/Weather/WeatherParameters.h"
+
+#include <compiler/disable-ue4-macros.h>
+#include <carla/AtomicSharedPtr.h>
+#include <carla/NonCopyable.h>
+#include <carla/sensor/FogIntensityGrid.h>
+#include <compiler/enable-ue4-macros.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// Soft-return integrals of a single alpha value, stored densely and indexed
+/// by the hit distance in steps of 0.1m (from 0m up to 200m). Interpolated
+/// from the alpha × distance grid of every fog data file.
+struct FFogStepSizeTable
+{
+  static constexpr float MaxDistance = 200.0f;
+  static constexpr float StepsPerMeter = 10.0f;
+  static constexpr uint32_t Size = 2001u;
+
+  /// R_tmp, distance at which the soft-return integral is maximum.
+  std::vector<float> Distance;
+  /// i_tmp, maximum of the soft-return integral.
+  std::vector<float> Integral;
+
+  bool IsEmpty() const
+  {
+    return Distance.empty();
+  }
+};
+
+/// Fog coefficients and soft-return table of a given fog density. Immutable
+/// once published by FLidarFogModel.
+struct FLidarFogState
+{
+  float FogDensity = 0.0f;
+
+  /// Meteorological optical range, in meters.
+  float Mor = 10000.0f;
+
+  /// Suppose MOR = 10km in clear weather.
+  float Alpha = 0.000229f;
+  float Beta = 0.0000046f;
+
+  /// Null in clear weather or if the fog data could not be loaded.
+  std::shared_ptr<const FFogStepSizeTable> StepSizeData;
+};
+
+/// Fog model of the fog LiDAR. Listens to weather changes and prepares the
+/// coefficients and soft-return table of the new fog density, so the sensor
+/// never blocks on file I/O while ticking.
+///
+/// Every fog data file is loaded once into a shared alpha × distance grid
+/// (from a binary cache when up to date), after that any fog density is
+/// interpolated from the grid without touching the disk.
+class FLidarFogModel : private carla::NonCopyable
+{
+public:
+
+  /// Subscribes to weather changes and starts preparing @a InitialWeather.
+  explicit FLidarFogModel(const FWeatherParameters &InitialWeather);
+
+  ~FLidarFogModel();
+
+  /// Request the model for @a FogDensity. Returns immediately, the current
+  /// state is kept until the new one is ready. Game thread only.
+  void SetFogDensity(float FogDensity);
+
+  /// State to use for the current tick. Thread-safe, never blocks on I/O.
+  std::shared_ptr<const FLidarFogState> GetState() const
+  {
+    return Shared->State.load();
+  }
+
+private:
+
+  struct FShared
+  {
+    carla::AtomicSharedPtr<const FLidarFogState> State{std::make_shared<FLidarFogState>()};
+
+    /// Incremented on every request, older requests are discarded.
+    std::atomic<uint32_t> Generation{0u};
+  };
+
+  static void Publish(FShared &Shared, uint32_t Generation, std::shared_ptr<FLidarFogState> State);
+
+  static float CalculateMOR(float FogDensity);
+
+  using FFogGrid = carla::sensor::FogIntensityGrid;
+
+  /// Returns the grid if already loaded, or null. Never blocks.
+  static std::shared_ptr<const FFogGrid> FindGrid();
+
+  /// Loads the grid of every fog data file, does file I/O. Only the first
+  /// call loads, concurrent calls wait for it.
+  static std::shared_ptr<const FFogGrid> LoadGrid();
+
+  /// Parse the text tables into a grid.
+  static FFogGrid BuildGrid(const TArray<FString> &FileNames, const FString &FogDataPath);
+
+  /// Table of @a Alpha, interpolated from @a Grid, or null if the grid is empty.
+  static std::shared_ptr<const FFogStepSizeTable> MakeStepSizeTable(const FFogGrid &Grid, float Alpha);
+
+  static FFogStepSizeTable ReadStepSizeTable(const std::string &FullPath);
+
+  std::shared_ptr<FShared> Shared;
+
+  float RequestedFogDensity = -1.0f;
+
+  FDelegateHandle OnWeatherChangeHandle;
+};
@@ -19,7 +19,9 @@
 
 #include "DrawDebugHelpers.h"
 #include "Engine/CollisionProfile.h"
+#include "Misc/FileHelper.h"
 #include "Runtime/Engine/Classes/Kismet/KismetMathLibrary.h"
+#include "Runtime/Core/Public/Async/ParallelFor.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -49,6 +51,9 @@ void ARayCastLidarWithFog::Set(const FLidarDescription& LidarDescription)
 {
 	Description = LidarDescription;
 	LidarData = FLidarData(Description.Channels);
+	LidarData.SetEncoding(Description.QuantizePoints
+		? carla::sensor::data::LidarWithFogEncoding::Quantized
+		: carla::sensor::data::LidarWithFogEncoding::Float32);
 	CreateLasers();
 	PointsPerChannel.resize(Description.Channels);
 
@@ -56,6 +61,29 @@ void ARayCastLidarWithFog::Set(const FLidarDescription& LidarDescription)
 	DropOffBeta = 1.0f - Description.DropOffAtZeroIntensity;
 	DropOffAlpha = Description.DropOffAtZeroIntensity / Description.DropOffIntensityLimit;
 	DropOffGenActive = Description.DropOffGenRate > std::numeric_limits<float>::epsilon();
+
+	BuildReflectivityTable();
+	TickCount = 0u;
+}
+
+void ARayCastLidarWithFog::BeginPlay()
+{
+	Super::BeginPlay();
+	TickCount = 0u;
+
+	FWeatherParameters InitialWeather;
+	if (auto* Weather = GetEpisode().GetWeather())
+	{
+		InitialWeather = Weather->GetCurrentWeather();
+	}
+	FogModel = std::make_unique<FLidarFogModel>(InitialWeather);
+}
+
+void ARayCastLidarWithFog::EndPlay(EEndPlayReason::Type EndPlayReason)
+{
+	FogModel.reset();
+	FogState.reset();
+	Super::EndPlay(EndPlayReason);
 }
 
 void ARayCastLidarWithFog::PostPhysTick(UWorld* World, ELevelTick TickType, float DeltaTime)
@@ -83,127 +111,113 @@ void ARayCastLidarWithFog::PostPhysTick(UWorld* World, ELevelTick TickType, floa
 // 	return IntRec;
 // }
 
-ARayCastLidarWithFog::FDetection ARayCastLidarWithFog::ComputeDetection(const FHitResult& HitInfo, const FTransform& SensorTransf)
+void ARayCastLidarWithFog::UpdateFogParameters()
 {
-	FDetection Detection;
-	Detection.object_tag = 0;
-	const FVector HitPoint = HitInfo.ImpactPoint;
-	Detection.point = SensorTransf.Inverse().TransformPosition(HitPoint);
-	const float Distance = Detection.point.Length();
-
-	// const float AttenAtm = Description.AtmospAttenRate;
-	// const float AbsAtm = exp(-AttenAtm * Distance);
-	// float OriginalIntensity = static_cast<uint32_t>(AbsAtm * 255);
-	
-
-	// Get reflectivity
-	float Gamma = 0.0000021f;
-	// float Gamma = 0.21f;
-	const FActorRegistry& Registry = GetEpisode().GetActorRegistry();
-	Detection.object_tag = static_cast<uint32_t>(HitInfo.Component->CustomDepthStencilValue);
-	Gamma = GetReflectivity(Detection.object_tag) / std::pow(10, 5);
-
-	float Beta0 = Gamma / M_PI;
-	float OriginalIntensity = 5e9; // C_A P_0
-
-	FWeatherParameters weather = GetEpisode().GetWeather()->GetCurrentWeather();
-	float FogDensity = weather.FogDensity;
-	
-	if (FogDensity < 0)
-	{
-		FogDensity = 0;
-	}
-	else if (FogDensity > 100)
-	{
-		FogDensity = 100;
-	}
+	// The fog model follows the weather on its own, no I/O here.
+	FogState = FogModel != nullptr ? FogModel->GetState() : std::make_shared<FLidarFogState>();
+	const FFogStepSizeTable* StepSizeData = FogState->StepSizeData.get();
+
+	FogParameters.original_intensity = 5e9f; // C_A P_0
+	FogParameters.alpha = FogState->Alpha;
+	FogParameters.beta = FogState->Beta;
+	FogParameters.is_foggy = FogState->FogDensity > 0;
+	const bool HasTable = StepSizeData != nullptr && !StepSizeData->IsEmpty();
+	FogParameters.step_distance = HasTable ? StepSizeData->Distance.data() : nullptr;
+	FogParameters.step_integral = HasTable ? StepSizeData->Integral.data() : nullptr;
+	FogParameters.table_size = HasTable ? FFogStepSizeTable::Size : 0u;
+	FogParameters.steps_per_meter = FFogStepSizeTable::StepsPerMeter;
+	FogParameters.max_distance = FFogStepSizeTable::MaxDistance;
+}
 
-	// Fog density changed
-	if (CurrentFogDensity != FogDensity || isinf(Alpha))
-	{
-		CurrentFogDensity = FogDensity;
-		GetStepSizeData(CurrentFogDensity);
-		Mor = CalculateMOR(FogDensity);
-		Alpha = std::log(20) / Mor;
-		Beta = 0.046f / Mor;
-	}
-	if (FogDensity == 0)
-	{
-		// Suppose MOR = 10km in clear weather
-		Alpha = 0.000229f; 
-		Beta = 0.0000046f;
-	}
+void ARayCastLidarWithFog::ComputeChannelDetections(uint32_t Channel, const FTransform& SensorTransfInverse)
+{
+	const auto& Hits = RecordedHits[Channel];
+	const auto& Rays = RecordedRays[Channel];
+	FFogChannelBatch& Batch = ChannelBatches[Channel];
+	Batch.Resize(Hits.size());
 
-	if (FogDensity > 0)
+	for (auto idxHit = 0u; idxHit < Hits.size(); ++idxHit)
 	{
-		// Hard
-		float Hard = OriginalIntensity * Beta0 / std::pow(Distance, 2.0) * exp(-2 * Alpha * Distance);
-		Hard = std::min(Hard, 255.0f);
-		// Soft
-		char buffer[20];
-		std::snprintf(buffer, sizeof(buffer), "%.1f", std::min(Distance, 200.0f));
-		std::string Key(buffer);
-
-		// R_tmp, i_soft
-		const std::vector<std::string>& Data = StepSizeData.at(Key);
-		float StepDataDistance = std::stof(Data[0]);
-		double Soft = std::stod(Data[1]); // max(Simpson), i.e., i_{tmp}
-		Soft = OriginalIntensity * Beta * Soft;
-
-		// i_soft
-		if (Soft > 255)
+		const FHitResult& HitInfo = Hits[idxHit];
+		FDetection& Detection = Batch.Detections[idxHit];
+		const FVector HitPoint = HitInfo.ImpactPoint;
+		Detection.point = SensorTransfInverse.TransformPosition(HitPoint);
+		Detection.object_tag = static_cast<uint32_t>(HitInfo.Component->CustomDepthStencilValue);
+		const float Distance = Detection.point.Length();
+		Batch.Distance[idxHit] = Distance;
+
+		// Get reflectivity
+		Batch.Beta0[idxHit] = Beta0Table[Detection.object_tag & 0xFFu];
+
+		// noise, only applied to soft returns
+		Batch.NoiseFactor[idxHit] = 1.0f;
+		if (FogParameters.is_foggy)
 		{
-			Soft = 255;
+			// Keyed on the ray, so the stream of each hit does not depend on the
+			// number of threads nor on the other rays.
+			FPhiloxRandom Random = MakeRandomStream(FogRangeNoise, Channel, Rays[idxHit]);
+			const float Noise = 10.0f;
+			const float DistanceNoise = Random.GetUniformFloatInRange(Distance - Noise, Distance + Noise);
+			Batch.NoiseFactor[idxHit] = Distance / DistanceNoise;
 		}
-		Detection.intensity = Hard;
+	}
 
-		if (Soft > Hard)
+	// Hard return, soft return (i_soft from R_tmp, i_tmp) and rescaling of
+	// the soft returns, for the whole channel at once.
+	carla::sensor::FogIntensityKernel::Compute(FogParameters, Batch.MakeView());
+
+	uint32_t WrittenPoints = 0u;
+	for (auto idxHit = 0u; idxHit < Hits.size(); ++idxHit)
+	{
+		FDetection& Detection = Batch.Detections[idxHit];
+		Detection.point *= Batch.Scaling[idxHit];
+		Detection.intensity = Batch.Intensity[idxHit];
+		if (Batch.IsSoft[idxHit])
 		{
-			float ScalingFactor = StepDataDistance / Distance;
-			// noise
-			float Noise = 10.0f;
-			float DistanceNoise = RandomEngine->GetUniformFloatInRange(Distance - Noise, Distance + Noise);
-			float NoiseFactor = Distance / DistanceNoise;
-			float TotalScaling = ScalingFactor * NoiseFactor;
-
-			Detection.point.x *= TotalScaling;
-			Detection.point.y *= TotalScaling;
-			Detection.point.z *= TotalScaling;
-			Detection.intensity = Soft;
 			Detection.object_tag = 29;
 		}
-		// UE_LOG(LogTemp, Warning, TEXT("FogDensity = %f, Mor = %f, Alpha = %f"), FogDensity, Mor, Alpha);
-		// UE_LOG(LogTemp, Warning, TEXT("soft_i = %f, hard_i = %f, object_tag = %d"), Soft, Hard, Detection.object_tag); 
-	}
-	else
-	{	
-		// clear weather
-		Detection.intensity = OriginalIntensity * Beta0 / std::pow(Distance, 2.0) * exp(-2 * Alpha * Distance);
+		Detection.point.y *= -1; // For Carla-Apollo-Bridge
+
+		FPhiloxRandom Random = MakeRandomStream(DetectionNoise, Channel, Rays[idxHit]);
+		if (PostprocessDetection(Detection, Random))
+			LidarData.WritePointAsync(Channel, WrittenPoints++, Detection);
 	}
-	Detection.point.y *= -1; // For Carla-Apollo-Bridge
-	// UE_LOG(LogTemp, Warning, TEXT("object_tag = %d"), Detection.object_tag); 
-	return Detection;
+	PointsPerChannel[Channel] = WrittenPoints;
+}
+
+FPhiloxRandom ARayCastLidarWithFog::MakeRandomStream(ERandomStream Purpose, uint32_t Channel, uint32_t Index) const
+{
+	return FPhiloxRandom(static_cast<uint32_t>(Description.RandomSeed), Purpose, RandomFrame, Channel, Index);
 }
 
 void ARayCastLidarWithFog::PreprocessRays(uint32_t Channels, uint32_t MaxPointsPerChannel)
 {
 	Super::PreprocessRays(Channels, MaxPointsPerChannel);
 
-	for (auto ch = 0u; ch < Channels; ch++)
+	// Every random stream of this tick is keyed on the same frame, counted by
+	// the sensor so that it does not change with the engine frame number.
+	RandomFrame = TickCount++;
+
+	if (!DropOffGenActive)
 	{
+		return;
+	}
+
+	ParallelFor(Channels, [&](int32 ch) {
 		for (auto p = 0u; p < MaxPointsPerChannel; p++)
 		{
-			RayPreprocessCondition[ch][p] = !(DropOffGenActive && RandomEngine->GetUniformFloat() < Description.DropOffGenRate);
+			FPhiloxRandom Random = MakeRandomStream(RayDropOff, ch, p);
+			RayPreprocessCondition[ch][p] = !(Random.GetUniformFloat() < Description.DropOffGenRate);
 		}
-	}
+	});
 }
 
-bool ARayCastLidarWithFog::PostprocessDetection(FDetection& Detection) const
+bool ARayCastLidarWithFog::PostprocessDetection(FDetection& Detection, FPhiloxRandom& Random) const
 {
 	if (Description.NoiseStdDev > std::numeric_limits<float>::epsilon())
 	{
 		const auto ForwardVector = Detection.point.MakeUnitVector();
-		const auto Noise = ForwardVector * RandomEngine->GetNormalDistribution(0.0f, Description.NoiseStdDev);
+		const auto Noise = ForwardVector * Random.GetNormalDistribution(0.0f, Description.NoiseStdDev);
 		Detection.point += Noise;
 	}
 
@@ -212,307 +226,105 @@ bool ARayCastLidarWithFog::PostprocessDetection(FDetection& Detection) const
 	if (Intensity > Description.DropOffIntensityLimit)
 		return true;
 	else
-		return RandomEngine->GetUniformFloat() < DropOffAlpha * Intensity + DropOffBeta;
+		return Random.GetUniformFloat() < DropOffAlpha * Intensity + DropOffBeta;
 }
 
 void ARayCastLidarWithFog::ComputeAndSaveDetections(const FTransform& SensorTransform)
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR(__FUNCTION__);
 	for (auto idxChannel = 0u; idxChannel < Description.Channels; ++idxChannel)
 		PointsPerChannel[idxChannel] = RecordedHits[idxChannel].size();
 
-	LidarData.ResetMemory(PointsPerChannel);
+	LidarData.ResetChannelSlices(PointsPerChannel);
 
-	for (auto idxChannel = 0u; idxChannel < Description.Channels; ++idxChannel)
-	{
-		for (auto& hit : RecordedHits[idxChannel])
-		{
-			FDetection Detection = ComputeDetection(hit, SensorTransform);
-			if (PostprocessDetection(Detection))
-				LidarData.WritePointSync(Detection);
-			else
-				PointsPerChannel[idxChannel]--;
-		}
-	}
+	// Weather and fog coefficients are the same for every hit of this tick.
+	UpdateFogParameters();
+	const FTransform SensorTransformInverse = SensorTransform.Inverse();
 
-	LidarData.WriteChannelCount(PointsPerChannel);
-}
-std::vector<std::string> ARayCastLidarWithFog::SplitString(const std::string& Input, char Delimiter) const
-{
-	std::vector<std::string> Tokens;
-	size_t Start = 0;
-	size_t End = Input.find(Delimiter);
+	ChannelBatches.resize(Description.Channels);
+	ParallelFor(Description.Channels, [&](int32 idxChannel) {
+		TRACE_CPUPROFILER_EVENT_SCOPE(ParallelForTask);
+		ComputeChannelDetections(idxChannel, SensorTransformInverse);
+	});
 
-	while (End != std::string::npos)
-	{
-		Tokens.push_back(Input.substr(Start, End - Start));
-		Start = End + 1;
-		End = Input.find(Delimiter, Start);
-	}
-
-	Tokens.push_back(Input.substr(Start));
-
-	return Tokens;
+	LidarData.CompactChannelSlices(PointsPerChannel);
 }
-void ARayCastLidarWithFog::GetStepSizeData(float FogDensity) const
-{
-	std::string Alpha = GetAlphaInFileName(FogDensity);
-	std::string FilePath = GetPathSeparator();
-	std::string FileName = "integral_0m_to_200m_stepsize_0.1m_tau_h_20ns_alpha_" + Alpha + ".txt";
-	std::string FullPath = FilePath + "/" + FileName;
-	std::ifstream InputFile(FullPath);
-
-	std::string Line;
-	std::vector<std::string> Temp;
-	std::vector<std::string> Data;
 
-	while (getline(InputFile, Line))
-	{
-		Temp = SplitString(Line, ':');
-		Data = SplitString(Temp[1], ',');
-		StepSizeData[Temp[0]] = {Data[0], Data[1]};
-	}
-
-	InputFile.close();
-}
-
-std::string ARayCastLidarWithFog::GetAlphaInFileName(float FogDensity) const
-{
-	if (FogDensity <= 10) {
-		return "0.005";
-	}
-	else if (FogDensity <= 22) {
-		return "0.01";
-	}
-	else if (FogDensity <= 30.5) {
-		return "0.015";
-	}
-	else if (FogDensity <= 36.5) {
-		return "0.02";
-	}
-	else if (FogDensity <= 59) {
-		return "0.03";
-	}
-	else if (FogDensity <= 71) {
-		return "0.06";
-	}
-	else if (FogDensity <= 84) {
-		return "0.1";
-	}
-	else if (FogDensity <= 92.5) {
-		return "0.15";
-	}
-	else if (FogDensity <= 100) {
-		return "0.2";
-	}
-	else {
-		return "0.005";
-	}
-}
-
-
-float ARayCastLidarWithFog::PiecewiseLinearRegression(const std::vector<FogDensityDataPoint>& data, float x) const
-{
-    for (size_t i = 1; i < data.size(); ++i) {
-        if (x >= data[i - 1].x && x < data[i].x) {
-            float slope = (data[i].y - data[i - 1].y) / (data[i].x - data[i - 1].x);
-            float y_intercept = data[i - 1].y - slope * data[i - 1].x;
-            return slope * x + y_intercept;
-        }
-    }
-    return 0.0;
-}
-
-float ARayCastLidarWithFog::CalculateMOR(const float FogDensity) const
-{
-	std::vector<FogDensityDataPoint> FogDensityData = {
-        {2, 600},
-        {10, 300},
-        {15, 200},
-        {25, 150},
-        {40, 100},
-        {50, 50},
-        {80, 30},
-        {90, 25},
-        {95, 20},
-        {100, 15}
-    };
-	float NewMOR = PiecewiseLinearRegression(FogDensityData, FogDensity);
-	if (NewMOR <= 0) {
-		NewMOR = 10000;
-	}
-	return NewMOR;
-}
-
-// TSet<FString> UniqueLabels; // debug
-
-float ARayCastLidarWithFog::GetReflectivity(uint32_t ObjectTag) const
+ARayCastLidarWithFog::FReflectivityTable ARayCastLidarWithFog::MakeDefaultReflectivityTable()
 {
 	// ObjectTag: https://carla.readthedocs.io/en/latest/ref_sensors/#semantic-segmentation-camera
-	if (ObjectTag == 0) {
-		return 0.21f;
-	}
-	else if (ObjectTag == 1 || ObjectTag == 2) {
-		return 0.2f;
-	}
-	else if (ObjectTag == 3) {
-		return 0.32f;
-	}
-	else if (ObjectTag == 4) {
-		return 0.21f;
-	}
-	else if (ObjectTag == 5) {
-		return 0.24f;
-	}
-	else if (ObjectTag == 6) {
-		return 0.08f;
-	}
-	else if (ObjectTag == 8) {
-		return 0.37f;
-	}
-	else if (ObjectTag == 9) {
-		return 0.17f;
-	}
-	else if (ObjectTag == 10) {
-		return 0.19f;
-	}
-	else if (ObjectTag == 11) {
-		return 0.0f;
-	}
-	else if (ObjectTag == 12 || ObjectTag == 13) {
-		return 0.09f;
-	}
-	else if (ObjectTag == 14 || ObjectTag == 15 || ObjectTag == 16 || ObjectTag == 17) {
-		return 0.06f;
-	}
-	else if (ObjectTag == 18) {
-		return 0.08f;
-	}
-	else if (ObjectTag == 19) {
-		return 0.13f;
-	}
-	else if (ObjectTag == 23) {
-		return 0.06f;
-	}
-	else {
-		return 0.21;
-	}
+	FReflectivityTable Table;
+	Table.fill(0.21f);
+	Table[1] = Table[2] = 0.2f;   // roads, sidewalks
+	Table[3] = 0.32f;             // building
+	Table[5] = 0.24f;             // fence
+	Table[6] = 0.08f;             // pole
+	Table[8] = 0.37f;             // traffic sign
+	Table[9] = 0.17f;             // vegetation
+	Table[10] = 0.19f;            // terrain
+	Table[11] = 0.0f;             // sky
+	Table[12] = Table[13] = 0.09f; // pedestrian, rider
+	Table[14] = Table[15] = Table[16] = Table[17] = 0.06f; // car, truck, bus, train
+	Table[18] = 0.08f;            // motorcycle
+	Table[19] = 0.13f;            // bicycle
+	Table[23] = 0.06f;            // water
+	return Table;
 }
 
-float ARayCastLidarWithFog::LookupReflectivityTable(FString ActorLabel) const 
+void ARayCastLidarWithFog::ApplyReflectivityOverrides(const FString& Overrides, FReflectivityTable& Table) const
 {
-	if ( // terrain
-		ActorLabel.Contains(TEXT("grass")) || 
-		ActorLabel.Contains(TEXT("terrain"))
-	)
-	{
-		return 0.19f;
-	}
-
-	else if ( // road, sidewalk
-		ActorLabel.Contains(TEXT("block")) || 
-		ActorLabel.Contains(TEXT("Road_"), ESearchCase::CaseSensitive) || 
-		ActorLabel.Contains(TEXT("line"))
-	)
-	{
-		return 0.2f;
-	}
-
-	else if ( // building
-		ActorLabel.Contains(TEXT("apartment")) || 
-		ActorLabel.Contains(TEXT("house")) || 
-		ActorLabel.Contains(TEXT("office")) || 
-		ActorLabel.Contains(TEXT("staticmesh")) || 
-		ActorLabel.Contains(TEXT("concrete")) || 
-		ActorLabel.Contains(TEXT("skyscraper")) || 
-		ActorLabel.Contains(TEXT("mall")) ||
-		ActorLabel.Contains(TEXT("shop_"))
-	)
+	TArray<FString> Entries;
+	Overrides.ParseIntoArray(Entries, TEXT(","), true);
+	for (FString Entry : Entries)
 	{
-		return 0.32f;
-	}
-
-	else if ( // parking
-		ActorLabel.Contains(TEXT("parking"))
-	)
-	{
-		return 0.1f;
-	}
-
-	else if ( // other-structure
-		ActorLabel.Contains(TEXT("SM_"), ESearchCase::CaseSensitive) || 
-		ActorLabel.Contains(TEXT("wall")) || 
-		ActorLabel.Contains(TEXT("sculpture")) || 
-		ActorLabel.Contains(TEXT("tunelentrance")) || 
-		ActorLabel.Contains(TEXT("_bin")) || 
-		ActorLabel.Contains(TEXT("barrel")) || 
-		ActorLabel.Contains(TEXT("lamppost")) || 
-		ActorLabel.Contains(TEXT("repspline"))
-	)
-	{
-		return 0.21f;
-	}
-
-	else if ( // fence
-		ActorLabel.Contains(TEXT("fence"))
-	)
-	{
-		return 0.24f;
-	}
-	
-	else if ( // pole
-		ActorLabel.Contains(TEXT("light"))
-	)
-	{
-		return 0.08f;
-	}
-
-	else if ( // traffic-sign
-		ActorLabel.Contains(TEXT("speedlimit"))
-	)
-	{
-		return 0.37f;
-	}
-
-	if ( // person
-		ActorLabel.Contains(TEXT("BP_Walker"), ESearchCase::CaseSensitive) || 
-		ActorLabel.Contains(TEXT("bush"))
-	)
-	{
-		return 0.09f;	
+		Entry.TrimStartAndEndInline();
+		if (Entry.IsEmpty() || Entry.StartsWith(TEXT("#")))
+		{
+			continue;
+		}
+		FString Tag;
+		FString Value;
+		if (!Entry.Split(TEXT(":"), &Tag, &Value) || !Tag.IsNumeric() || !Value.IsNumeric())
+		{
+			UE_LOG(LogCarla, Warning, TEXT("%s: invalid reflectivity entry '%s'"), *GetName(), *Entry);
+			continue;
+		}
+		const int32 Index = FCString::Atoi(*Tag);
+		if (Index < 0 || Index >= static_cast<int32>(Table.size()))
+		{
+			UE_LOG(LogCarla, Warning, TEXT("%s: invalid reflectivity tag %d"), *GetName(), Index);
+			continue;
+		}
+		Table[Index] = FCString::Atof(*Value);
 	}
+}
 
-	if ( // car, truck
-		ActorLabel.Contains(TEXT("BP_"), ESearchCase::CaseSensitive) || 
-		ActorLabel.Contains(TEXT("Vh_"), ESearchCase::CaseSensitive)
-	)
-	{
-		return 0.06f;	
-	}
+void ARayCastLidarWithFog::BuildReflectivityTable()
+{
+	FReflectivityTable Reflectivity = MakeDefaultReflectivityTable();
 
-	else if ( // vegetation
-		ActorLabel.Contains(TEXT("leaf")) || 
-		ActorLabel.Contains(TEXT("pine")) || 
-		ActorLabel.Contains(TEXT("foliage")) || 
-		ActorLabel.Contains(TEXT("maple")) || 
-		ActorLabel.Contains(TEXT("palmera")) || 
-		ActorLabel.Contains(TEXT("platanus")) || 
-		ActorLabel.Contains(TEXT("sassafras")) || 
-		ActorLabel.Contains(TEXT("Veg_"), ESearchCase::CaseSensitive) ||
-		ActorLabel.Contains(TEXT("bush")) || 
-		ActorLabel.Contains(TEXT("leave"))
-	)
+	if (!Description.ReflectivityFile.IsEmpty())
 	{
-		return 0.17f;	
+		FString FilePath = Description.ReflectivityFile;
+		if (FPaths::IsRelative(FilePath))
+		{
+			FilePath = FPaths::Combine(FPaths::ProjectContentDir(), FilePath);
+		}
+		FString Content;
+		if (FFileHelper::LoadFileToString(Content, *FilePath))
+		{
+			ApplyReflectivityOverrides(Content.Replace(TEXT("\n"), TEXT(",")).Replace(TEXT("\r"), TEXT("")), Reflectivity);
+		}
+		else
+		{
+			UE_LOG(LogCarla, Warning, TEXT("%s: reflectivity file not found: %s"), *GetName(), *FilePath);
+		}
 	}
+	ApplyReflectivityOverrides(Description.Reflectivity, Reflectivity);
 
-	else
+	// Beta0 = Gamma / pi, with Gamma = reflectivity / 10^5.
+	for (auto i = 0u; i < Reflectivity.size(); ++i)
 	{
-		return 0.21f;
+		Beta0Table[i] = Reflectivity[i] / 1e5f / static_cast<float>(M_PI);
 	}
 }
-
-std::string ARayCastLidarWithFog::GetPathSeparator() const 
-{
-	FString CombinedPath = FPaths::Combine(FPaths::ProjectContentDir(), TEXT("Weather/FogData"));
-	return TCHAR_TO_UTF8(*CombinedPath);
-}
\ No newline at end of file
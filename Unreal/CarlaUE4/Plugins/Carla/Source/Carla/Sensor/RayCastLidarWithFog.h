@@ -12,16 +12,56 @@
 #include "Carla/Sensor/Sensor.h"
 #include "Carla/Sensor/RayCastSemanticLidar.h"
 #include "Carla/Actor/ActorBlueprintFunctionLibrary.h"
+#include "Carla/Sensor/LidarFogModel.h"
+#include "Carla/Util/PhiloxRandom.h"
 
 #include <compiler/disable-ue4-macros.h>
+#include <carla/sensor/FogIntensityKernel.h>
 #include <carla/sensor/data/LidarData.h>
+#include <carla/sensor/data/LidarWithFogData.h>
 #include <compiler/enable-ue4-macros.h>
 
+#include <array>
+#include <memory>
+#include <vector>
+
 #include "RayCastLidarWithFog.generated.h"
 
-struct FogDensityDataPoint {
-	float x;
-	float y;
+/// Structure-of-arrays scratch of the detections of one channel, reused
+/// across ticks to avoid allocations.
+struct FFogChannelBatch
+{
+	std::vector<carla::sensor::data::LidarWithFogDetection> Detections;
+	std::vector<float> Distance;
+	std::vector<float> Beta0;
+	std::vector<float> NoiseFactor;
+	std::vector<float> Intensity;
+	std::vector<float> Scaling;
+	std::vector<uint8_t> IsSoft;
+
+	void Resize(size_t Size)
+	{
+		Detections.resize(Size);
+		Distance.resize(Size);
+		Beta0.resize(Size);
+		NoiseFactor.resize(Size);
+		Intensity.resize(Size);
+		Scaling.resize(Size);
+		IsSoft.resize(Size);
+	}
+
+	carla::sensor::FogIntensityBatch MakeView()
+	{
+		carla::sensor::FogIntensityBatch View;
+		View.size = Detections.size();
+		View.distance = Distance.data();
+		View.beta0 = Beta0.data();
+		View.noise_factor = NoiseFactor.data();
+		View.intensity = Intensity.data();
+		View.scaling = Scaling.data();
+		View.is_soft = IsSoft.data();
+		return View;
+	}
 };
 
 /// A ray-cast based Lidar sensor.
@@ -40,33 +80,52 @@ public:
 	virtual void Set(const FActorDescription& Description) override;
 	virtual void Set(const FLidarDescription& LidarDescription) override;
 
+	virtual void BeginPlay() override;
+
 	virtual void PostPhysTick(UWorld* World, ELevelTick TickType, float DeltaTime);
 
+protected:
+	void EndPlay(EEndPlayReason::Type EndPlayReason) override;
+
 private:
+	/// Purposes of the independent random streams of this sensor.
+	enum ERandomStream : uint32_t
+	{
+		RayDropOff,
+		FogRangeNoise,
+		DetectionNoise
+	};
+
 	/// Compute the received intensity of the point
 	float ComputeIntensity(const FSemanticDetection& RawDetection) const;
-	FDetection ComputeDetection(const FHitResult& HitInfo, const FTransform& SensorTransf);
-
-	void PreprocessRays(uint32_t Channels, uint32_t MaxPointsPerChannel) override;
-	bool PostprocessDetection(FDetection& Detection) const;
 
-	void ComputeAndSaveDetections(const FTransform& SensorTransform) override;
+	/// Compute, post-process and write the detections of @a Channel into its
+	/// slice of LidarData. Safe to call concurrently for different channels.
+	void ComputeChannelDetections(uint32_t Channel, const FTransform& SensorTransfInverse);
 
-	std::vector<std::string> SplitString(const std::string& Input, char Delimiter) const;
+	/// Take the latest state of the fog model and update the fog coefficients,
+	/// called once per tick before the detections are computed.
+	void UpdateFogParameters();
 
-	void GetStepSizeData(float FogDensity) const;
+	/// Random stream for the @a Index-th ray or hit of @a Channel in the current tick.
+	FPhiloxRandom MakeRandomStream(ERandomStream Purpose, uint32_t Channel, uint32_t Index) const;
 
-	std::string GetAlphaInFileName(float FogDensity) const;
+	void PreprocessRays(uint32_t Channels, uint32_t MaxPointsPerChannel) override;
+	bool PostprocessDetection(FDetection& Detection, FPhiloxRandom& Random) const;
 
-	float PiecewiseLinearRegression(const std::vector<FogDensityDataPoint>& data, float x) const;
+	void ComputeAndSaveDetections(const FTransform& SensorTransform) override;
 
-	float CalculateMOR(const float FogDensity) const;
+	/// Reflectivity of every semantic tag (CustomDepthStencilValue).
+	using FReflectivityTable = std::array<float, 256u>;
 
-	float GetReflectivity(const uint32 ObjectTag) const;
+	static FReflectivityTable MakeDefaultReflectivityTable();
 
-	float LookupReflectivityTable(FString ActorLabel) const;
+	/// Parse "tag:value" pairs separated by commas into @a Table.
+	void ApplyReflectivityOverrides(const FString& Overrides, FReflectivityTable& Table) const;
 
-	std::string GetPathSeparator() const;
+	/// Build Beta0Table from the defaults, the reflectivity file and the
+	/// reflectivity attribute, in that order.
+	void BuildReflectivityTable();
 
 	FLidarData LidarData;
 
@@ -81,12 +140,25 @@ private:
 	float DropOffAlpha;
 	float DropOffBeta;
 
-	// mutable std::string CacheAlpha;
-	float CurrentFogDensity;
-	mutable std::map<std::string, std::vector<std::string>> StepSizeData;
+	/// Beta0 (reflectivity / pi) of every semantic tag, indexed by
+	/// CustomDepthStencilValue.
+	FReflectivityTable Beta0Table;
+
+	/// Fog coefficients of the current tick, see UpdateFogParameters.
+	carla::sensor::FogIntensityParameters FogParameters;
+
+	/// Scratch buffers of the detection stage, one per channel.
+	std::vector<FFogChannelBatch> ChannelBatches;
+
+	/// Frame the random streams of the current tick are keyed on.
+	uint64_t RandomFrame = 0u;
+
+	/// Ticks simulated since the sensor was set up, the next RandomFrame.
+	uint64_t TickCount = 0u;
+
+	/// Weather listener, prepares the fog tables off the game thread.
+	std::unique_ptr<FLidarFogModel> FogModel;
 
-	// Fog Simulation Parameter
-	float Mor = 10000;
-	float Alpha = 0.0f;
-	float Beta;
+	/// Fog state of the current tick, keeps the table of FogParameters alive.
+	std::shared_ptr<const FLidarFogState> FogState;
 };
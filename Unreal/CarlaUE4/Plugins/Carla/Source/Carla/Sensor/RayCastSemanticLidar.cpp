@@ -123,7 +123,7 @@ void ARayCastSemanticLidar::SimulateLidar(const float DeltaTime)
         const bool PreprocessResult = RayPreprocessCondition[idxChannel][idxPtsOneLaser];
 
         if (PreprocessResult && ShootLaser(VertAngle, HorizAngle, HitResult, TraceParams)) {
-          WritePointAsync(idxChannel, HitResult);
+          WritePointAsync(idxChannel, idxPtsOneLaser, HitResult);
         }
       };
     });
@@ -145,6 +145,13 @@ void ARayCastSemanticLidar::ResetRecordedHits(uint32_t Channels, uint32_t MaxPoi
     hits.clear();
     hits.reserve(MaxPointsPerChannel);
   }
+
+  RecordedRays.resize(Channels);
+
+  for (auto& rays : RecordedRays) {
+    rays.clear();
+    rays.reserve(MaxPointsPerChannel);
+  }
 }
 
 void ARayCastSemanticLidar::PreprocessRays(uint32_t Channels, uint32_t MaxPointsPerChannel) {
@@ -157,10 +164,11 @@ void ARayCastSemanticLidar::PreprocessRays(uint32_t Channels, uint32_t MaxPoints
   }
 }
 
-void ARayCastSemanticLidar::WritePointAsync(uint32_t channel, FHitResult &detection) {
+void ARayCastSemanticLidar::WritePointAsync(uint32_t channel, uint32_t ray, FHitResult &detection) {
 	TRACE_CPUPROFILER_EVENT_SCOPE_STR(__FUNCTION__);
   DEBUG_ASSERT(GetChannelCount() > channel);
   RecordedHits[channel].emplace_back(detection);
+  RecordedRays[channel].emplace_back(ray);
 }
 
 void ARayCastSemanticLidar::ComputeAndSaveDetections(const FTransform& SensorTransform) {
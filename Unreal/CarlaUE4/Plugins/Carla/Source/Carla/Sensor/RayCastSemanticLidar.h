@@ -57,8 +57,9 @@ protected:
   /// Compute all raw detection information
   void ComputeRawDetection(const FHitResult &HitInfo, const FTransform &SensorTransf, FSemanticDetection &Detection) const;
 
-  /// Saving the hits the raycast returns per channel
-  void WritePointAsync(uint32_t Channel, FHitResult &Detection);
+  /// Saving the hits the raycast returns per channel, with the index of the
+  /// ray that produced them.
+  void WritePointAsync(uint32_t Channel, uint32_t Ray, FHitResult &Detection);
 
   /// Clear the recorded data structure
   void ResetRecordedHits(uint32_t Channels, uint32_t MaxPointsPerChannel);
@@ -73,6 +74,8 @@ protected:
   TArray<float> LaserAngles;
 
   std::vector<std::vector<FHitResult>> RecordedHits;
+  /// Index of the ray of each recorded hit, in the same order.
+  std::vector<std::vector<uint32_t>> RecordedRays;
   std::vector<std::vector<bool>> RayPreprocessCondition;
   std::vector<uint32_t> PointsPerChannel;
 
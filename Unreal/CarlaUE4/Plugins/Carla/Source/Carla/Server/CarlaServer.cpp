@@ -25,6 +25,7 @@
 #include "CarlaServerResponse.h"
 #include "Carla/Util/BoundingBoxCalculator.h"
 #include "Misc/FileHelper.h"
+#include "Runtime/Core/Public/Async/ParallelFor.h"
 
 #include <compiler/disable-ue4-macros.h>
 #include <carla/Functional.h>
@@ -35,6 +36,7 @@
 #include <carla/rpc/ActorDefinition.h>
 #include <carla/rpc/ActorDescription.h>
 #include <carla/rpc/BoneTransformDataIn.h>
+#include <carla/rpc/BufferPoolStats.h>
 #include <carla/rpc/Command.h>
 #include <carla/rpc/CommandResponse.h>
 #include <carla/rpc/DebugShape.h>
@@ -47,6 +49,7 @@
 #include <carla/rpc/MapLayer.h>
 #include <carla/rpc/Response.h>
 #include <carla/rpc/Server.h>
+#include <carla/rpc/StreamStats.h>
 #include <carla/rpc/String.h>
 #include <carla/rpc/Transform.h>
 #include <carla/rpc/Vector2D.h>
@@ -71,6 +74,7 @@
 #include <atomic>
 #include <map>
 #include <tuple>
+#include <unordered_map>
 
 template <typename T>
 using R = carla::rpc::Response<T>;
@@ -259,6 +263,17 @@ void FCarlaServer::FPimpl::BindActions()
     return carla::version();
   };
 
+  BIND_ASYNC(get_buffer_pool_stats) << [this] () -> R<cr::BufferPoolStats>
+  {
+    return cr::BufferPoolStats{StreamingServer.GetBufferPoolStats()};
+  };
+
+  BIND_ASYNC(get_stream_stats) << [this](
+      carla::streaming::detail::stream_id_type StreamId) -> R<cr::StreamStats>
+  {
+    return cr::StreamStats{StreamingServer.GetStreamStats(StreamId)};
+  };
+
   // ~~ Tick ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
   BIND_SYNC(tick_cue) << [this]() -> R<uint64_t>
@@ -2315,15 +2330,73 @@ void FCarlaServer::FPimpl::BindActions()
 
 #undef MAKE_RESULT
 
+  // Actor targeted by a command, 0 for the commands that do not target one.
+  auto command_actor = carla::Functional::MakeOverload(
+      [](const C::SpawnActor &) -> ActorId { return 0u; },
+      [](const C::ConsoleCommand &) -> ActorId { return 0u; },
+      [](const auto &c) -> ActorId { return c.actor; });
+
+  // Commands that only store the new input in their own actor (or in its
+  // dormant data) and can therefore be applied from worker threads. Light
+  // state and autopilot go through blueprint events and the movement
+  // component, so they stay on the game thread.
+  auto is_parallel_command = carla::Functional::MakeOverload(
+      [](const C::ApplyVehicleControl &) { return true; },
+      [](const C::ApplyVehicleAckermannControl &) { return true; },
+      [](const C::ApplyWalkerControl &) { return true; },
+      [](const auto &) { return false; });
+
+  // Below this many parallel commands the tasks cost more than they save.
+  constexpr size_t MinParallelBatchSize = 64u;
+
   BIND_SYNC(apply_batch) << [=](
       const std::vector<cr::Command> &commands,
       bool do_tick_cue)
   {
-    std::vector<CR> result;
-    result.reserve(commands.size());
+    TRACE_CPUPROFILER_EVENT_SCOPE_STR("apply_batch");
+    std::vector<CR> result(commands.size());
+    std::vector<bool> done(commands.size(), false);
+
+    // A command runs in parallel only if no other command of the batch
+    // targets the same actor, so the order of the commands applied to an
+    // actor is preserved. They all run before the serial ones, which may
+    // spawn or destroy actors.
+    std::unordered_map<ActorId, size_t> commands_per_actor;
     for (const auto &command : commands)
     {
-      result.emplace_back(boost::variant2::visit(command_visitor, command.command));
+      ++commands_per_actor[boost::variant2::visit(command_actor, command.command)];
+    }
+    std::vector<size_t> parallel_commands;
+    for (size_t i = 0u; i < commands.size(); ++i)
+    {
+      const auto &command = commands[i].command;
+      const ActorId actor = boost::variant2::visit(command_actor, command);
+      if (actor != 0u &&
+          commands_per_actor[actor] == 1u &&
+          boost::variant2::visit(is_parallel_command, command))
+      {
+        parallel_commands.emplace_back(i);
+      }
+    }
+    if (parallel_commands.size() >= MinParallelBatchSize)
+    {
+      TRACE_CPUPROFILER_EVENT_SCOPE(ParallelFor);
+      ParallelFor(static_cast<int32>(parallel_commands.size()), [&](int32 idx) {
+        const size_t i = parallel_commands[idx];
+        result[i] = boost::variant2::visit(command_visitor, commands[i].command);
+      });
+      for (size_t i : parallel_commands)
+      {
+        done[i] = true;
+      }
+    }
+
+    for (size_t i = 0u; i < commands.size(); ++i)
+    {
+      if (!done[i])
+      {
+        result[i] = boost::variant2::visit(command_visitor, commands[i].command);
+      }
     }
     if (do_tick_cue)
     {
@@ -2409,6 +2482,17 @@ void FCarlaServer::FPimpl::BindActions()
     return URayTracer::CastRay(StartLocation, EndLocation, World);
   };
 
+  BIND_SYNC(cast_rays) << [this]
+      (cr::RayCastBatch Rays) -> R<std::vector<uint8_t>>
+  {
+    REQUIRE_CARLA_EPISODE();
+    if (!Rays.IsValid())
+    {
+      RESPOND_ERROR("cast_rays: all the arrays of the batch must have the same size");
+    }
+    return URayTracer::CastRays(Rays, Episode->GetWorld());
+  };
+
 }
 
 // =============================================================================
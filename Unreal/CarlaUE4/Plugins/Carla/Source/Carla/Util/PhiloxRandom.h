@@ -0,0 +1,114 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+/// Counter-based Philox4x32-10 random generator (Salmon et al., "Parallel
+/// random numbers: as easy as 1, 2, 3", SC'11).
+///
+/// Unlike URandomEngine, the numbers drawn are a pure function of the key and
+/// the counter, there is no state shared between streams. Each stream is
+/// identified by a seed, a purpose, a frame, a channel and an index, so
+/// streams can be consumed from any thread and in any order and the output
+/// is still reproducible.
+class FPhiloxRandom
+{
+public:
+
+  FPhiloxRandom(
+      uint32_t Seed,
+      uint32_t Purpose,
+      uint64_t Frame,
+      uint32_t Channel,
+      uint32_t Index)
+    : Key{Seed, Purpose},
+      Counter{0u, Index, Channel, static_cast<uint32_t>(Frame)}
+  {
+    // Fold the high bits of the frame into the key so frames do not repeat
+    // after 2^32 ticks.
+    Key[1u] ^= static_cast<uint32_t>(Frame >> 32u);
+  }
+
+  // ===========================================================================
+  /// @name Raw output
+  // ===========================================================================
+  /// @{
+
+  /// Next 32 random bits of this stream.
+  uint32_t Next()
+  {
+    if (Position == Output.size())
+    {
+      Output = Generate(Counter, Key);
+      ++Counter[0u];
+      Position = 0u;
+    }
+    return Output[Position++];
+  }
+
+  /// Philox4x32-10 block function.
+  static std::array<uint32_t, 4u> Generate(
+      std::array<uint32_t, 4u> Ctr,
+      std::array<uint32_t, 2u> K)
+  {
+    for (auto Round = 0u; Round < 10u; ++Round)
+    {
+      const uint64_t Product0 = static_cast<uint64_t>(0xD2511F53u) * Ctr[0u];
+      const uint64_t Product1 = static_cast<uint64_t>(0xCD9E8D57u) * Ctr[2u];
+      Ctr = {
+          static_cast<uint32_t>(Product1 >> 32u) ^ Ctr[1u] ^ K[0u],
+          static_cast<uint32_t>(Product1),
+          static_cast<uint32_t>(Product0 >> 32u) ^ Ctr[3u] ^ K[1u],
+          static_cast<uint32_t>(Product0)};
+      K[0u] += 0x9E3779B9u;
+      K[1u] += 0xBB67AE85u;
+    }
+    return Ctr;
+  }
+
+  /// @}
+  // ===========================================================================
+  /// @name Distributions
+  // ===========================================================================
+  /// @{
+
+  /// Uniform float in [0, 1).
+  float GetUniformFloat()
+  {
+    return static_cast<float>(Next() >> 8u) * (1.0f / 16777216.0f);
+  }
+
+  float GetUniformFloatInRange(float Minimum, float Maximum)
+  {
+    return Minimum + (Maximum - Minimum) * GetUniformFloat();
+  }
+
+  /// Normal distribution using the Box-Muller transform.
+  float GetNormalDistribution(float Mean, float StandardDeviation)
+  {
+    // U1 in (0, 1] so the logarithm is always finite.
+    const float U1 = static_cast<float>((Next() >> 8u) + 1u) * (1.0f / 16777216.0f);
+    const float U2 = GetUniformFloat();
+    const float Radius = std::sqrt(-2.0f * std::log(U1));
+    return Mean + StandardDeviation * Radius * std::cos(6.28318530718f * U2);
+  }
+
+  /// @}
+
+private:
+
+  std::array<uint32_t, 2u> Key;
+
+  std::array<uint32_t, 4u> Counter;
+
+  std::array<uint32_t, 4u> Output = {};
+
+  size_t Position = 4u;
+};
@@ -9,6 +9,10 @@
 
 #include "Carla/Game/CarlaStatics.h"
 
+#include "Runtime/Core/Public/Async/ParallelFor.h"
+
+#include <PxScene.h>
+
 
 namespace crp = carla::rpc;
 
@@ -72,3 +76,67 @@ std::pair<bool, crp::LabelledPoint> URayTracer::ProjectPoint(
   }
   return std::make_pair(bDidHit, crp::LabelledPoint(FVector(0.0f,0.0f,0.0f), crp::CityObjectLabel::None));
 }
+
+std::vector<uint8_t> URayTracer::CastRays(
+    const crp::RayCastBatch &Rays, UWorld * World)
+{
+  TRACE_CPUPROFILER_EVENT_SCOPE(URayTracer::CastRays);
+  constexpr float meter_to_centimeter = 100.0f;
+  constexpr uint32 RaysPerTask = 256u;
+  const uint32 RayCount = Rays.IsValid() ? Rays.size() : 0u;
+  const float MaxDistance = meter_to_centimeter * Rays.max_distance;
+  std::vector<uint8_t> Result(RayCount * sizeof(crp::RayCastHit));
+  auto *Hits = reinterpret_cast<crp::RayCastHit *>(Result.data());
+
+  ACarlaGameModeBase* GameMode = UCarlaStatics::GetGameMode(World);
+  ALargeMapManager* LargeMap = GameMode->GetLMManager();
+  const uint32 TaskCount = (RayCount + RaysPerTask - 1u) / RaysPerTask;
+
+  World->GetPhysicsScene()->GetPxScene()->lockRead();
+  {
+    TRACE_CPUPROFILER_EVENT_SCOPE(ParallelFor);
+    ParallelFor(TaskCount, [&](int32 idxTask) {
+      TRACE_CPUPROFILER_EVENT_SCOPE(ParallelForTask);
+      FCollisionQueryParams TraceParams = FCollisionQueryParams(FName(TEXT("Batched_Trace")), true);
+      const uint32 End = FMath::Min(RayCount, (idxTask + 1u) * RaysPerTask);
+      for (uint32 idxRay = idxTask * RaysPerTask; idxRay < End; ++idxRay)
+      {
+        FVector Start = crp::Location(Rays.origin_x[idxRay], Rays.origin_y[idxRay], Rays.origin_z[idxRay]);
+        const FVector Direction = FVector(Rays.direction_x[idxRay], Rays.direction_y[idxRay], Rays.direction_z[idxRay]);
+        if (LargeMap)
+        {
+          Start = LargeMap->GlobalToLocalLocation(Start);
+        }
+        FHitResult Hit;
+        World->ParallelLineTraceSingleByChannel(
+            Hit,
+            Start,
+            Start + Direction.GetSafeNormal() * MaxDistance,
+            ECC_GameTraceChannel2, // camera
+            TraceParams,
+            FCollisionResponseParams::DefaultResponseParam);
+
+        crp::RayCastHit &Output = Hits[idxRay];
+        Output = crp::RayCastHit();
+        if (Hit.bBlockingHit)
+        {
+          FVector UELocation = Hit.Location;
+          if (LargeMap)
+          {
+            UELocation = LargeMap->LocalToGlobalLocation(UELocation);
+          }
+          UPrimitiveComponent* Component = Hit.GetComponent();
+          Output.location = UELocation;
+          Output.distance = Hit.Distance / meter_to_centimeter;
+          Output.label = Component != nullptr
+              ? ATagger::GetTagOfTaggedComponent(*Component)
+              : crp::CityObjectLabel::None;
+          Output.hit = true;
+        }
+      }
+    });
+  }
+  World->GetPhysicsScene()->GetPxScene()->unlockRead();
+
+  return Result;
+}
@@ -11,6 +11,7 @@
 #include <compiler/disable-ue4-macros.h>
 #include "carla/rpc/ObjectLabel.h"
 #include "carla/rpc/LabelledPoint.h"
+#include "carla/rpc/RayCastBatch.h"
 #include <compiler/enable-ue4-macros.h>
 
 #include <vector>
@@ -33,4 +34,9 @@ public:
   static std::pair<bool, carla::rpc::LabelledPoint> ProjectPoint(
       FVector StartLocation, FVector Direction, float MaxDistance, UWorld * World);
 
+  /// Cast every ray of @a Rays in parallel under a single PhysX read lock.
+  /// Returns the closest hit of each ray as packed carla::rpc::RayCastHit.
+  static std::vector<uint8_t> CastRays(
+      const carla::rpc::RayCastBatch &Rays, UWorld * World);
+
 };
@@ -6,6 +6,7 @@
 
 #include "Carla.h"
 #include "Carla/Weather/Weather.h"
+#include "Carla/Game/CarlaStaticDelegates.h"
 #include "Carla/Sensor/SceneCaptureCamera.h"
 #include "Components/SceneCaptureComponent2D.h"
 #include "Kismet/GameplayStatics.h"
@@ -94,6 +95,7 @@ void AWeather::NotifyWeather(ASensor* Sensor)
 void AWeather::SetWeather(const FWeatherParameters& InWeather)
 {
     Weather = InWeather;
+    FCarlaStaticDelegates::OnWeatherChange.Broadcast(Weather);
 }
 
 void AWeather::SetDayNightCycle(const bool& active)